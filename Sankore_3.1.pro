@@ -104,6 +104,9 @@ CONFIG(release, debug|release) {
    CONFIG += warn_off
 }
 
+# qmake CONFIG+=scene_benchmark builds the headless scene benchmark instead of the application
+scene_benchmark:include(src/benchmark/benchmark.pri)
+
 DESTDIR = $$BUILD_DIR/product
 OBJECTS_DIR = $$BUILD_DIR/objects
 MOC_DIR = $$BUILD_DIR/moc
@@ -16,6 +16,8 @@ THIRD_PARTY_WARNINGS_DISABLE
 #include "quazipfileinfo.h"
 THIRD_PARTY_WARNINGS_ENABLE
 
+static const int sCompressChunkSize = 64 * 1024;
+
 UBCFFAdaptor::UBCFFAdaptor()
 {}
 
@@ -36,6 +38,7 @@ bool UBCFFAdaptor::convertUBZToIWB(const QString &from, const QString &to)
         return false;
     }
 
+    //only holds the images generated during the conversion, the content and the media go straight to the archive
     QString tmpDestination = createNewTmpDir();
     if (tmpDestination.isNull()) {
         qDebug() << "can't create temp destination folder. Stopping parsing...";
@@ -48,15 +51,61 @@ bool UBCFFAdaptor::convertUBZToIWB(const QString &from, const QString &to)
         return false;
     }
 
-    bool bParceRes = tmpConvertrer.parse();
+    QDir toDir = QFileInfo(to).dir();
+    if (!toDir.exists())
+        if (!QDir().mkpath(toDir.absolutePath())) {
+            qDebug() << "can't create destination folder to compress file";
+            return false;
+        }
+
+    QuaZip zip(to);
+    zip.setFileNameCodec("UTF-8");
+    if(!zip.open(QuaZip::mdCreate)) {
+        qDebug("Export failed. Cause: zip.open(): %d", zip.getZipError());
+        return false;
+    }
+
+    QuaZipFile outZip(&zip);
+
+    if(!outZip.open(QIODevice::WriteOnly, QuaZipNewInfo(fIWBContent))) {
+        qDebug() << "Export failed. Cause: outFile.open(): " << outZip.getZipError();
+        zip.close();
+        QFile::remove(to);
+        return false;
+    }
+
+    //pages are converted one at a time straight into the content entry
+    bool bParceRes = tmpConvertrer.parse(&outZip);
+
+    outZip.close();
 
     mConversionMessages << tmpConvertrer.getMessages();
 
+    if (bParceRes && outZip.getZipError() != UNZ_OK) {
+        qDebug() << "Export failed. Cause: outFile.close(): " << outZip.getZipError();
+        bParceRes = false;
+    }
+
     if (!bParceRes) {
+        zip.close();
+        QFile::remove(to);
         return false;
     }
 
-    if (!compressZip(tmpDestination, to))
+    bool bCompressRes = true;
+
+    QListIterator<QPair<QString, QString> > nextMediaFile(tmpConvertrer.getMediaFiles());
+    while (bCompressRes && nextMediaFile.hasNext()) {
+        QPair<QString, QString> mediaFile = nextMediaFile.next();
+        bCompressRes = compressFile(mediaFile.first, mediaFile.second, &outZip);
+    }
+
+    if (bCompressRes)
+        bCompressRes = compressDir(QFileInfo(tmpDestination).absoluteFilePath(), "", &outZip);
+
+    zip.close();
+
+    if (!bCompressRes || zip.getZipError() != UNZ_OK)
         qDebug() << "error in compression";
 
     //Cleanning tmp souces in filesystem
@@ -158,36 +207,6 @@ QString UBCFFAdaptor::uncompressZip(const QString &zipFile)
     return documentRootFolder;
 }
 
-bool UBCFFAdaptor::compressZip(const QString &source, const QString &destination)
-{
-    QDir toDir = QFileInfo(destination).dir();
-    if (!toDir.exists())
-        if (!QDir().mkpath(toDir.absolutePath())) {
-            qDebug() << "can't create destination folder to uncompress file";
-            return false;
-        }
-
-    QuaZip zip(destination);
-    zip.setFileNameCodec("UTF-8");
-    if(!zip.open(QuaZip::mdCreate)) {
-        qDebug("Export failed. Cause: zip.open(): %d", zip.getZipError());
-        return false;
-    }
-
-    QuaZipFile outZip(&zip);
-
-    QFileInfo sourceInfo(source);
-    if (sourceInfo.isDir()) {
-        if (!compressDir(QFileInfo(source).absoluteFilePath(), "", &outZip))
-            return false;
-    } else if (sourceInfo.isFile()) {
-        if (!compressFile(QFileInfo(source).absoluteFilePath(), "", &outZip))
-            return false;
-    }
-
-    return true;
-}
-
 bool UBCFFAdaptor::compressDir(const QString &dirName, const QString &parentDir, QuaZipFile *outZip)
 {
     QFileInfoList dirFiles = QDir(dirName).entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot);
@@ -201,7 +220,7 @@ bool UBCFFAdaptor::compressDir(const QString &dirName, const QString &parentDir,
                 return false;
             }
         } else if (curFile.isFile()) {
-            if (!compressFile(curFile.absoluteFilePath(), parentDir, outZip)) {
+            if (!compressFile(curFile.absoluteFilePath(), parentDir + curFile.fileName(), outZip)) {
                return false;
             }
         }
@@ -210,7 +229,7 @@ bool UBCFFAdaptor::compressDir(const QString &dirName, const QString &parentDir,
     return true;
 }
 
-bool UBCFFAdaptor::compressFile(const QString &fileName, const QString &parentDir, QuaZipFile *outZip)
+bool UBCFFAdaptor::compressFile(const QString &fileName, const QString &archiveName, QuaZipFile *outZip)
 {
     QFile sourceFile(fileName);
 
@@ -219,14 +238,21 @@ bool UBCFFAdaptor::compressFile(const QString &fileName, const QString &parentDi
         return false;
     }
 
-    if(!outZip->open(QIODevice::WriteOnly, QuaZipNewInfo(parentDir + QFileInfo(fileName).fileName(), sourceFile.fileName()))) {
+    if(!outZip->open(QIODevice::WriteOnly, QuaZipNewInfo(archiveName, sourceFile.fileName()))) {
         qDebug() << "Compression of file" << sourceFile.fileName() << " failed. Cause: outFile.open(): " << outZip->getZipError();
         sourceFile.close();
         return false;
     }
 
-    outZip->write(sourceFile.readAll());
-    if(outZip->getZipError() != UNZ_OK) {
+    //copied in chunks, media files can be large
+    QByteArray buffer(sCompressChunkSize, 0);
+    bool writeOk = true;
+    while (writeOk && !sourceFile.atEnd()) {
+        qint64 readSize = sourceFile.read(buffer.data(), buffer.size());
+        writeOk = readSize >= 0 && outZip->write(buffer.constData(), readSize) == readSize;
+    }
+
+    if(!writeOk || outZip->getZipError() != UNZ_OK) {
         qDebug() << "Compression of file" << sourceFile.fileName() << " failed. Cause: outFile.write(): " << outZip->getZipError();
 
         sourceFile.close();
@@ -355,7 +381,7 @@ UBCFFAdaptor::UBToCFFConverter::UBToCFFConverter(const QString &source, const QS
     iwbSVGItemsAttributes.insert(tIWBTspan, iwbSVGTspanAttributes);
 }
 
-bool UBCFFAdaptor::UBToCFFConverter::parse()
+bool UBCFFAdaptor::UBToCFFConverter::parse(QIODevice *contentDevice)
 {
     if(!isValid()) {
         qDebug() << "document metadata is not valid. Can't parse";
@@ -364,14 +390,13 @@ bool UBCFFAdaptor::UBToCFFConverter::parse()
 
     qDebug() << "begin parsing ubz";
 
-    QFile outFile(contentIWBFileName());
-    if (!outFile.open(QIODevice::WriteOnly| QIODevice::Text)) {
+    if (!contentDevice || !contentDevice->isWritable()) {
         qDebug() << "can't open output file for writing";
         errorStr = "createXMLOutputPatternError";
         return false;
     }
 
-    mIWBContentWriter->setDevice(&outFile);
+    mIWBContentWriter->setDevice(contentDevice);
 
     mIWBContentWriter->writeStartDocument();
     mIWBContentWriter->writeStartElement(tIWBRoot);
@@ -384,22 +409,18 @@ bool UBCFFAdaptor::UBToCFFConverter::parse()
         if (errorStr == noErrorMsg)
             errorStr = "MetadataParsingError";
 
-        outFile.close();
         return false;
     }
 
     if (!parseContent()) {
         if (errorStr == noErrorMsg)
             errorStr = "ContentParsingError";
-        outFile.close();
         return false;
     }
 
     mIWBContentWriter->writeEndElement();
     mIWBContentWriter->writeEndDocument();
 
-    outFile.close();
-
     qDebug() << "finished with success";
 
     return true;
@@ -481,33 +502,32 @@ bool UBCFFAdaptor::UBToCFFConverter::parseContent() {
     fileFilters << QString(pageAlias + "???." + pageFileExtentionUBZ);
     QStringList pageList = sourceDir.entryList(fileFilters, QDir::Files, QDir::Name | QDir::IgnoreCase);
 
-    QDomElement svgDocumentSection = mDataModel->createElementNS(svgIWBNS, ":"+tSvg);
-
     if (!pageList.count()) {
         qDebug() << "can't find any content file";
         errorStr = "ErrorContentFile";
         return false;
-    } else 
-    {
-        QDomElement pageset = parsePageset(pageList);
-        if (pageset.isNull())
-            return false;
-        else
-            svgDocumentSection.appendChild(pageset);
     }
 
-    
-    if (QRect() == mViewbox)
+    // the svg section attributes come before the pages in the stream,
+    // so the main viewbox is taken from the page headers first
+    QRect documentViewbox;
+    foreach (QString pageFileName, pageList)
+        documentViewbox |= readPageViewbox(pageFileName);
+
+    if (QRect() == documentViewbox)
     {
-        mViewbox.setRect(0,0, mSVGSize.width(), mSVGSize.height());
+        documentViewbox.setRect(0,0, mSVGSize.width(), mSVGSize.height());
     }
 
-    svgDocumentSection.setAttribute(aIWBViewBox, rectToIWBAttr(mViewbox));
-    svgDocumentSection.setAttribute(aWidth, QString("%1").arg(mViewbox.width()));
-    svgDocumentSection.setAttribute(aHeight, QString("%1").arg(mViewbox.height()));
+    mIWBContentWriter->writeStartElement(svgIWBNS, tSvg);
+    mIWBContentWriter->writeAttribute(aIWBViewBox, rectToIWBAttr(documentViewbox));
+    mIWBContentWriter->writeAttribute(aWidth, QString("%1").arg(documentViewbox.width()));
+    mIWBContentWriter->writeAttribute(aHeight, QString("%1").arg(documentViewbox.height()));
 
+    if (!parsePageset(pageList))
+        return false;
 
-    writeQDomElementToXML(svgDocumentSection);
+    mIWBContentWriter->writeEndElement();
 
 
     if (!writeExtendedIwbSection()) {
@@ -519,93 +539,148 @@ bool UBCFFAdaptor::UBToCFFConverter::parseContent() {
     return true;
 }
 
-QDomElement UBCFFAdaptor::UBToCFFConverter::parsePage(const QString &pageFileName)
+QRect UBCFFAdaptor::UBToCFFConverter::readPageViewbox(const QString &pageFileName)
+{
+    QFile pageFile(sourcePath + "/" + pageFileName);
+    if (!pageFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QRect();
+
+    // only the root element is read
+    QXmlStreamReader pageReader(&pageFile);
+    if (!pageReader.readNextStartElement() || pageReader.name() != tSvg)
+        return QRect();
+
+    QXmlStreamAttributes attributes = pageReader.attributes();
+    if (!attributes.hasAttribute(aUBZViewBox))
+        return QRect();
+
+    return getViewboxRect(attributes.value(aUBZViewBox).toString());
+}
+
+QDomElement UBCFFAdaptor::UBToCFFConverter::readDomElement(QXmlStreamReader &reader, QDomDocument &document, bool withChildren)
+{
+    // same nodes QDomDocument::setContent() would build with namespace processing
+    QDomElement element = document.createElementNS(reader.namespaceUri().toString(), reader.qualifiedName().toString());
+
+    foreach (QXmlStreamAttribute attribute, reader.attributes())
+        element.setAttributeNS(attribute.namespaceUri().toString(), attribute.qualifiedName().toString(), attribute.value().toString());
+
+    if (!withChildren)
+        return element;
+
+    while (!reader.atEnd()) {
+        reader.readNext();
+
+        if (reader.isEndElement())
+            break;
+        else if (reader.isStartElement())
+            element.appendChild(readDomElement(reader, document));
+        else if (reader.isCDATA())
+            element.appendChild(document.createCDATASection(reader.text().toString()));
+        else if (reader.isCharacters() && !reader.isWhitespace()) {
+            // the reader may split a text run, the DOM keeps it as a single node
+            QDomNode lastChild = element.lastChild();
+            if (lastChild.isText() && !lastChild.isCDATASection())
+                lastChild.toText().appendData(reader.text().toString());
+            else
+                element.appendChild(document.createTextNode(reader.text().toString()));
+        }
+    }
+
+    return element;
+}
+
+// pageNo is the number of the next page written, it only moves on when this page is written
+bool UBCFFAdaptor::UBToCFFConverter::parsePage(const QString &pageFileName, int &pageNo)
 {
     qDebug() << "begin parsing page" + pageFileName;
     mSvgElements.clear(); //clean Svg elements map before parsing new page
 
-    int errorLine, errorColumn;
-
     QFile pageFile(sourcePath + "/" + pageFileName);
     if (!pageFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qDebug() << "can't open file" << pageFileName << "for reading";
-        return QDomElement();
-    } else if (!mDataModel->setContent(pageFile.readAll(), true, &errorStr, &errorLine, &errorColumn)) {
-        qWarning() << "Error:Parseerroratline" << errorLine << ","
-                   << "column" << errorColumn << ":" << errorStr;
-        pageFile.close();
-        return QDomElement();
-    }
-
-    QDomElement page;
-    QDomElement group;
-
-    QDomElement nextTopElement = mDataModel->firstChildElement();
-    while (!nextTopElement.isNull()) {
-        QString tagname = nextTopElement.tagName();
-        if (tagname == tSvg) {
-            page = parseSvgPageSection(nextTopElement);
-            if (page.isNull()) {
-                qDebug() << "The page is empty.";
-                pageFile.close();
-                return QDomElement();
-            }
-        } else if (tagname == tUBZGroup) {
-            group = parseGroupPageSection(nextTopElement);
-            if (group.isNull()) {
-                qDebug() << "Page doesn't contains any groups.";
-                pageFile.close();
-                return QDomElement();
-            }
-        }
+        return false;
+    }
+
+    // the page is read one top level element at a time, only the element being converted is held as DOM
+    QXmlStreamReader pageReader(&pageFile);
+    QDomDocument pageModel;
 
-        nextTopElement = nextTopElement.nextSiblingElement();
+    if (!pageReader.readNextStartElement()) {
+        qDebug() << "The page is empty.";
+        return false;
     }
 
-    pageFile.close(); 
+    if (pageReader.name() == tUBZGroup) {
+        // group sections have no IWB conversion yet, the page is left out rather than failing the export
+        qWarning() << "page" << pageFileName << "is a group section, which can not be exported to IWB yet, skipping it";
+        addLastExportError(QObject::tr("Page file = ") + QString("%1 \r\n").arg(pageFileName)
+                         + QObject::tr("Group sections are not supported in destination format, the page was skipped."));
+        return true;
+    } else if (pageReader.name() != tSvg) {
+        return false;
+    }
 
-    return page.hasChildNodes() ? page : QDomElement();
-}
+    QMultiMap<int, QDomElement> svgElements;
 
-QDomElement UBCFFAdaptor::UBToCFFConverter::parsePageset(const QStringList &pageFileNames)
-{   
-    QMultiMap<int, QDomElement> pageList;
-    int iPageNo = 1;
+    parseSvgPageSection(readDomElement(pageReader, pageModel, false), svgElements);
 
-    QStringListIterator curPage(pageFileNames);
+    while (pageReader.readNextStartElement())
+        parseSvgPageElement(readDomElement(pageReader, pageModel), svgElements);
 
-    while (curPage.hasNext()) {
+    if (pageReader.hasError()) {
+        errorStr = pageReader.errorString();
+        qWarning() << "Error:Parseerroratline" << pageReader.lineNumber() << ","
+                   << "column" << pageReader.columnNumber() << ":" << errorStr;
+        return false;
+    }
 
-        QString curPageFile = curPage.next();
-        QDomElement iterElement = parsePage(curPageFile);
-        if (!iterElement.isNull())           
-        {
-            iterElement.setAttribute(tId, iPageNo);
-            addSVGElementToResultModel(iterElement, pageList, iPageNo);
-            iPageNo++; 
-        }
-        else
-            return QDomElement();
+    if (0 == svgElements.count()) {
+        qDebug() << "The page is empty.";
+        return false;
     }
 
+    mIWBContentWriter->writeStartElement(svgIWBNS, tIWBPage);
+    mIWBContentWriter->writeAttribute(tId, QString::number(pageNo));
 
-    if (!pageList.count())
-        return QDomElement(); 
+    // to do:
+    // there we must to sort elements (take elements from list and assign parent ordered like in parseSVGGGroup)
+    // we returns just element because we don't care about layer.
+    QMapIterator<int, QDomElement> nextSVGElement(svgElements);
+    while (nextSVGElement.hasNext()) {
+        QDomElement element = nextSVGElement.next().value();
+        writeQDomElementToXML(element);
 
+        // written, the result model doesn't need to keep it anymore
+        mDocumentToWrite->firstChildElement().removeChild(element);
+    }
 
-    QDomElement svgPagesetElement = mDocumentToWrite->createElementNS(svgIWBNS,":"+ tIWBPageSet);
+    mIWBContentWriter->writeEndElement();
 
-    QMapIterator<int, QDomElement> nextSVGElement(pageList);
-    nextSVGElement.toFront();
-    while (nextSVGElement.hasNext()) 
-        svgPagesetElement.appendChild(nextSVGElement.next().value());
+    pageNo++;
 
-    return svgPagesetElement.hasChildNodes() ? svgPagesetElement : QDomElement();
+    return true;
 }
-QDomElement UBCFFAdaptor::UBToCFFConverter::parseSvgPageSection(const QDomElement &element)
+
+bool UBCFFAdaptor::UBToCFFConverter::parsePageset(const QStringList &pageFileNames)
 {
-    //we don't know about page number, so return QDomElement.
+    mIWBContentWriter->writeStartElement(svgIWBNS, tIWBPageSet);
+
+    int iPageNo = 1;
+
+    QStringListIterator curPage(pageFileNames);
+    while (curPage.hasNext()) {
+        if (!parsePage(curPage.next(), iPageNo))
+            return false;
+    }
+
+    mIWBContentWriter->writeEndElement();
 
+    return true;
+}
+
+void UBCFFAdaptor::UBToCFFConverter::parseSvgPageSection(const QDomElement &element, QMultiMap<int, QDomElement> &svgElements)
+{
     //Parsing top level tag attributes
 
     //getting current page viewbox to be able to convert coordinates to global viewbox parameter
@@ -613,43 +688,23 @@ QDomElement UBCFFAdaptor::UBToCFFConverter::parseSvgPageSection(const QDomElemen
         setViewBox(getViewboxRect(element.attribute(aUBZViewBox)));
     }
 
-    QMultiMap<int, QDomElement> svgElements;
-
-    QDomElement svgElementPart = mDocumentToWrite->createElementNS(svgIWBNS,":"+ tIWBPage);
-
     if (element.hasAttribute(aDarkBackground)) {
-         createBackground(element, svgElements);       
-    }
-   
-    //Parsing svg children attributes
-    // Elements can know about its layer, so it must add result QDomElements to ordrered list.
-    QDomElement nextElement = element.firstChildElement();
-    while (!nextElement.isNull()) {
-        QString tagName = nextElement.tagName();
-        if      (tagName == tUBZG)             parseSVGGGroup(nextElement, svgElements);
-        else if (tagName == tUBZImage)         parseUBZImage(nextElement, svgElements);
-        else if (tagName == tUBZVideo)         parseUBZVideo(nextElement, svgElements);
-        else if (tagName == tUBZAudio)         parseUBZAudio(nextElement, svgElements);
-        else if (tagName == tUBZForeignObject) parseForeignObject(nextElement, svgElements);
-        else if (tagName == tUBZLine)          parseUBZLine(nextElement, svgElements);
-        else if (tagName == tUBZPolygon)       parseUBZPolygon(nextElement, svgElements);
-        else if (tagName == tUBZPolyline)      parseUBZPolyline(nextElement, svgElements);
-
-        nextElement = nextElement.nextSiblingElement();
+         createBackground(element, svgElements);
     }
+}
 
-    if (0 == svgElements.count())
-        return QDomElement();
-
-    // to do:
-    // there we must to sort elements (take elements from list and assign parent ordered like in parseSVGGGroup)
-    // we returns just element because we don't care about layer.
-    QMapIterator<int, QDomElement> nextSVGElement(svgElements);
-    nextSVGElement.toFront();
-    while (nextSVGElement.hasNext()) 
-        svgElementPart.appendChild(nextSVGElement.next().value());
- 
-    return svgElementPart.hasChildNodes() ? svgElementPart : QDomElement();
+void UBCFFAdaptor::UBToCFFConverter::parseSvgPageElement(const QDomElement &element, QMultiMap<int, QDomElement> &svgElements)
+{
+    // Elements can know about its layer, so it must add result QDomElements to ordrered list.
+    QString tagName = element.tagName();
+    if      (tagName == tUBZG)             parseSVGGGroup(element, svgElements);
+    else if (tagName == tUBZImage)         parseUBZImage(element, svgElements);
+    else if (tagName == tUBZVideo)         parseUBZVideo(element, svgElements);
+    else if (tagName == tUBZAudio)         parseUBZAudio(element, svgElements);
+    else if (tagName == tUBZForeignObject) parseForeignObject(element, svgElements);
+    else if (tagName == tUBZLine)          parseUBZLine(element, svgElements);
+    else if (tagName == tUBZPolygon)       parseUBZPolygon(element, svgElements);
+    else if (tagName == tUBZPolyline)      parseUBZPolyline(element, svgElements);
 }
 
 void UBCFFAdaptor::UBToCFFConverter::writeQDomElementToXML(const QDomNode &node)
@@ -1068,23 +1123,26 @@ bool UBCFFAdaptor::UBToCFFConverter::setContentFromUBZ(const QDomElement &ubzEle
     {
         sSrcFileName = sourcePath + "/" + sSrcContentFolder + "/" + getFileNameFromPath(srcPath); // some elements must be exported as images, so we take hes existing thumbnails.
 
-        QFile srcFile;
-        srcFile.setFileName(sSrcFileName);
+        // copied into the archive once the content is written
+        bRet &= QFile::exists(sSrcFileName);
 
-        QDir dstDocFolder(destinationPath);
-
-        if (!dstDocFolder.exists(sDstContentFolder))
-            bRet &= dstDocFolder.mkdir(sDstContentFolder);
+        QString sArchiveName = sDstContentFolder+"/"+sDstFileName;
 
         if (bRet)
         {
-            QString dstFilePath = destinationPath+"/"+sDstContentFolder+"/"+sDstFileName;
-            bRet &= srcFile.copy(dstFilePath);
+            // a media referenced again points to the copy already listed
+            if (mMediaArchiveNames.contains(sSrcFileName))
+                sArchiveName = mMediaArchiveNames.value(sSrcFileName);
+            else
+            {
+                mMediaArchiveNames.insert(sSrcFileName, sArchiveName);
+                mMediaFiles << qMakePair(sSrcFileName, sArchiveName);
+            }
         }
 
         if (bRet)
         {
-            svgElement.setAttribute(aSVGHref, sDstContentFolder+"/"+sDstFileName);
+            svgElement.setAttribute(aSVGHref, sArchiveName);
             svgElement.setAttribute(aSVGRequiredExtension, svgRequiredExtensionPrefix+convertExtention(fileExtention));
         }
     }
@@ -1923,11 +1981,6 @@ QString UBCFFAdaptor::UBToCFFConverter::digitFileFormat(int digit) const
 {
     return QString("%1").arg(digit, 3, 10, QLatin1Char('0'));
 }
-QString UBCFFAdaptor::UBToCFFConverter::contentIWBFileName() const
-{
-    return destinationPath + "/" + fIWBContent;
-}
-
 //setting SVG dimenitons
 QSize UBCFFAdaptor::UBToCFFConverter::getSVGDimentions(const QString &element)
 {
@@ -9,6 +9,7 @@ class QTransform;
 class QDomDocument;
 class QDomElement;
 class QDomNode;
+class QXmlStreamReader;
 class QuaZipFile;
 
 class UBCFFADAPTORSHARED_EXPORT UBCFFAdaptor {
@@ -24,9 +25,8 @@ public:
 
 private:
     QString uncompressZip(const QString &zipFile);
-    bool compressZip(const QString &source, const QString &destination);
     bool compressDir(const QString &dirName, const QString &parentDir, QuaZipFile *outZip);
-    bool compressFile(const QString &fileName, const QString &parentDir, QuaZipFile *outZip);
+    bool compressFile(const QString &fileName, const QString &archiveName, QuaZipFile *outZip);
 
     QString createNewTmpDir();
     bool freeDir(const QString &dir);
@@ -47,8 +47,10 @@ private:
         ~UBToCFFConverter();
         bool isValid() const;
         QString lastErrStr() const {return errorStr;}
-        bool parse();
+        bool parse(QIODevice *contentDevice);
         QList<QString> getMessages() {return mExportErrorList;}
+        // source file and archive name of the media the content refers to
+        QList<QPair<QString, QString> > getMediaFiles() const {return mMediaFiles;}
 
     private:
 
@@ -58,9 +60,12 @@ private:
 
         bool parseMetadata();
         bool parseContent();
-        QDomElement parsePageset(const QStringList &pageFileNames);
-        QDomElement parsePage(const QString &pageFileName);
-        QDomElement parseSvgPageSection(const QDomElement &element);
+        bool parsePageset(const QStringList &pageFileNames);
+        bool parsePage(const QString &pageFileName, int &pageNo);
+        void parseSvgPageSection(const QDomElement &element, QMultiMap<int, QDomElement> &svgElements);
+        void parseSvgPageElement(const QDomElement &element, QMultiMap<int, QDomElement> &svgElements);
+        QRect readPageViewbox(const QString &pageFileName);
+        QDomElement readDomElement(QXmlStreamReader &reader, QDomDocument &document, bool withChildren = true);
         void writeQDomElementToXML(const QDomNode &node);
         bool writeExtendedIwbSection();
         QDomElement parseGroupPageSection(const QDomElement &element);
@@ -122,7 +127,6 @@ private:
         inline QString rectToIWBAttr(const QRect &rect) const;
         inline QString digitFileFormat(int num) const;
         inline bool strToBool(const QString &in) const {return in == "true";}
-        QString contentIWBFileName() const;
 
     private:
         QList<QString> mExportErrorList;
@@ -136,6 +140,8 @@ private:
         QDomDocument *mDocumentToWrite; //document for saved QDomElements from mSvgElements and mExtendedElements
         QMultiMap<int, QDomElement> mSvgElements; //Saving svg elements to have a sorted by z order list of elements to write;
         QList<QDomElement> mExtendedElements; //Saving extended options of elements to be able to add them to the end of result iwb document;
+        QList<QPair<QString, QString> > mMediaFiles; //Media to copy into the archive, source path and archive name
+        QHash<QString, QString> mMediaArchiveNames; //Archive name of every source media already listed, a media used twice is stored once
         mutable QString errorStr; // last error string message
 
     public:
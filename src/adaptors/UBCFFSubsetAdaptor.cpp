@@ -16,6 +16,7 @@
 #include <QSvgGenerator>
 #include <QSvgRenderer>
 #include <QPixmap>
+#include <QtConcurrentRun>
 
 #include "core/UBPersistenceManager.h"
 
@@ -24,6 +25,7 @@
 #include "domain/UBItem.h"
 #include "domain/UBGraphicsPolygonItem.h"
 #include "domain/UBGraphicsStroke.h"
+#include "domain/UBGraphicsStrokesGroup.h"
 #include "domain/UBGraphicsTextItem.h"
 #include "domain/UBGraphicsSvgItem.h"
 #include "domain/UBGraphicsPixmapItem.h"
@@ -149,18 +151,22 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parse()
     UBMetadataDcSubsetAdaptor::persist(mProxy);
 
     mIndent = "";
-    if (!getTempFileName() || !createTempFlashPath())
+    if (!createTempFlashPath())
         return false;
 
     if (mDOMdoc.isNull())
         return false;
 
+    QElapsedTimer importTimer;
+    importTimer.start();
+
     bool result = parseDoc();
     if (result)
         result = mProxy->pageCount() != 0;
 
-    if (QFile::exists(mTempFilePath))
-        QFile::remove(mTempFilePath);
+    if (result)
+        qDebug() << "imported" << mProxy->pageCount() << "pages in" << importTimer.elapsed() << "ms,"
+                 << importTimer.elapsed() / mProxy->pageCount() << "ms per page";
 
 //    if (mTmpFlashDir.exists())
 //        UBFileSystemUtils::deleteDir(mTmpFlashDir.path());
@@ -222,52 +228,27 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgRect(const QDomElement &elem
 
     x1 -= strokeWidth/2;
     y1 -= strokeWidth/2;
-    width += strokeWidth;
-    height += strokeWidth;
-
-    //init svg generator with temp file
-    QSvgGenerator *generator = createSvgGenerator(width, height);
-
-    //init painter to paint to svg
-    QPainter painter;
-
-    painter.begin(generator);
-
-    //fill rect
-    if (fillColor.isValid()) {
-        painter.setBrush(QBrush(fillColor));
-        painter.fillRect(0, 0, width, height, fillColor);
-    }
-    QPen pen;
-    if (strokeColor.isValid()) {
-        pen.setColor(strokeColor);
-    }
-    if (strokeWidth)
-        pen.setWidth(strokeWidth);
-    painter.setPen(pen);
-    painter.drawRect(0, 0, width, height);
 
-    painter.end();
+    //the stroke is centered on the outline, the item origin is its outer corner
+    QPainterPath outline;
+    outline.addRect(strokeWidth/2, strokeWidth/2, width, height);
 
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
+    UBGraphicsStrokesGroup *shapeItem = createShapeItem(outline, fillColor, strokeColor, strokeWidth);
     QTransform transform;
     QString textTransform = element.attribute(aTransform);
 
-    svgItem->resetTransform();
     if (!textTransform.isNull()) {
-        transform = transformFromString(textTransform, svgItem);
+        transform = transformFromString(textTransform, shapeItem);
     }
 
-    repositionSvgItem(svgItem, width, height, x1, y1, transform);
-    hashSceneItem(element, svgItem);
+    positionItem(shapeItem, 1, 1, x1, y1, transform);
+    hashSceneItem(element, shapeItem);
 
     if (mGSectionContainer)
     {
-        addItemToGSection(svgItem);
+        addItemToGSection(shapeItem);
     }
 
-    delete generator;
-
     return true;
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgEllipse(const QDomElement &element)
@@ -275,7 +256,6 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgEllipse(const QDomElement &e
     //ellipse horisontal and vertical radius
     qreal rx = element.attribute(aRx).toDouble();
     qreal ry = element.attribute(aRy).toDouble();
-    QSvgGenerator *generator = createSvgGenerator(rx * 2, ry * 2);
 
     //fill and stroke color
     QColor fillColor = colorFromString(element.attribute(aFill));
@@ -286,39 +266,25 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgEllipse(const QDomElement &e
     qreal cx = element.attribute(aCx).toDouble();
     qreal cy = element.attribute(aCy).toDouble();
 
-    //init painter to paint to svg
-    QPainter painter;
-    painter.begin(generator);
-
-    QPen pen(strokeColor);
-    pen.setWidth(strokeWidth);
-    painter.setPen(pen);
-    painter.setBrush(QBrush(fillColor));
-
-    painter.drawEllipse(0, 0, rx * 2, ry * 2);
-
-    painter.end();
+    QPainterPath outline;
+    outline.addEllipse(0, 0, rx * 2, ry * 2);
 
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
+    UBGraphicsStrokesGroup *shapeItem = createShapeItem(outline, fillColor, strokeColor, strokeWidth);
     QTransform transform;
     QString textTransform = element.attribute(aTransform);
 
-    svgItem->resetTransform();
     if (!textTransform.isNull()) {
-        transform = transformFromString(textTransform, svgItem);
+        transform = transformFromString(textTransform, shapeItem);
     }
 
-
-    repositionSvgItem(svgItem, rx * 2, ry * 2, cx - 2*rx, cy+ry, transform);
-    hashSceneItem(element, svgItem);
+    positionItem(shapeItem, 1, 1, cx - 2*rx, cy+ry, transform);
+    hashSceneItem(element, shapeItem);
 
     if (mGSectionContainer)
     {
-        addItemToGSection(svgItem);
+        addItemToGSection(shapeItem);
     }
 
-    delete generator;
-
     return true;
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolygon(const QDomElement &element)
@@ -355,9 +321,6 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolygon(const QDomElement &e
     //bounding rect lef top corner coordinates
     qreal x1 = polygon.boundingRect().topLeft().x();
     qreal y1 = polygon.boundingRect().topLeft().y();
-    //bounding rect dimensions
-    qreal width = polygon.boundingRect().width();
-    qreal height = polygon.boundingRect().height();
 
     QString strokeColorText = element.attribute(aStroke);
     QString fillColorText = element.attribute(aFill);
@@ -367,45 +330,25 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolygon(const QDomElement &e
     QColor fillColor = !fillColorText.isEmpty() ? colorFromString(fillColorText) : QColor();
     int strokeWidth = strokeWidthText.toDouble();
 
-    QPen pen;
-    pen.setColor(strokeColor);
-    pen.setWidth(strokeWidth);
-
-    QBrush brush;
-    brush.setColor(fillColor);
-    brush.setStyle(Qt::SolidPattern);
-
-    QSvgGenerator *generator = createSvgGenerator(width + pen.width(), height + pen.width());
-    QPainter painter;
-
-    painter.begin(generator); //drawing to svg tmp file
-
-    painter.translate(pen.widthF() / 2 - x1, pen.widthF() / 2 - y1);
-    painter.setBrush(brush);
-    painter.setPen(pen);
-    painter.drawPolygon(polygon);
+    QPainterPath outline;
+    outline.addPolygon(polygon.translated(strokeWidth / 2.0 - x1, strokeWidth / 2.0 - y1));
+    outline.closeSubpath();
 
-    painter.end();
-
-    //add resulting svg file to scene
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
+    UBGraphicsStrokesGroup *shapeItem = createShapeItem(outline, fillColor, strokeColor, strokeWidth);
     QTransform transform;
     QString textTransform = element.attribute(aTransform);
 
-    svgItem->resetTransform();
     if (!textTransform.isNull()) {
-        transform = transformFromString(textTransform, svgItem);
+        transform = transformFromString(textTransform, shapeItem);
     }
-    repositionSvgItem(svgItem, width +strokeWidth, height + strokeWidth, x1 - strokeWidth/2 + transform.m31(), y1 + strokeWidth/2 + transform.m32(), transform);
-    hashSceneItem(element, svgItem);
+    positionItem(shapeItem, 1, 1, x1 - strokeWidth/2 + transform.m31(), y1 + strokeWidth/2 + transform.m32(), transform);
+    hashSceneItem(element, shapeItem);
 
     if (mGSectionContainer)
     {
-        addItemToGSection(svgItem);
+        addItemToGSection(shapeItem);
     }
 
-    delete generator;
-
     return true;
 }
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolyline(const QDomElement &element)
@@ -443,9 +386,6 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolyline(const QDomElement &
     //bounding rect lef top corner coordinates
     qreal x1 = polygon.boundingRect().topLeft().x();
     qreal y1 = polygon.boundingRect().topLeft().y();
-    //bounding rect dimensions
-    qreal width = polygon.boundingRect().width();
-    qreal height = polygon.boundingRect().height();
 
     QString strokeColorText = element.attribute(aStroke);
     QString strokeWidthText = element.attribute(aStrokewidth);
@@ -453,43 +393,24 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgPolyline(const QDomElement &
     QColor strokeColor = !strokeColorText.isEmpty() ? colorFromString(strokeColorText) : QColor();
     int strokeWidth = strokeWidthText.toDouble();
 
-    width += strokeWidth;
-    height += strokeWidth;
-
-    QPen pen;
-    pen.setColor(strokeColor);
-    pen.setWidth(strokeWidth);
-
-    QSvgGenerator *generator = createSvgGenerator(width + pen.width(), height + pen.width());
-    QPainter painter;
+    QPainterPath outline;
+    outline.addPolygon(polygon.translated(strokeWidth / 2.0 - x1, strokeWidth / 2.0 - y1));
 
-    painter.begin(generator); //drawing to svg tmp file
-
-    painter.translate(pen.widthF()/2 - x1, pen.widthF()/2- y1);
-    painter.setPen(pen);
-    painter.drawPolyline(polygon);
-
-    painter.end();
-
-    //add resulting svg file to scene
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
+    UBGraphicsStrokesGroup *shapeItem = createShapeItem(outline, QColor(), strokeColor, strokeWidth);
     QTransform transform;
     QString textTransform = element.attribute(aTransform);
 
-    svgItem->resetTransform();
     if (!textTransform.isNull()) {
-        transform = transformFromString(textTransform, svgItem);
+        transform = transformFromString(textTransform, shapeItem);
     }
-    repositionSvgItem(svgItem, width +strokeWidth, height + strokeWidth, x1 + transform.m31() - strokeWidth/2, y1 + transform.m32() + strokeWidth/2, transform);
-    hashSceneItem(element, svgItem);
+    positionItem(shapeItem, 1, 1, x1 + transform.m31() - strokeWidth/2, y1 + transform.m32() + strokeWidth/2, transform);
+    hashSceneItem(element, shapeItem);
 
     if (mGSectionContainer)
     {
-        addItemToGSection(svgItem);
+        addItemToGSection(shapeItem);
     }
 
-    delete generator;
-
     return true;
 }
 void UBCFFSubsetAdaptor::UBCFFSubsetReader::parseTextAttributes(const QDomElement &element,
@@ -597,7 +518,10 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgText(const QDomElement &elem
     height = QFontMetrics(startFont).height();
     width = QFontMetrics(startFont).width(element.text()) + 5;
 
-    QSvgGenerator *generator = createSvgGenerator(width, height);
+    QBuffer svgData;
+    svgData.open(QIODevice::WriteOnly);
+
+    QSvgGenerator *generator = createSvgGenerator(&svgData, width, height);
     QPainter painter;
     painter.begin(generator);
     painter.setFont(startFont);
@@ -620,8 +544,8 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgText(const QDomElement &elem
 
     painter.end();
 
-    //add resulting svg file to scene
-    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl::fromLocalFile(generator->fileName()));
+    //add resulting svg to scene, straight from memory
+    UBGraphicsSvgItem *svgItem = mCurrentScene->addSvg(QUrl(), QPointF(), svgData.data());
 
     svgItem->resetTransform();
     repositionSvgItem(svgItem, width, height, x + transform.m31(), y + transform.m32(), transform);
@@ -768,21 +692,24 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::parseSvgImage(const QDomElement &ele
     QString itemRefPath = element.attribute(aHref);
 
     QPixmap pix;
+    QByteArray imageData;
     if (!itemRefPath.isNull()) {
         QString imagePath = pwdContent + "/" + itemRefPath;
-        if (!QFile::exists(imagePath)) {
+        QFile imageFile(imagePath);
+        if (!imageFile.open(QIODevice::ReadOnly)) {
             qDebug() << "can't load file" << pwdContent + "/" + itemRefPath << "maybe file corrupted";
             return false;
-        } else {
-//            qDebug() << "size of file" << itemRefPath << QFileInfo(itemRefPath).size();
         }
-        pix.load(imagePath);
-        if (pix.isNull()) {
+        imageData = imageFile.readAll();
+        imageFile.close();
+        if (!pix.loadFromData(imageData)) {
             qDebug() << "can't create pixmap for file" << pwdContent + "/" + itemRefPath << "maybe format does not supported";
+            imageData.clear();
         }
     }
 
    UBGraphicsPixmapItem *pixItem = mCurrentScene->addPixmap(pix, NULL);
+   pixItem->setOriginalData(imageData);
    QTransform transform;
    QString textTransform = element.attribute(aTransform);
 
@@ -1129,9 +1056,13 @@ void UBCFFSubsetAdaptor::UBCFFSubsetReader::repositionSvgItem(QGraphicsItem *ite
 
     QRectF itemBounds = item->boundingRect();
 
-    qreal xScale = width  / itemBounds.width();
-    qreal yScale = height / itemBounds.height();
+    positionItem(item, width  / itemBounds.width(), height / itemBounds.height(), x, y, transform);
+}
 
+void UBCFFSubsetAdaptor::UBCFFSubsetReader::positionItem(QGraphicsItem *item, qreal xScale, qreal yScale,
+                                                         qreal x, qreal y,
+                                                         QTransform &transform)
+{
     qreal fullScaleX = mVBTransFactor * xScale;
     qreal fullScaleY = mVBTransFactor * yScale;
 
@@ -1178,23 +1109,36 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::persistScenes()
         qDebug() << "No pages created";
         return false;
     }
+
+    //scenes can only be walked and rendered on the GUI thread,
+    //the thumbnails are encoded and written by the pool meanwhile
+    QList<QFuture<bool> > thumbnailWrites;
+    bool result = true;
+
     for (int i = 0; i < mProxy->pageCount(); i++) {
         mCurrentScene = UBPersistenceManager::persistenceManager()->getDocumentScene(mProxy, i);
         if (!mCurrentScene) {
             qDebug() << "can't allocate scene, loading failed";
-            return false;
+            result = false;
+            break;
         }
 
+        //svg and thumbnail both come from the scene in memory, no reload from disk
         UBSvgSubsetAdaptor::persistScene(mProxy, mCurrentScene, i);
-        UBGraphicsScene *tmpScene = UBSvgSubsetAdaptor::loadScene(mProxy, i);
-        tmpScene->setModified(true);
-        UBThumbnailAdaptor::persistScene(mProxy, tmpScene, i);
-        delete tmpScene;
+
+        QImage thumbnail = UBThumbnailAdaptor::renderThumbnail(mCurrentScene);
+        thumbnailWrites << QtConcurrent::run(&UBThumbnailAdaptor::saveThumbnail, thumbnail,
+                                             UBThumbnailAdaptor::thumbnailUrl(mProxy, i).toLocalFile());
 
         mCurrentScene->setModified(false);
     }
 
-    return true;
+    for (int i = 0; i < thumbnailWrites.size(); i++) {
+        if (!thumbnailWrites[i].result())
+            qWarning() << "cannot write thumbnail of imported page" << i;
+    }
+
+    return result;
 }
 
 QColor UBCFFSubsetAdaptor::UBCFFSubsetReader::colorFromString(const QString& clrString)
@@ -1295,39 +1239,59 @@ bool UBCFFSubsetAdaptor::UBCFFSubsetReader::getViewBoxDimenstions(const QString&
     return false;
 }
 
-QSvgGenerator* UBCFFSubsetAdaptor::UBCFFSubsetReader::createSvgGenerator(qreal width, qreal height)
+UBGraphicsStrokesGroup* UBCFFSubsetAdaptor::UBCFFSubsetReader::createShapeItem(const QPainterPath &outline, const QColor &fillColor,
+                                                                               const QColor &strokeColor, qreal strokeWidth)
+{
+    UBGraphicsStrokesGroup *group = new UBGraphicsStrokesGroup();
+
+    QList<QPolygonF> polygons;
+    QList<Qt::FillRule> fillRules;
+    QList<QColor> colors;
+
+    if (fillColor.isValid() && fillColor.alpha()) {
+        polygons << outline.toFillPolygon();
+        fillRules << Qt::OddEvenFill;
+        colors << fillColor;
+    }
+
+    //the outline was always drawn, black like the default pen when no color is given
+    if (!strokeColor.isValid() || strokeColor.alpha()) {
+        //same outline the painter drew with its default pen
+        QPainterPathStroker stroker;
+        stroker.setWidth(qMax((qreal)1, strokeWidth));
+        stroker.setCapStyle(Qt::SquareCap);
+        stroker.setJoinStyle(Qt::BevelJoin);
+
+        polygons << stroker.createStroke(outline).toFillPolygon();
+        fillRules << Qt::WindingFill;
+        colors << (strokeColor.isValid() ? strokeColor : QColor(Qt::black));
+    }
+
+    for (int i = 0; i < polygons.size(); i++) {
+        UBGraphicsPolygonItem *polygonItem = new UBGraphicsPolygonItem(polygons.at(i));
+        polygonItem->setFillRule(fillRules.at(i));
+        polygonItem->setColor(colors.at(i));
+        polygonItem->setColorsOnBackgrounds(colors.at(i), colors.at(i));
+        polygonItem->setStrokesGroup(group);
+        group->addToGroup(polygonItem);
+    }
+
+    mCurrentScene->addItem(group);
+
+    return group;
+}
+
+QSvgGenerator* UBCFFSubsetAdaptor::UBCFFSubsetReader::createSvgGenerator(QIODevice *device, qreal width, qreal height)
 {
     QSvgGenerator* generator = new QSvgGenerator();
-//    qWarning() << QString("Making generator with file %1, size (%2, %3) and viewbox (%4 %5 %6 %7)").arg(mTempFilePath)
-//        .arg(width).arg(height).arg(0.0).arg(0.0).arg(width).arg(width);
     generator->setResolution(QApplication::desktop()->physicalDpiY());
-    generator->setFileName(mTempFilePath);
+    generator->setOutputDevice(device);
     generator->setSize(QSize(width, height));
     generator->setViewBox(QRectF(0, 0, width, height));
 
     return generator;
 }
 
-bool UBCFFSubsetAdaptor::UBCFFSubsetReader::getTempFileName()
-{
-    int tmpNumber = 0;
-    QDir rootDir;
-    while (true)
-    {
-        mTempFilePath = QString("%1/sanksvg%2.%3")
-                .arg(rootDir.tempPath())
-                .arg(QDateTime::currentDateTime().toString("dd_MM_yyyy_HH-mm"))
-                .arg(tmpNumber);
-        if (!QFile::exists(mTempFilePath))
-            return true;
-        tmpNumber++;
-        if (tmpNumber == 100000)
-        {
-            qWarning() << "Import failed. Failed to create temporary file for svg objects";
-            return false;
-        }
-    }
-}
 bool UBCFFSubsetAdaptor::UBCFFSubsetReader::createTempFlashPath()
 {
     int tmpNumber = 0;
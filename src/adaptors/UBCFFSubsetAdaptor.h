@@ -30,6 +30,7 @@ class UBGraphicsPixmapItem;
 class UBGraphicsItemDelegate;
 class QTransform;
 class QPainter;
+class QPainterPath;
 class UBGraphicsItem;
 class QGraphicsItem;
 class QTextBlockFormat;
@@ -57,7 +58,6 @@ private:
         bool parse();
 
     private:
-        QString mTempFilePath;
         UBGraphicsScene *mCurrentScene;
         QRectF mCurrentSceneRect;
         QString mIndent;
@@ -131,11 +131,15 @@ private:
         void repositionSvgItem(QGraphicsItem *item, qreal width, qreal height,
                                qreal x, qreal y,
                                QTransform &transform);
+        void positionItem(QGraphicsItem *item, qreal xScale, qreal yScale,
+                          qreal x, qreal y,
+                          QTransform &transform);
+        UBGraphicsStrokesGroup* createShapeItem(const QPainterPath &outline, const QColor &fillColor,
+                                                const QColor &strokeColor, qreal strokeWidth);
         QColor colorFromString(const QString& clrString);
         QTransform transformFromString(const QString trString, QGraphicsItem *item = 0);
         bool getViewBoxDimenstions(const QString& viewBox);
-        QSvgGenerator* createSvgGenerator(qreal width, qreal height);
-        bool getTempFileName();
+        QSvgGenerator* createSvgGenerator(QIODevice *device, qreal width, qreal height);
         inline bool strToBool(QString);
         bool createTempFlashPath();
     };
@@ -1,5 +1,6 @@
 #include "UBExportCFF.h"
 #include "UBCFFAdaptor.h"
+#include "UBSvgSubsetAdaptor.h"
 #include "document/UBDocumentProxy.h"
 #include "core/UBDocumentManager.h"
 #include "core/UBApplication.h"
@@ -42,6 +43,8 @@ void UBExportCFF::persist(UBDocumentProxy* pDocument)
         if (mIsVerbose)
             UBApplication::showMessage(tr("Exporting document..."));
 
+            UBSvgSubsetAdaptor::waitForPendingImages(src);
+
             UBCFFAdaptor toIWBExporter;
             if (toIWBExporter.convertUBZToIWB(src, filename))
             {
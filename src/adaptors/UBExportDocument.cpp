@@ -22,6 +22,8 @@
 
 #include "document/UBDocumentProxy.h"
 
+#include "adaptors/UBSvgSubsetAdaptor.h"
+
 #include "globals/UBGlobals.h"
 
 THIRD_PARTY_WARNINGS_DISABLE
@@ -74,6 +76,8 @@ void UBExportDocument::persistsDocument(UBDocumentProxy* pDocumentProxy, QString
     QString documentPath(pDocumentProxy->persistencePath());
     document.checkDocumentDirectory(documentPath);
 
+    UBSvgSubsetAdaptor::waitForPendingImages(documentPath);
+
     QuaZip zip(filename);
     zip.setFileNameCodec("UTF-8");
     if(!zip.open(QuaZip::mdCreate))
@@ -45,6 +45,9 @@ using namespace merge_lib;
 
 UBExportFullPDF::UBExportFullPDF(QObject *parent)
     : UBExportAdaptor(parent)
+    , mHasPDFBackgrounds(false)
+    , mPdfPrinter(0)
+    , mPdfPainter(0)
 {
     //need to calculate screen resolution
 	QDesktopWidget* desktop = UBApplication::desktop();
@@ -55,139 +58,129 @@ UBExportFullPDF::UBExportFullPDF(QObject *parent)
 
 UBExportFullPDF::~UBExportFullPDF()
 {
-    // NOOP
+    delete mPdfPainter;
+    delete mPdfPrinter;
 }
 
 
-void UBExportFullPDF::saveOverlayPdf(UBDocumentProxy* pDocumentProxy, const QString& filename)
+void UBExportFullPDF::beginDocument(const QString& filename)
 {
-    if (!pDocumentProxy || filename.length() == 0 || pDocumentProxy->pageCount() == 0)
-        return;
+    mFilename = filename;
 
-    //PDF
-    qDebug() << "exporting document to PDF Merger" << filename;
-    QPrinter pdfPrinter;
+    QFile file(filename);
+    if (file.exists()) file.remove();
 
-    pdfPrinter.setOutputFormat(QPrinter::PdfFormat);
-    pdfPrinter.setResolution(UBSettings::settings()->pdfResolution->get().toInt());
-    pdfPrinter.setOutputFileName(filename);
-    pdfPrinter.setFullPage(true);
+    mOverlayName = filename;
+    mOverlayName.replace(".pdf", "_overlay.pdf");
 
-    QPainter* pdfPainter = 0;
+    QFile previousOverlay(mOverlayName);
+    if (previousOverlay.exists())
+        previousOverlay.remove();
 
-    for(int pageIndex = 0 ; pageIndex < pDocumentProxy->pageCount(); pageIndex++)
-    {
-        UBGraphicsScene* scene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, pageIndex);
-        // set background to white, no grid for PDF output
-        bool isDark = scene->isDarkBackground();
-        bool isCrossed = scene->isCrossedBackground();
-        scene->setBackground(false, false);
+    mHasPDFBackgrounds = false;
+    mPages.clear();
 
-        // set high res rendering
-        scene->setRenderingQuality(UBItem::RenderingQualityHigh);
-        scene->setRenderingContext(UBGraphicsScene::PdfExport);
+    //PDF
+    qDebug() << "exporting document to PDF Merger" << mOverlayName;
 
-		QSize pageSize = scene->nominalSize();
+    delete mPdfPainter;
+    mPdfPainter = 0;
+    delete mPdfPrinter;
+    mPdfPrinter = new QPrinter();
 
-		UBGraphicsPDFItem *pdfItem = qgraphicsitem_cast<UBGraphicsPDFItem*>(scene->backgroundObject());
+    mPdfPrinter->setOutputFormat(QPrinter::PdfFormat);
+    mPdfPrinter->setResolution(UBSettings::settings()->pdfResolution->get().toInt());
+    mPdfPrinter->setOutputFileName(mOverlayName);
+    mPdfPrinter->setFullPage(true);
+}
 
-        if (pdfItem) mHasPDFBackgrounds = true;
-        
-		pdfPrinter.setPaperSize(QSizeF(pageSize.width()*mScaleFactor, pageSize.height()*mScaleFactor), QPrinter::Point);
 
-        if (!pdfPainter) pdfPainter = new QPainter(&pdfPrinter);
+void UBExportFullPDF::addPage(UBGraphicsScene* scene)
+{
+    if (!mPdfPrinter || !scene)
+        return;
 
-		if (pageIndex != 0) pdfPrinter.newPage();
+    // set background to white, no grid for PDF output
+    bool isDark = scene->isDarkBackground();
+    bool isCrossed = scene->isCrossedBackground();
+    scene->setBackground(false, false);
 
-        //render to PDF
-        scene->setDrawingMode(true);
-        scene->render(pdfPainter, QRectF(), scene->normalizedSceneRect());
+    // set high res rendering
+    scene->setRenderingQuality(UBItem::RenderingQualityHigh);
+    scene->setRenderingContext(UBGraphicsScene::PdfExport);
 
-        //restore screen rendering quality
-        scene->setRenderingContext(UBGraphicsScene::Screen);
-        scene->setRenderingQuality(UBItem::RenderingQualityNormal);
+    PageDescription page;
+    page.nominalSize = scene->nominalSize();
+    page.backgroundPageNumber = 0;
 
-        //restore background state
-        scene->setDrawingMode(false);
-        scene->setBackground(isDark, isCrossed);
+    // the merge only needs the background file and page, the scene is not loaded a second time for it
+    UBGraphicsPDFItem *pdfItem = qgraphicsitem_cast<UBGraphicsPDFItem*>(scene->backgroundObject());
+
+    if (pdfItem)
+    {
+        mHasPDFBackgrounds = true;
+        page.background = UBPersistenceManager::objectDirectory + "/" + pdfItem->fileUuid().toString() + ".pdf";
+        page.backgroundPageNumber = pdfItem->pageNumber();
     }
 
-    if (pdfPainter) delete pdfPainter;
-}
+    mPdfPrinter->setPaperSize(QSizeF(page.nominalSize.width()*mScaleFactor, page.nominalSize.height()*mScaleFactor), QPrinter::Point);
 
+    if (!mPdfPainter) mPdfPainter = new QPainter(mPdfPrinter);
 
-void UBExportFullPDF::persist(UBDocumentProxy* pDocumentProxy)
-{
-    if (!pDocumentProxy)
-        return;
+    if (!mPages.isEmpty()) mPdfPrinter->newPage();
 
-    QString filename = askForFileName(pDocumentProxy, tr("Export as PDF File"));
+    mPages << page;
 
-    if (filename.length() > 0)
-    {
-        QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-        if (mIsVerbose)
-            UBApplication::showMessage(tr("Exporting document..."));
+    //render to PDF
+    scene->setDrawingMode(true);
+    scene->render(mPdfPainter, QRectF(), scene->normalizedSceneRect());
 
-        persistsDocument(pDocumentProxy, filename);
-        if (mIsVerbose)
-            UBApplication::showMessage(tr("Export successful."));
+    //restore screen rendering quality
+    scene->setRenderingContext(UBGraphicsScene::Screen);
+    scene->setRenderingQuality(UBItem::RenderingQualityNormal);
 
-        QApplication::restoreOverrideCursor();
-    }
+    //restore background state
+    scene->setDrawingMode(false);
+    scene->setBackground(isDark, isCrossed);
 }
 
 
-void UBExportFullPDF::persistsDocument(UBDocumentProxy* pDocumentProxy, const QString& filename)
+void UBExportFullPDF::finishDocument(UBDocumentProxy* pDocumentProxy)
 {
-    QFile file(filename);
-    if (file.exists()) file.remove();
-
-    QString overlayName = filename;
-    overlayName.replace(".pdf", "_overlay.pdf");
-
-    QFile previousOverlay(overlayName);
-    if (previousOverlay.exists())
-        previousOverlay.remove();
+    // closes the overlay file
+    delete mPdfPainter;
+    mPdfPainter = 0;
+    delete mPdfPrinter;
+    mPdfPrinter = 0;
 
-    mHasPDFBackgrounds = false;
-
-    saveOverlayPdf(pDocumentProxy, overlayName);
+    if (mPages.isEmpty())
+        return;
 
     if (!mHasPDFBackgrounds)
     {
-        QFile f(overlayName);
-        f.rename(filename);
+        QFile f(mOverlayName);
+        f.rename(mFilename);
     }
     else
     {
         Merger merger;
         try
         {
-            merger.addOverlayDocument(QFile::encodeName(overlayName).constData());
+            merger.addOverlayDocument(QFile::encodeName(mOverlayName).constData());
 
             MergeDescription mergeInfo;
 
-            int existingPageCount = pDocumentProxy->pageCount();
-            for(int pageIndex = 0 ; pageIndex < existingPageCount; pageIndex++)
+            for(int pageIndex = 0 ; pageIndex < mPages.count(); pageIndex++)
             {
-                UBGraphicsScene* scene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, pageIndex);
-                UBGraphicsPDFItem *pdfItem = qgraphicsitem_cast<UBGraphicsPDFItem*>(scene->backgroundObject());
+                const PageDescription& page = mPages.at(pageIndex);
 
-				QSize pageSize = scene->nominalSize();
-                
-				if (pdfItem)
+                if (!page.background.isEmpty())
                 {
-                    QString pdfName = UBPersistenceManager::objectDirectory + "/" + pdfItem->fileUuid().toString() + ".pdf";
-                    QString backgroundPath = pDocumentProxy->persistencePath() + "/" + pdfName;
+                    QString backgroundPath = pDocumentProxy->persistencePath() + "/" + page.background;
 
-                    qDebug() << "scene->itemsBoundingRect()" << scene->itemsBoundingRect();
-                    qDebug() << "pdfItem->boundingRect()" << pdfItem->boundingRect();
-                    qDebug() << "pdfItem->sceneBoundingRect()" << pdfItem->sceneBoundingRect();
-
-                    MergePageDescription pageDescription(pageSize.width() * mScaleFactor,
-                                                         pageSize.height() * mScaleFactor,
-                                                         pdfItem->pageNumber(),
+                    MergePageDescription pageDescription(page.nominalSize.width() * mScaleFactor,
+                                                         page.nominalSize.height() * mScaleFactor,
+                                                         page.backgroundPageNumber,
                                                          QFile::encodeName(backgroundPath).constData(),
                                                          TransformationDescription(),
                                                          pageIndex + 1,
@@ -200,8 +193,8 @@ void UBExportFullPDF::persistsDocument(UBDocumentProxy* pDocumentProxy, const QS
                 }
                 else
                 {
-                    MergePageDescription pageDescription(pageSize.width() * mScaleFactor,
-                             pageSize.height() * mScaleFactor,
+                    MergePageDescription pageDescription(page.nominalSize.width() * mScaleFactor,
+                             page.nominalSize.height() * mScaleFactor,
                              0,
                              "",
                              TransformationDescription(),
@@ -213,27 +206,65 @@ void UBExportFullPDF::persistsDocument(UBDocumentProxy* pDocumentProxy, const QS
                 }
             }
 
-            merger.merge(QFile::encodeName(overlayName).constData(), mergeInfo);
+            merger.merge(QFile::encodeName(mOverlayName).constData(), mergeInfo);
 
-            merger.saveMergedDocumentsAs(QFile::encodeName(filename).constData());
+            merger.saveMergedDocumentsAs(QFile::encodeName(mFilename).constData());
 
         }
         catch(Exception e)
         {
-            qDebug() << "PdfMerger failed to merge documents to " << filename << " - Exception : " << e.what();
+            qDebug() << "PdfMerger failed to merge documents to " << mFilename << " - Exception : " << e.what();
 
             // default to raster export
-            UBExportPDF::persistsDocument(pDocumentProxy, filename);
+            UBExportPDF::persistsDocument(pDocumentProxy, mFilename);
         }
 
         if (!UBApplication::app()->isVerbose())
         {
-            QFile::remove(overlayName);
+            QFile::remove(mOverlayName);
         }
     }
 }
 
 
+void UBExportFullPDF::persist(UBDocumentProxy* pDocumentProxy)
+{
+    if (!pDocumentProxy)
+        return;
+
+    QString filename = askForFileName(pDocumentProxy, tr("Export as PDF File"));
+
+    if (filename.length() > 0)
+    {
+        QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+        if (mIsVerbose)
+            UBApplication::showMessage(tr("Exporting document..."));
+
+        persistsDocument(pDocumentProxy, filename);
+        if (mIsVerbose)
+            UBApplication::showMessage(tr("Export successful."));
+
+        QApplication::restoreOverrideCursor();
+    }
+}
+
+
+void UBExportFullPDF::persistsDocument(UBDocumentProxy* pDocumentProxy, const QString& filename)
+{
+    if (!pDocumentProxy || filename.length() == 0)
+        return;
+
+    beginDocument(filename);
+
+    for(int pageIndex = 0 ; pageIndex < pDocumentProxy->pageCount(); pageIndex++)
+    {
+        addPage(UBPersistenceManager::persistenceManager()->loadDocumentScene(pDocumentProxy, pageIndex));
+    }
+
+    finishDocument(pDocumentProxy);
+}
+
+
 QString UBExportFullPDF::exportExtention()
 {
     return QString(".pdf");
@@ -20,6 +20,9 @@
 #include "UBExportAdaptor.h"
 
 class UBDocumentProxy;
+class UBGraphicsScene;
+class QPrinter;
+class QPainter;
 
 class UBExportFullPDF : public UBExportAdaptor
 {
@@ -35,12 +38,30 @@ class UBExportFullPDF : public UBExportAdaptor
 
         virtual void persistsDocument(UBDocumentProxy* pDocument, const QString& filename);
 
-    protected:
-        void saveOverlayPdf(UBDocumentProxy* pDocumentProxy, const QString& filename);
+        /*
+         * Page by page export, for callers that already have the scenes loaded.
+         * The scenes are added in page order and the pdf is written by finishDocument.
+         */
+        void beginDocument(const QString& filename);
+        void addPage(UBGraphicsScene* pScene);
+        void finishDocument(UBDocumentProxy* pDocumentProxy);
 
     private:
+        struct PageDescription
+        {
+            QSize nominalSize;
+            QString background; // pdf file relative to the document, empty when the page has no pdf background
+            int backgroundPageNumber;
+        };
+
         float mScaleFactor;
         bool mHasPDFBackgrounds;
+
+        QString mFilename;
+        QString mOverlayName;
+        QPrinter* mPdfPrinter;
+        QPainter* mPdfPainter;
+        QList<PageDescription> mPages;
 };
 
 #endif /* UBExportFullPDF_H_ */
@@ -79,12 +79,20 @@ QList<UBGraphicsItem*> UBImportImage::import(const QUuid& uuid, const QString& f
     Q_UNUSED(uuid);
     QList<UBGraphicsItem*> result;
 
-    QPixmap pix(filePath);
-    if (pix.isNull())
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return result;
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    QPixmap pix;
+    if (!pix.loadFromData(data))
         return result;
 
     UBGraphicsPixmapItem* pixmapItem = new UBGraphicsPixmapItem();
     pixmapItem->setPixmap(pix);
+    pixmapItem->setOriginalData(data);
     result << pixmapItem;
     return result;
 }
@@ -94,6 +102,7 @@ void UBImportImage::placeImportedItemToScene(UBGraphicsScene* scene, UBGraphicsI
     UBGraphicsPixmapItem* pixmapItem = (UBGraphicsPixmapItem*)item;
     
      UBGraphicsPixmapItem* sceneItem = scene->addPixmap(pixmapItem->pixmap(), NULL, QPointF(0, 0));
+     sceneItem->setOriginalData(pixmapItem->originalData(), pixmapItem->originalFormat());
      scene->setAsBackgroundObject(sceneItem, true);
 
      // Only stored pixmap, should be deleted now
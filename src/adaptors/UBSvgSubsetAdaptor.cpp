@@ -17,6 +17,7 @@
 
 #include <QtCore>
 #include <QtXml>
+#include <QtConcurrentRun>
 
 #include "domain/UBGraphicsSvgItem.h"
 #include "domain/UBGraphicsPixmapItem.h"
@@ -84,6 +85,8 @@ const QString aId = "id";
 
 QMap<QString,IDataStorage*> UBSvgSubsetAdaptor::additionalElementToStore;
 
+QHash<QString, QFuture<bool> > UBSvgSubsetAdaptor::sPendingImages;
+
 QString UBSvgSubsetAdaptor::toSvgTransform(const QMatrix& matrix)
 {
     return QString("matrix(%1, %2, %3, %4, %5, %6)")
@@ -120,6 +123,48 @@ QMatrix UBSvgSubsetAdaptor::fromSvgTransform(const QString& transform)
 
 
 
+static QString imageFileSuffix(const QByteArray& pFormat)
+{
+    if (pFormat == "jpeg")
+        return "jpg";
+
+    return QString::fromLatin1(pFormat);
+}
+
+
+bool UBSvgSubsetAdaptor::saveEncodedImage(const QImage& pImage, const QString& pPath, const QByteArray& pFormat)
+{
+    if (!pImage.save(pPath, pFormat.constData()))
+    {
+        qWarning() << "cannot save image" << pPath;
+        return false;
+    }
+
+    return true;
+}
+
+
+void UBSvgSubsetAdaptor::waitForPendingImages(const QString& pPath)
+{
+    QMutableHashIterator<QString, QFuture<bool> > it(sPendingImages);
+
+    while (it.hasNext())
+    {
+        it.next();
+
+        if (pPath.isEmpty() || it.key() == pPath || it.key().startsWith(pPath + "/"))
+        {
+            it.value().waitForFinished();
+            it.remove();
+        }
+        else if (it.value().isFinished())
+        {
+            it.remove();
+        }
+    }
+}
+
+
 static bool itemZIndexComp(const QGraphicsItem* item1,
                            const QGraphicsItem* item2)
 {
@@ -314,53 +359,6 @@ UBGraphicsScene* UBSvgSubsetAdaptor::loadScene(UBDocumentProxy* proxy, const QBy
 }
 
 
-QString UBSvgSubsetAdaptor::readTeacherGuideNode(int sceneIndex)
-{
-    QString result;
-
-    QString fileName = UBApplication::boardController->selectedDocument()->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", sceneIndex);
-    QFile file(fileName);
-    file.open(QIODevice::ReadOnly);
-    QByteArray fileByteArray=file.readAll();
-    file.close();
-    QXmlStreamReader mXmlReader(fileByteArray);
-
-    while (!mXmlReader.atEnd())
-    {
-        mXmlReader.readNext();
-        if (mXmlReader.isStartElement())
-        {
-             if (mXmlReader.name() == "teacherBar" || mXmlReader.name() == "teacherGuide"){
-                result.clear();
-                result += "<teacherGuide version=\"" + mXmlReader.attributes().value("version").toString() + "\">";
-                result += "\n";
-            }
-            else if (mXmlReader.name() == "media" || mXmlReader.name() == "link" || mXmlReader.name() == "title" || mXmlReader.name() == "comment" || mXmlReader.name() == "action")
-            {
-                result += "<" + mXmlReader.name().toString() + " ";
-                foreach(QXmlStreamAttribute attribute, mXmlReader.attributes())
-                    result += attribute.name().toString() + "=\"" + attribute.value().toString() + "\" ";
-                result += " />\n";
-            }
-            else
-            {
-                // NOOP
-            }
-        }
-        else if (mXmlReader.isEndElement() && (mXmlReader.name() == "teacherBar" || mXmlReader.name() == "teacherGuide")){
-            result += "</teacherGuide>";
-        }
-    }
-
-    if (mXmlReader.hasError())
-    {
-        qWarning() << "error parsing Sankore file " << mXmlReader.errorString();
-    }
-
-    return result;
-}
-
-
 UBSvgSubsetAdaptor::UBSvgSubsetReader::UBSvgSubsetReader(UBDocumentProxy* pProxy, const QByteArray& pXmlData)
         : mXmlReader(pXmlData)
         , mProxy(pProxy)
@@ -382,6 +380,10 @@ UBGraphicsScene* UBSvgSubsetAdaptor::UBSvgSubsetReader::loadScene()
     UBGraphicsStrokesGroup* strokesGroup = 0;
     UBDrawingController* dc = UBDrawingController::drawingController();
 
+    // kept on the scene, the guide widgets read it from there on page changes
+    bool teacherGuideOpened = false;
+    QList<tIDataStorage> teacherGuide;
+
     while (!mXmlReader.atEnd())
     {
         mXmlReader.readNext();
@@ -391,7 +393,19 @@ UBGraphicsScene* UBSvgSubsetAdaptor::UBSvgSubsetReader::loadScene()
             QUuid uuidFromSvg = getUuidFromSvg();
 
 
-            if (mXmlReader.name() == "svg")
+            if (teacherGuideOpened)
+            {
+                if (mXmlReader.name() == "media" || mXmlReader.name() == "link" || mXmlReader.name() == "title" || mXmlReader.name() == "comment" || mXmlReader.name() == "action")
+                {
+                    tIDataStorage node;
+                    node.name = mXmlReader.name().toString();
+                    node.type = eElementType_UNIQUE;
+                    foreach(QXmlStreamAttribute attribute, mXmlReader.attributes())
+                        node.attributes.insert(attribute.name().toString(), attribute.value().toString());
+                    teacherGuide << node;
+                }
+            }
+            else if (mXmlReader.name() == "svg")
             {
                 if (!mScene)
                 {
@@ -681,10 +695,6 @@ UBGraphicsScene* UBSvgSubsetAdaptor::UBSvgSubsetReader::loadScene()
                         audioItem->setUuid(uuidFromSvg);
 
                     audioItem->show();
-
-                    //force start to load the video and display the first frame
-                    audioItem->mediaObject()->play();
-                    audioItem->mediaObject()->pause();
                 }
             }
             else if (mXmlReader.name() == "video")
@@ -705,10 +715,6 @@ UBGraphicsScene* UBSvgSubsetAdaptor::UBSvgSubsetReader::loadScene()
                         videoItem->setUuid(uuidFromSvg);
 
                     videoItem->show();
-
-                    //force start to load the video and display the first frame
-                    videoItem->mediaObject()->play();
-                    videoItem->mediaObject()->pause();
                 }
             }
             else if (mXmlReader.name() == "text")//This is for backward compatibility with proto text field prior to version 4.3
@@ -950,18 +956,11 @@ UBGraphicsScene* UBSvgSubsetAdaptor::UBSvgSubsetReader::loadScene()
 
                 readGroupRoot();
             }
-//            else if (mXmlReader.name() == "teacherBar" || mXmlReader.name() == "teacherGuide"){
-//                sTeacherGuideNode.clear();
-//                sTeacherGuideNode += "<teacherGuide version=\"" + mXmlReader.attributes().value("version").toString() + "\">";
-//                sTeacherGuideNode += "\n";
-//            }
-//            else if (mXmlReader.name() == "media" || mXmlReader.name() == "link" || mXmlReader.name() == "title" || mXmlReader.name() == "comment" || mXmlReader.name() == "action")
-//            {
-//                sTeacherGuideNode += "<" + mXmlReader.name().toString() + " ";
-//                foreach(QXmlStreamAttribute attribute, mXmlReader.attributes())
-//                    sTeacherGuideNode += attribute.name().toString() + "=\"" + attribute.value().toString() + "\" ";
-//                sTeacherGuideNode += " />\n";
-//            }
+            else if (mXmlReader.name() == "teacherBar" || mXmlReader.name() == "teacherGuide")
+            {
+                teacherGuideOpened = true;
+                teacherGuide.clear();
+            }
             else
             {
                 // NOOP
@@ -985,15 +984,13 @@ UBGraphicsScene* UBSvgSubsetAdaptor::UBSvgSubsetReader::loadScene()
                 mGroupDarkBackgroundColor = QColor();
                 mGroupLightBackgroundColor = QColor();
             }
-//            else if (mXmlReader.name() == "teacherBar" || mXmlReader.name() == "teacherGuide"){
-//                sTeacherGuideNode += "</teacherGuide>";
-//                qDebug() << sTeacherGuideNode;
-//                QMap<QString,IDataStorage*> elements = getAdditionalElementToStore();
-//                IDataStorage* storageClass = elements.value("teacherGuide");
-//                if(storageClass){
-//                     storageClass->load(sTeacherGuideNode);
-//                }
-//            }
+            else if (teacherGuideOpened && (mXmlReader.name() == "teacherBar" || mXmlReader.name() == "teacherGuide"))
+            {
+                teacherGuideOpened = false;
+
+                if (mScene)
+                    mScene->setTeacherGuide(teacherGuide);
+            }
 
 
         }
@@ -1416,6 +1413,36 @@ bool UBSvgSubsetAdaptor::UBSvgSubsetWriter::persistScene(int pageIndex)
 
         if(elements.value("teacherGuide"))
         	dataStorageItems = elements.value("teacherGuide")->save(pageIndex);
+
+        if (!dataStorageItems.isEmpty())
+        {
+            // the guide widgets only hold the current page, keep the scene in step with them
+            QList<tIDataStorage> teacherGuide;
+            foreach(tIDataStorage* eachItem, dataStorageItems)
+            {
+                if (eachItem->type == eElementType_UNIQUE)
+                    teacherGuide << *eachItem;
+            }
+            mScene->setTeacherGuide(teacherGuide);
+        }
+        else if (!mScene->teacherGuide().isEmpty())
+        {
+            // any other page is written back from what was read with it
+            tIDataStorage* data = new tIDataStorage();
+            data->name = "teacherGuide";
+            data->type = eElementType_START;
+            data->attributes.insert("version", "2.00");
+            dataStorageItems << data;
+
+            foreach(tIDataStorage node, mScene->teacherGuide())
+                dataStorageItems << new tIDataStorage(node);
+
+            data = new tIDataStorage();
+            data->name = "teacherGuide";
+            data->type = eElementType_END;
+            dataStorageItems << data;
+        }
+
         foreach(tIDataStorage* eachItem, dataStorageItems){
             if(eachItem->type == eElementType_START){
                 mXmlWriter.writeStartElement(eachItem->name);
@@ -1433,6 +1460,7 @@ bool UBSvgSubsetAdaptor::UBSvgSubsetWriter::persistScene(int pageIndex)
             else
                 qWarning() << "unknown type";
         }
+        qDeleteAll(dataStorageItems);
 
         //writing group data
         if (groupRoot.hasChildNodes()) {
@@ -1521,9 +1549,9 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::polygonItemToSvgLine(UBGraphicsPolyg
     mXmlWriter.writeAttribute("y2", QString::number(line.p2().y(), 'f', 2));
 
     mXmlWriter.writeAttribute("stroke-width", QString::number(polygonItem->originalWidth(), 'f', -1));
-    mXmlWriter.writeAttribute("stroke", polygonItem->brush().color().name());
+    mXmlWriter.writeAttribute("stroke", polygonItem->color().name());
 
-    qreal alpha = polygonItem->brush().color().alphaF();
+    qreal alpha = polygonItem->color().alphaF();
     if (alpha < 1.0)
         mXmlWriter.writeAttribute("stroke-opacity", QString::number(alpha, 'f', 2));
     mXmlWriter.writeAttribute("stroke-linecap", "round");
@@ -1569,8 +1597,8 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::strokeToSvgPolyline(UBGraphicsStroke
 
         mXmlWriter.writeAttribute("fill", "none");
         mXmlWriter.writeAttribute("stroke-width", QString::number(firstPolygonItem->originalWidth(), 'f', 2));
-        mXmlWriter.writeAttribute("stroke", firstPolygonItem->brush().color().name());
-        mXmlWriter.writeAttribute("stroke-opacity", QString("%1").arg(firstPolygonItem->brush().color().alphaF()));
+        mXmlWriter.writeAttribute("stroke", firstPolygonItem->color().name());
+        mXmlWriter.writeAttribute("stroke-opacity", QString("%1").arg(firstPolygonItem->color().alphaF()));
         mXmlWriter.writeAttribute("stroke-linecap", "round");
 
         if (!groupHoldsInfo)
@@ -1622,16 +1650,16 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::polygonItemToSvgPolygon(UBGraphicsPo
 
         QString points = pointsToSvgPointsAttribute(polygon);
         mXmlWriter.writeAttribute("points", points);
-        mXmlWriter.writeAttribute("fill", polygonItem->brush().color().name());
+        mXmlWriter.writeAttribute("fill", polygonItem->color().name());
 
-        qreal alpha = polygonItem->brush().color().alphaF();
+        qreal alpha = polygonItem->color().alphaF();
         mXmlWriter.writeAttribute("fill-opacity", QString::number(alpha, 'f', 2));
 
         // we trick SVG antialiasing, to avoid seeing light gaps between polygons
         if (alpha < 1.0)
         {
             qreal trickedAlpha = trickAlpha(alpha);
-            mXmlWriter.writeAttribute("stroke", polygonItem->brush().color().name());
+            mXmlWriter.writeAttribute("stroke", polygonItem->color().name());
             mXmlWriter.writeAttribute("stroke-width", "1");
             mXmlWriter.writeAttribute("stroke-opacity", QString::number(trickedAlpha, 'f', 2));
         }
@@ -1644,6 +1672,8 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::polygonItemToSvgPolygon(UBGraphicsPo
 
         if (polygonItem->fillRule() == Qt::OddEvenFill)
             mXmlWriter.writeAttribute("fill-rule", "evenodd");
+        else // spelled out, documents without the attribute are read back as evenodd
+            mXmlWriter.writeAttribute("fill-rule", "nonzero");
 
         if (!groupHoldsInfo)
         {
@@ -1726,6 +1756,9 @@ UBGraphicsPolygonItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemFromPol
 
     polygonItem->setColor(brushColor);
 
+    if (mXmlReader.attributes().value("fill-rule") == "nonzero")
+        polygonItem->setFillRule(Qt::WindingFill);
+
     QStringRef ubZValue = mXmlReader.attributes().value(mNamespaceUri, "z-value");
 
     if (!ubZValue.isNull())
@@ -1738,41 +1771,40 @@ UBGraphicsPolygonItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemFromPol
     }
 
     QStringRef ubFillOnDarkBackground = mXmlReader.attributes().value(mNamespaceUri, "fill-on-dark-background");
+    QColor colorOnDarkBackground;
 
     if (!ubFillOnDarkBackground.isNull())
     {
-        QColor color;
-        color.setNamedColor(ubFillOnDarkBackground.toString());
-        if (!color.isValid())
-            color = Qt::white;
+        colorOnDarkBackground.setNamedColor(ubFillOnDarkBackground.toString());
+        if (!colorOnDarkBackground.isValid())
+            colorOnDarkBackground = Qt::white;
 
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnDarkBackground(color);
+        colorOnDarkBackground.setAlphaF(opacity);
     }
-    else
+    else if (mGroupDarkBackgroundColor.isValid())
     {
-        QColor color = mGroupDarkBackgroundColor;
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnDarkBackground(color);
+        colorOnDarkBackground = mGroupDarkBackgroundColor;
+        colorOnDarkBackground.setAlphaF(opacity);
     }
 
     QStringRef ubFillOnLightBackground = mXmlReader.attributes().value(mNamespaceUri, "fill-on-light-background");
+    QColor colorOnLightBackground;
 
     if (!ubFillOnLightBackground.isNull())
     {
-        QColor color;
-        color.setNamedColor(ubFillOnLightBackground.toString());
-        if (!color.isValid())
-            color = Qt::black;
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnLightBackground(color);
+        colorOnLightBackground.setNamedColor(ubFillOnLightBackground.toString());
+        if (!colorOnLightBackground.isValid())
+            colorOnLightBackground = Qt::black;
+        colorOnLightBackground.setAlphaF(opacity);
     }
-    else
+    else if (mGroupLightBackgroundColor.isValid())
     {
-        QColor color = mGroupLightBackgroundColor;
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnLightBackground(color);
+        colorOnLightBackground = mGroupLightBackgroundColor;
+        colorOnLightBackground.setAlphaF(opacity);
     }
+
+    // legacy strokes without fill-on-* attributes keep painting with their brush
+    polygonItem->setColorsOnBackgrounds(colorOnDarkBackground, colorOnLightBackground);
     return polygonItem;
 
 }
@@ -1846,42 +1878,41 @@ UBGraphicsPolygonItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItemFromLin
 
 
     QStringRef ubFillOnDarkBackground = mXmlReader.attributes().value(mNamespaceUri, "fill-on-dark-background");
+    QColor colorOnDarkBackground;
 
     if (!ubFillOnDarkBackground.isNull())
     {
-        QColor color;
-        color.setNamedColor(ubFillOnDarkBackground.toString());
-        if (!color.isValid())
-            color = Qt::white;
+        colorOnDarkBackground.setNamedColor(ubFillOnDarkBackground.toString());
+        if (!colorOnDarkBackground.isValid())
+            colorOnDarkBackground = Qt::white;
 
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnDarkBackground(color);
+        colorOnDarkBackground.setAlphaF(opacity);
     }
-    else
+    else if (mGroupDarkBackgroundColor.isValid())
     {
-        QColor color = mGroupDarkBackgroundColor;
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnDarkBackground(color);
+        colorOnDarkBackground = mGroupDarkBackgroundColor;
+        colorOnDarkBackground.setAlphaF(opacity);
     }
 
     QStringRef ubFillOnLightBackground = mXmlReader.attributes().value(mNamespaceUri, "fill-on-light-background");
+    QColor colorOnLightBackground;
 
     if (!ubFillOnLightBackground.isNull())
     {
-        QColor color;
-        color.setNamedColor(ubFillOnLightBackground.toString());
-        if (!color.isValid())
-            color = Qt::black;
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnLightBackground(color);
+        colorOnLightBackground.setNamedColor(ubFillOnLightBackground.toString());
+        if (!colorOnLightBackground.isValid())
+            colorOnLightBackground = Qt::black;
+        colorOnLightBackground.setAlphaF(opacity);
     }
-    else
+    else if (mGroupLightBackgroundColor.isValid())
     {
-        QColor color = mGroupLightBackgroundColor;
-        color.setAlphaF(opacity);
-        polygonItem->setColorOnLightBackground(color);
+        colorOnLightBackground = mGroupLightBackgroundColor;
+        colorOnLightBackground.setAlphaF(opacity);
     }
 
+    // legacy strokes without fill-on-* attributes keep painting with their brush
+    polygonItem->setColorsOnBackgrounds(colorOnDarkBackground, colorOnLightBackground);
+
     return polygonItem;
 }
 
@@ -1990,8 +2021,7 @@ QList<UBGraphicsPolygonItem*> UBSvgSubsetAdaptor::UBSvgSubsetReader::polygonItem
             UBGraphicsPolygonItem* polygonItem = new UBGraphicsPolygonItem(QLineF(points.at(i), points.at(i + 1)), lineWidth);
             polygonItem->setColor(brushColor);
             UBGraphicsItem::assignZValue(polygonItem, zValue);
-            polygonItem->setColorOnDarkBackground(colorOnDarkBackground);
-            polygonItem->setColorOnLightBackground(colorOnLightBackground);
+            polygonItem->setColorsOnBackgrounds(colorOnDarkBackground, colorOnLightBackground);
 
             polygonItems <<polygonItem;
         }
@@ -2011,16 +2041,47 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::pixmapItemToLinkedImage(UBGraphicsPi
 {
     mXmlWriter.writeStartElement("image");
 
-    QString fileName = UBPersistenceManager::imageDirectory + "/" + pixmapItem->uuid().toString() + ".png";
+    QByteArray format = pixmapItem->originalFormat();
+
+    if (!pixmapItem->hasOriginalData())
+    {
+        format = UBSettings::settings()->imageEncodingFormat->get().toByteArray().toLower();
+
+        if (!QImageWriter::supportedImageFormats().contains(format))
+            format = "png";
+    }
+
+    QString fileName = UBPersistenceManager::imageDirectory + "/" + pixmapItem->uuid().toString() + "." + imageFileSuffix(format);
 
     QString path = mDocumentPath + "/" + fileName;
 
-    if (!QFile::exists(path))
+    if (!QFile::exists(path) && !sPendingImages.contains(path))
     {
         QDir dir;
         dir.mkdir(mDocumentPath + "/" + UBPersistenceManager::imageDirectory);
 
-        pixmapItem->pixmap().toImage().save(path, "PNG");
+        if (pixmapItem->hasOriginalData())
+        {
+            QFile file(path);
+
+            if (file.open(QIODevice::WriteOnly))
+            {
+                file.write(pixmapItem->originalData());
+                file.close();
+            }
+            else
+            {
+                qWarning() << "cannot write image" << path;
+            }
+        }
+        else
+        {
+            waitForPendingImages(path); // drops the finished encodings on the way
+
+            // pixmaps cannot leave the GUI thread, only the encoding of the image does
+            sPendingImages.insert(path, QtConcurrent::run(&UBSvgSubsetAdaptor::saveEncodedImage,
+                pixmapItem->pixmap().toImage(), path, format));
+        }
     }
 
     mXmlWriter.writeAttribute(nsXLink, "href", fileName);
@@ -2041,8 +2102,21 @@ UBGraphicsPixmapItem* UBSvgSubsetAdaptor::UBSvgSubsetReader::pixmapItemFromSvg()
     if (!imageHref.isNull())
     {
         QString href = imageHref.toString();
-        QPixmap pix(mDocumentPath + "/" + UBFileSystemUtils::normalizeFilePath(href));
-        pixmapItem->setPixmap(pix);
+        QString path = mDocumentPath + "/" + UBFileSystemUtils::normalizeFilePath(href);
+
+        waitForPendingImages(path);
+
+        QFile file(path);
+        QByteArray data;
+
+        if (file.open(QIODevice::ReadOnly))
+        {
+            data = file.readAll();
+            file.close();
+        }
+
+        // decoded when painted, at the size it is shown, saving the page again copies the file
+        pixmapItem->setImageFile(mDocumentPath, path, data);
     }
     else
     {
@@ -2175,7 +2249,13 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::audioItemToLinkedAudio(UBGraphicsMed
 
     graphicsItemToSvg(audioItem);
 
-    if (audioItem->mediaObject()->state() == Phonon::PausedState && audioItem->mediaObject()->remainingTime() > 0)
+    if (!audioItem->mediaObject())
+    {
+        // not loaded since the page was opened, the position is the one it was read with
+        if (audioItem->initialPos() > 0)
+            mXmlWriter.writeAttribute(UBSettings::uniboardDocumentNamespaceUri, "position", QString("%1").arg(audioItem->initialPos()));
+    }
+    else if (audioItem->mediaObject()->state() == Phonon::PausedState && audioItem->mediaObject()->remainingTime() > 0)
     {
         qint64 pos = audioItem->mediaObject()->currentTime();
         mXmlWriter.writeAttribute(UBSettings::uniboardDocumentNamespaceUri, "position", QString("%1").arg(pos));
@@ -2204,7 +2284,13 @@ void UBSvgSubsetAdaptor::UBSvgSubsetWriter::videoItemToLinkedVideo(UBGraphicsMed
 
     graphicsItemToSvg(videoItem);
 
-    if (videoItem->mediaObject()->state() == Phonon::PausedState && videoItem->mediaObject()->remainingTime() > 0)
+    if (!videoItem->mediaObject())
+    {
+        // not loaded since the page was opened, the position is the one it was read with
+        if (videoItem->initialPos() > 0)
+            mXmlWriter.writeAttribute(UBSettings::uniboardDocumentNamespaceUri, "position", QString("%1").arg(videoItem->initialPos()));
+    }
+    else if (videoItem->mediaObject()->state() == Phonon::PausedState && videoItem->mediaObject()->remainingTime() > 0)
     {
         qint64 pos = videoItem->mediaObject()->currentTime();
         mXmlWriter.writeAttribute(UBSettings::uniboardDocumentNamespaceUri, "position", QString("%1").arg(pos));
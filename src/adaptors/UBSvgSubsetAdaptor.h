@@ -64,6 +64,10 @@ class UBSvgSubsetAdaptor
         static void convertPDFObjectsToImages(UBDocumentProxy* proxy);
         static void convertSvgImagesToImages(UBDocumentProxy* proxy);
 
+        // the images saved without their original data are encoded in the background, this waits
+        // for those of a document (or of a single image file), an empty path waits for all of them
+        static void waitForPendingImages(const QString& pPath = QString());
+
         static QMap<QString,IDataStorage*> getAdditionalElementToStore() { return additionalElementToStore;}
 
         static const QString nsSvg;
@@ -78,7 +82,6 @@ class UBSvgSubsetAdaptor
         static const QString sFontWeightPrefix;
         static const QString sFontStylePrefix;
 
-        static QString readTeacherGuideNode(int sceneIndex);
     private:
 
         static UBGraphicsScene* loadScene(UBDocumentProxy* proxy, const QByteArray& pArray);
@@ -94,6 +97,11 @@ class UBSvgSubsetAdaptor
 
         static QMap<QString,IDataStorage*> additionalElementToStore;
 
+        static bool saveEncodedImage(const QImage& pImage, const QString& pPath, const QByteArray& pFormat);
+
+        // image file path -> encoding still running, only touched from the GUI thread
+        static QHash<QString, QFuture<bool> > sPendingImages;
+
 
 
 
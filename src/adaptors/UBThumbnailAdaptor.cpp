@@ -123,41 +123,53 @@ void UBThumbnailAdaptor::persistScene(UBDocumentProxy* proxy, UBGraphicsScene* p
 
     if (pScene->isModified() || overrideModified || !thumbFile.exists())
     {
-        qreal nominalWidth = pScene->nominalSize().width();
-        qreal nominalHeight = pScene->nominalSize().height();
-        qreal ratio = nominalWidth / nominalHeight;
-        QRectF sceneRect = pScene->normalizedSceneRect(ratio);
+        saveThumbnail(renderThumbnail(pScene), fileName);
+    }
+}
 
-        qreal width = UBSettings::maxThumbnailWidth;
-        qreal height = width / ratio;
 
-        QImage thumb(width, height, QImage::Format_ARGB32);
+QImage UBThumbnailAdaptor::renderThumbnail(UBGraphicsScene* pScene)
+{
+    qreal nominalWidth = pScene->nominalSize().width();
+    qreal nominalHeight = pScene->nominalSize().height();
+    qreal ratio = nominalWidth / nominalHeight;
+    QRectF sceneRect = pScene->normalizedSceneRect(ratio);
 
-        QRectF imageRect(0, 0, width, height);
+    qreal width = UBSettings::maxThumbnailWidth;
+    qreal height = width / ratio;
 
-        QPainter painter(&thumb);
-        painter.setRenderHint(QPainter::Antialiasing, true);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    QImage thumb(width, height, QImage::Format_ARGB32);
 
-        if (pScene->isDarkBackground())
-        {
-            painter.fillRect(imageRect, Qt::black);
-        }
-        else
-        {
-            painter.fillRect(imageRect, Qt::white);
-        }
+    QRectF imageRect(0, 0, width, height);
+
+    QPainter painter(&thumb);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    if (pScene->isDarkBackground())
+    {
+        painter.fillRect(imageRect, Qt::black);
+    }
+    else
+    {
+        painter.fillRect(imageRect, Qt::white);
+    }
 
-        pScene->setRenderingContext(UBGraphicsScene::NonScreen);
-        pScene->setRenderingQuality(UBItem::RenderingQualityHigh);
+    pScene->setRenderingContext(UBGraphicsScene::NonScreen);
+    pScene->setRenderingQuality(UBItem::RenderingQualityHigh);
 
-        pScene->render(&painter, imageRect, sceneRect, Qt::KeepAspectRatio);
+    pScene->render(&painter, imageRect, sceneRect, Qt::KeepAspectRatio);
 
-        pScene->setRenderingContext(UBGraphicsScene::Screen);
-        pScene->setRenderingQuality(UBItem::RenderingQualityNormal);
+    pScene->setRenderingContext(UBGraphicsScene::Screen);
+    pScene->setRenderingQuality(UBItem::RenderingQualityNormal);
 
-        thumb.scaled(width, height, Qt::KeepAspectRatio, Qt::SmoothTransformation).save(fileName, "JPG");
-    }
+    return thumb;
+}
+
+
+bool UBThumbnailAdaptor::saveThumbnail(const QImage& pThumbnail, const QString& pFileName)
+{
+    return pThumbnail.save(pFileName, "JPG");
 }
 
 
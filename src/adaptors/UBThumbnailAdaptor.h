@@ -20,6 +20,7 @@
 class UBDocument;
 class UBDocumentProxy;
 class UBGraphicsScene;
+class QImage;
 
 class UBThumbnailAdaptor //static class
 {
@@ -30,6 +31,10 @@ public:
 
     static void persistScene(UBDocumentProxy* proxy, UBGraphicsScene* pScene, int pageIndex, bool overrideModified = false);
 
+    // rendering needs the GUI thread, saving the rendered thumbnail can run on any thread
+    static QImage renderThumbnail(UBGraphicsScene* pScene);
+    static bool saveThumbnail(const QImage& pThumbnail, const QString& pFileName);
+
     static const QPixmap* get(UBDocumentProxy* proxy, int index);
     static void load(UBDocumentProxy* proxy, QList<const QPixmap*>& list);
 
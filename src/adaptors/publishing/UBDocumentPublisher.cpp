@@ -35,6 +35,7 @@
 #include "document/UBDocumentProxy.h"
 #include "document/UBDocumentContainer.h"
 
+#include "domain/UBGraphicsScene.h"
 #include "domain/UBGraphicsWidgetItem.h"
 
 #include "globals/UBGlobals.h"
@@ -105,445 +106,556 @@ void UBDocumentPublisher::buildUbwFile()
     QDir d;
     d.mkpath(UBFileSystemUtils::defaultTempDirPath());
 
-    QString tmpDir = UBFileSystemUtils::createTempDir();
+    UBSvgSubsetAdaptor::waitForPendingImages(mSourceDocument->persistencePath());
 
-    if (UBFileSystemUtils::copyDir(mSourceDocument->persistencePath(), tmpDir))
-    {
-        QUuid publishingUuid = QUuid::createUuid();
+    QUuid publishingUuid = QUuid::createUuid();
 
-        mPublishingPath = tmpDir;
-        mPublishingSize = mSourceDocument->pageCount();
+    // only holds the pdf and the ubz while they are written, everything else goes straight into the archive
+    mPublishingPath = UBFileSystemUtils::createTempDir();
+    mPublishingSize = mSourceDocument->pageCount();
+    mWidgetScripts.clear();
 
-        rasterizeScenes();
+    QString pdfFilename = mPublishingPath + "/" + UBStringUtils::toCanonicalUuid(publishingUuid) + ".pdf";
+    QString ubzFilename = mPublishingPath + "/" + UBStringUtils::toCanonicalUuid(publishingUuid) + ".ubz";
 
-        upgradeDocumentForPublishing();
+    mTmpZipFile = UBFileSystemUtils::defaultTempDirPath() + "/" + UBStringUtils::toCanonicalUuid(QUuid::createUuid()) + ".ubw~";
 
-        UBExportFullPDF pdfExporter;
-        pdfExporter.setVerbode(false);
-        pdfExporter.persistsDocument(mSourceDocument, mPublishingPath + "/" + UBStringUtils::toCanonicalUuid(publishingUuid) + ".pdf");
+    QuaZip zip(mTmpZipFile);
+    zip.setFileNameCodec("UTF-8");
+    if (!zip.open(QuaZip::mdCreate))
+    {
+        qWarning() << "Export failed. Cause: zip.open(): " << zip.getZipError() << "," << mTmpZipFile;
+        QApplication::restoreOverrideCursor();
+        return;
+    }
 
+    QuaZipFile outFile(&zip);
+
+    bool success = publishScenes(&outFile, pdfFilename) && publishDocumentFiles(&outFile);
+
+    if (success)
+    {
         UBExportDocument ubzExporter;
         ubzExporter.setVerbode(false);
-        ubzExporter.persistsDocument(mSourceDocument, mPublishingPath + "/" + UBStringUtils::toCanonicalUuid(publishingUuid) + ".ubz");
+        ubzExporter.persistsDocument(mSourceDocument, ubzFilename);
+
+        success = addFileToZip(&outFile, pdfFilename, QFileInfo(pdfFilename).fileName(), true)
+            && addFileToZip(&outFile, ubzFilename, QFileInfo(ubzFilename).fileName(), false);
+    }
 
-        // remove all useless files
+    UBFileSystemUtils::deleteDir(mPublishingPath);
 
-        for (int pageIndex = 0; pageIndex < mPublishingSize; pageIndex++) {
-            QString filename = mPublishingPath + UBFileSystemUtils::digitFileFormat("/page%1.svg",pageIndex);
+    if (!success)
+    {
+        qWarning("Export failed. Could not add the publication files to the archive ...");
+        zip.close();
+        UBApplication::showMessage(tr("Export failed."));
+        QApplication::restoreOverrideCursor();
+        return;
+    }
 
-            QFile::remove(filename);
-        }
+    if (zip.getZipError() != 0)
+    {
+        qWarning("Export failed. Cause: zip.close(): %d", zip.getZipError());
+        zip.close();
+        UBApplication::showMessage(tr("Export failed."));
+        QApplication::restoreOverrideCursor();
+        return;
+    }
 
-        UBFileSystemUtils::deleteDir(mPublishingPath + "/" + UBPersistenceManager::imageDirectory);
-        UBFileSystemUtils::deleteDir(mPublishingPath + "/" + UBPersistenceManager::objectDirectory);
-        UBFileSystemUtils::deleteDir(mPublishingPath + "/" + UBPersistenceManager::videoDirectory);
-        UBFileSystemUtils::deleteDir(mPublishingPath + "/" + UBPersistenceManager::audioDirectory);
+    zip.close();
+}
 
-        mTmpZipFile = UBFileSystemUtils::defaultTempDirPath() + "/" + UBStringUtils::toCanonicalUuid(QUuid::createUuid()) + ".ubw~";
 
-        QuaZip zip(mTmpZipFile);
-        zip.setFileNameCodec("UTF-8");
-        if (!zip.open(QuaZip::mdCreate))
-        {
-            qWarning() << "Export failed. Cause: zip.open(): " << zip.getZipError() << "," << mTmpZipFile;
-            QApplication::restoreOverrideCursor();
-            return;
-        }
+bool UBDocumentPublisher::publishScenes(QuaZipFile* pOutZipFile, const QString& pPdfFilename)
+{
+    UBExportFullPDF pdfExporter;
+    pdfExporter.setVerbode(false);
+    pdfExporter.beginDocument(pPdfFilename);
+
+    // Scenes hold widgets and must be loaded and painted here, the jpeg compression of the
+    // previous pages runs on the thread pool meanwhile. Only a few rasters are kept waiting,
+    // a full size page image is several megabytes.
+    QList<QPair<QString, QFuture<QByteArray> > > pendingRasters;
+    int maxPendingRasters = qMax(1, QThread::idealThreadCount());
+
+    bool success = true;
 
-        QuaZipFile outFile(&zip);
+    for (int pageIndex = 0; pageIndex < mPublishingSize && success; pageIndex++)
+    {
+        UBApplication::showMessage(tr("Converting page %1/%2 ...").arg(UBDocumentContainer::pageFromSceneIndex(pageIndex)).arg(mPublishingSize), true);
+
+        // pages open on the board or recently seen are in the scene cache, the others are loaded for this pass only
+        UBGraphicsScene *scene = UBPersistenceManager::persistenceManager()->getDocumentScene(mSourceDocument, pageIndex);
+        bool ownsScene = !scene;
 
-        if (!UBFileSystemUtils::compressDirInZip(mPublishingPath, "", &outFile, true))
+        if (ownsScene)
+            scene = UBSvgSubsetAdaptor::loadScene(mSourceDocument, pageIndex);
+
+        if (!scene)
         {
-            qWarning("Export failed. compressDirInZip failed ...");
-            zip.close();
-            UBApplication::showMessage(tr("Export failed."));
-            QApplication::restoreOverrideCursor();
-            return;
+            qWarning() << "Cannot load page" << pageIndex << "of" << mSourceDocument->persistencePath() << "for publishing";
+            continue;
         }
 
-        if (zip.getZipError() != 0)
-        {
-            qWarning("Export failed. Cause: zip.close(): %d", zip.getZipError());
-            zip.close();
-            UBApplication::showMessage(tr("Export failed."));
-            QApplication::restoreOverrideCursor();
-            return;
+        pendingRasters << qMakePair(UBFileSystemUtils::digitFileFormat("page%1.jpg", pageIndex),
+                                    UBSvgSubsetRasterizer(mSourceDocument, pageIndex).rasterizeToJpeg(scene));
+
+        QList<UBGraphicsW3CWidgetItem*> widgets;
+
+        foreach(QGraphicsItem* item, scene->items()){
+            UBGraphicsW3CWidgetItem *widgetItem = dynamic_cast<UBGraphicsW3CWidgetItem*>(item);
+
+            if(widgetItem){
+                QString startFileName = widgetItem->mainHtmlFileName();
+
+                if (!startFileName.startsWith("http://"))
+                {
+                    QString startFilePath = UBPersistenceManager::widgetDirectory + "/" + widgetItem->uuid().toString() + ".wgt/" + startFileName;
+                    mWidgetScripts.insert(startFilePath, widgetPropertyScript(widgetItem, UBDocumentContainer::pageFromSceneIndex(pageIndex)));
+                }
+                else{
+                    qWarning() << "Remote Widget start file, cannot inject widget preferences and datastore entries";
+                }
+
+                widgets << widgetItem;
+            }
         }
 
-        zip.close();
+        success = addToZip(pOutZipFile, UBFileSystemUtils::digitFileFormat("page%1.json", pageIndex), pageJson(scene, widgets), true);
+
+        pdfExporter.addPage(scene);
 
+        if (ownsScene)
+            delete scene;
+
+        while (success && pendingRasters.count() >= maxPendingRasters)
+        {
+            QPair<QString, QFuture<QByteArray> > raster = pendingRasters.takeFirst();
+            success = addToZip(pOutZipFile, raster.first, raster.second.result(), false);
+        }
     }
-    else
+
+    while (success && !pendingRasters.isEmpty())
     {
-        UBApplication::showMessage(tr("Export canceled ..."));
-        QApplication::restoreOverrideCursor();
+        QPair<QString, QFuture<QByteArray> > raster = pendingRasters.takeFirst();
+        success = addToZip(pOutZipFile, raster.first, raster.second.result(), false);
     }
+
+    // full page buffers, not worth keeping until the next publication
+    UBSvgSubsetRasterizer::releasePooledImages();
+
+    pdfExporter.finishDocument(mSourceDocument);
+
+    return success;
 }
 
-void UBDocumentPublisher::rasterizeScenes()
+
+bool UBDocumentPublisher::publishDocumentFiles(QuaZipFile* pOutZipFile)
 {
+    QDir documentDir(mSourceDocument->persistencePath());
 
+    QSet<QString> skippedFiles;
     for (int pageIndex = 0; pageIndex < mPublishingSize; pageIndex++)
+        skippedFiles << UBFileSystemUtils::digitFileFormat("page%1.svg", pageIndex);
+
+    // the pages are published as rasters, the pdf and the ubz carry the media
+    skippedFiles << UBPersistenceManager::imageDirectory
+                 << UBPersistenceManager::objectDirectory
+                 << UBPersistenceManager::videoDirectory
+                 << UBPersistenceManager::audioDirectory;
+
+    mGoogleMapWidgets.clear();
+
+    QDir widgetsDir(documentDir.absoluteFilePath(UBPersistenceManager::widgetDirectory));
+
+    foreach(QFileInfo dirInfo, widgetsDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
     {
-        UBApplication::showMessage(tr("Converting page %1/%2 ...").arg(UBDocumentContainer::pageFromSceneIndex(pageIndex)).arg(mPublishingSize), true);
+        QString config = UBFileSystemUtils::readTextFile(dirInfo.absoluteFilePath() + "/config.xml").toLower();
 
-        UBDocumentProxy publishingDocument(mPublishingPath);
-        UBSvgSubsetRasterizer rasterizer(&publishingDocument, pageIndex);
+        if (config.contains("google") && config.contains("map"))
+            mGoogleMapWidgets << UBPersistenceManager::widgetDirectory + "/" + dirInfo.fileName() + "/";
+    }
 
-        QString filename = mPublishingPath + UBFileSystemUtils::digitFileFormat("/page%1.jpg",pageIndex);
+    foreach (QFileInfo file, documentDir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot))
+    {
+        if (skippedFiles.contains(file.fileName()))
+            continue;
 
-        rasterizer.rasterizeToFile(filename);
+        bool success = file.isDir() ? publishDir(pOutZipFile, QDir(file.absoluteFilePath()), file.fileName() + "/")
+                                    : addFileToZip(pOutZipFile, file.absoluteFilePath(), file.fileName(), true);
 
+        if (!success)
+            return false;
     }
+
+    return true;
 }
 
 
-void UBDocumentPublisher::updateGoogleMapApiKey()
+bool UBDocumentPublisher::publishDir(QuaZipFile* pOutZipFile, const QDir& pDir, const QString& pDestPath)
 {
-    QDir widgestDir(mPublishingPath + "/" + UBPersistenceManager::widgetDirectory);
+    foreach (QFileInfo file, pDir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot))
+    {
+        QString destName = pDestPath + file.fileName();
 
-    QString uniboardWebGoogleMapApiKey = UBSettings::settings()->uniboardWebGoogleMapApiKey->get().toString();
+        if (file.isDir())
+        {
+            if (!publishDir(pOutZipFile, QDir(file.absoluteFilePath()), destName + "/"))
+                return false;
 
-    foreach(QFileInfo dirInfo, widgestDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
-    {
-        QString config = UBFileSystemUtils::readTextFile(dirInfo.absoluteFilePath() + "/config.xml").toLower();
+            continue;
+        }
 
-        if (config.contains("google") && config.contains("map"))
+        if (!mWidgetScripts.contains(destName) && !mGoogleMapWidgets.contains(pDestPath))
         {
-            QDir widgetDir(dirInfo.absoluteFilePath());
+            if (!addFileToZip(pOutZipFile, file.absoluteFilePath(), destName, true))
+                return false;
 
-            foreach(QFileInfo fileInfo, widgetDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot))
-            {
-                QFile file(fileInfo.absoluteFilePath());
+            continue;
+        }
 
-                if (file.open(QIODevice::ReadWrite))
-                {
-                    QTextStream stream(&file);
-                    QString content = stream.readAll();
-
-                    if (content.contains("ABQIAAAA6vtVqAUu8kZ_eTz7c8kwSBT9UCAhw_xm0LNFHsWmQxTJAdp5lxSY_5r-lZriY_7sACaMnl80JcX6Og"))
-                    {
-                        content.replace("ABQIAAAA6vtVqAUu8kZ_eTz7c8kwSBT9UCAhw_xm0LNFHsWmQxTJAdp5lxSY_5r-lZriY_7sACaMnl80JcX6Og",
-                                        uniboardWebGoogleMapApiKey);
-
-                        file.resize(0);
-                        file.write(content.toUtf8());
-                    }
-                    file.close();
-                }
-            }
+        QFile inFile(file.absoluteFilePath());
+        if (!inFile.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: inFile.open(): " << inFile.errorString();
+            return false;
         }
+
+        QByteArray content = inFile.readAll();
+        inFile.close();
+
+        if (mWidgetScripts.contains(destName))
+            content = injectWidgetScript(content, mWidgetScripts.value(destName));
+
+        if (mGoogleMapWidgets.contains(pDestPath))
+        {
+            QString uniboardWebGoogleMapApiKey = UBSettings::settings()->uniboardWebGoogleMapApiKey->get().toString();
+
+            content.replace("ABQIAAAA6vtVqAUu8kZ_eTz7c8kwSBT9UCAhw_xm0LNFHsWmQxTJAdp5lxSY_5r-lZriY_7sACaMnl80JcX6Og",
+                            uniboardWebGoogleMapApiKey.toUtf8());
+        }
+
+        if (!addToZip(pOutZipFile, destName, content, true))
+            return false;
     }
+
+    return true;
 }
 
 
-void UBDocumentPublisher::upgradeDocumentForPublishing()
+bool UBDocumentPublisher::addFileToZip(QuaZipFile* pOutZipFile, const QString& pFilePath, const QString& pName, bool pCompress)
 {
-    for (int pageIndex = 0; pageIndex < mPublishingSize; pageIndex++)
+    QFile inFile(pFilePath);
+    if (!inFile.open(QIODevice::ReadOnly))
     {
-        UBDocumentProxy publishingDocument(mPublishingPath);
-        UBGraphicsScene *scene = UBSvgSubsetAdaptor::loadScene(&publishingDocument, pageIndex);
+        qWarning() << "Compression of file" << inFile.fileName() << " failed. Cause: inFile.open(): " << inFile.errorString();
+        return false;
+    }
 
-        QList<UBGraphicsW3CWidgetItem*> widgets;
+    bool success = addToZip(pOutZipFile, pName, inFile.readAll(), pCompress);
 
-        foreach(QGraphicsItem* item, scene->items()){
-            UBGraphicsW3CWidgetItem *widgetItem = dynamic_cast<UBGraphicsW3CWidgetItem*>(item);
+    inFile.close();
 
-            if(widgetItem){
-                generateWidgetPropertyScript(widgetItem, UBDocumentContainer::pageFromSceneIndex(pageIndex));
-                widgets << widgetItem;
-            }
-        }
+    return success;
+}
 
-        QString filename = mPublishingPath + UBFileSystemUtils::digitFileFormat("/page%1.json",pageIndex);
 
-        QFile jsonFile(filename);
-        if (jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
-        {
-            jsonFile.write("{\n");
-            jsonFile.write(QString("  \"scene\": {\n").toUtf8());
-            jsonFile.write(QString("    \"x\": %1,\n").arg(scene->normalizedSceneRect().x()).toUtf8());
-            jsonFile.write(QString("    \"y\": %1,\n").arg(scene->normalizedSceneRect().y()).toUtf8());
-            jsonFile.write(QString("    \"width\": %1,\n").arg(scene->normalizedSceneRect().width()).toUtf8());
-            jsonFile.write(QString("    \"height\": %1\n").arg(scene->normalizedSceneRect().height()).toUtf8());
-            jsonFile.write(QString("  },\n").toUtf8());
+bool UBDocumentPublisher::addToZip(QuaZipFile* pOutZipFile, const QString& pName, const QByteArray& pData, bool pCompress)
+{
+    // jpeg and zip content would not get any smaller, it is stored as is
+    if (!pOutZipFile->open(QIODevice::WriteOnly, QuaZipNewInfo(pName), 0, 0, pCompress ? Z_DEFLATED : 0))
+    {
+        qWarning() << "Compression of file" << pName << " failed. Cause: outFile.open(): " << pOutZipFile->getZipError();
+        return false;
+    }
 
-            jsonFile.write(QString("  \"widgets\": [\n").toUtf8());
+    pOutZipFile->write(pData);
+    if (pOutZipFile->getZipError() != UNZ_OK)
+    {
+        qWarning() << "Compression of file" << pName << " failed. Cause: outFile.write(): " << pOutZipFile->getZipError();
+        pOutZipFile->close();
+        return false;
+    }
 
-            bool first = true;
+    pOutZipFile->close();
+    if (pOutZipFile->getZipError() != UNZ_OK)
+    {
+        qWarning() << "Compression of file" << pName << " failed. Cause: outFile.close(): " << pOutZipFile->getZipError();
+        return false;
+    }
 
-            foreach(UBGraphicsW3CWidgetItem* widget, widgets)
-            {
-                if (!first)
-                    jsonFile.write(QString("    ,\n").toUtf8());
+    return true;
+}
 
-                jsonFile.write(QString("    {\n").toUtf8());
-                jsonFile.write(QString("      \"uuid\": \"%1\",\n").arg(UBStringUtils::toCanonicalUuid(widget->uuid())).toUtf8());
-                jsonFile.write(QString("      \"id\": \"%1\",\n").arg(widget->metadatas().id).toUtf8());
 
-                jsonFile.write(QString("      \"name\": \"%1\",\n").arg(widget->metadatas().name).toUtf8());
-                jsonFile.write(QString("      \"description\": \"%1\",\n").arg(widget->metadatas().description).toUtf8());
-                jsonFile.write(QString("      \"author\": \"%1\",\n").arg(widget->metadatas().author).toUtf8());
-                jsonFile.write(QString("      \"authorEmail\": \"%1\",\n").arg(widget->metadatas().authorEmail).toUtf8());
-                jsonFile.write(QString("      \"authorHref\": \"%1\",\n").arg(widget->metadatas().authorHref).toUtf8());
-                jsonFile.write(QString("      \"version\": \"%1\",\n").arg(widget->metadatas().authorHref).toUtf8());
+QByteArray UBDocumentPublisher::pageJson(UBGraphicsScene *pScene, const QList<UBGraphicsW3CWidgetItem*>& pWidgets)
+{
+    QByteArray json;
 
-                jsonFile.write(QString("      \"x\": %1,\n").arg(widget->sceneBoundingRect().x()).toUtf8());
-                jsonFile.write(QString("      \"y\": %1,\n").arg(widget->sceneBoundingRect().y()).toUtf8());
-                jsonFile.write(QString("      \"width\": %1,\n").arg(widget->sceneBoundingRect().width()).toUtf8());
-                jsonFile.write(QString("      \"height\": %1,\n").arg(widget->sceneBoundingRect().height()).toUtf8());
+    json.append("{\n");
+    json.append(QString("  \"scene\": {\n").toUtf8());
+    json.append(QString("    \"x\": %1,\n").arg(pScene->normalizedSceneRect().x()).toUtf8());
+    json.append(QString("    \"y\": %1,\n").arg(pScene->normalizedSceneRect().y()).toUtf8());
+    json.append(QString("    \"width\": %1,\n").arg(pScene->normalizedSceneRect().width()).toUtf8());
+    json.append(QString("    \"height\": %1\n").arg(pScene->normalizedSceneRect().height()).toUtf8());
+    json.append(QString("  },\n").toUtf8());
 
-                jsonFile.write(QString("      \"nominalWidth\": %1,\n").arg(widget->boundingRect().width()).toUtf8());
-                jsonFile.write(QString("      \"nominalHeight\": %1,\n").arg(widget->boundingRect().height()).toUtf8());
+    json.append(QString("  \"widgets\": [\n").toUtf8());
 
-                QString url = UBPersistenceManager::widgetDirectory + "/" + widget->uuid().toString() + ".wgt";
-                jsonFile.write(QString("      \"src\": \"%1\",\n").arg(url).toUtf8());
-                QString startFile = widget->mainHtmlFileName();
-                jsonFile.write(QString("      \"startFile\": \"%1\",\n").arg(startFile).toUtf8());
+    bool first = true;
 
-                QMap<QString, QString> preferences = widget->UBGraphicsWidgetItem::preferences();
+    foreach(UBGraphicsW3CWidgetItem* widget, pWidgets)
+    {
+        if (!first)
+            json.append(QString("    ,\n").toUtf8());
 
-                jsonFile.write(QString("      \"preferences\": {\n").toUtf8());
+        json.append(QString("    {\n").toUtf8());
+        json.append(QString("      \"uuid\": \"%1\",\n").arg(UBStringUtils::toCanonicalUuid(widget->uuid())).toUtf8());
+        json.append(QString("      \"id\": \"%1\",\n").arg(widget->metadatas().id).toUtf8());
 
-                foreach(QString key, preferences.keys())
-                {
-                    QString sep = ",";
-                    if (key == preferences.keys().last())
-                        sep = "";
-
-                    jsonFile.write(QString("          \"%1\": \"%2\"%3\n")
-                                   .arg(key)
-                                   .arg(preferences.value(key))
-                                   .arg(sep)
-                                   .toUtf8());
-                }
-                jsonFile.write(QString("      },\n").toUtf8());
+        json.append(QString("      \"name\": \"%1\",\n").arg(widget->metadatas().name).toUtf8());
+        json.append(QString("      \"description\": \"%1\",\n").arg(widget->metadatas().description).toUtf8());
+        json.append(QString("      \"author\": \"%1\",\n").arg(widget->metadatas().author).toUtf8());
+        json.append(QString("      \"authorEmail\": \"%1\",\n").arg(widget->metadatas().authorEmail).toUtf8());
+        json.append(QString("      \"authorHref\": \"%1\",\n").arg(widget->metadatas().authorHref).toUtf8());
+        json.append(QString("      \"version\": \"%1\",\n").arg(widget->metadatas().authorHref).toUtf8());
 
-                jsonFile.write(QString("      \"datastore\": {\n").toUtf8());
+        json.append(QString("      \"x\": %1,\n").arg(widget->sceneBoundingRect().x()).toUtf8());
+        json.append(QString("      \"y\": %1,\n").arg(widget->sceneBoundingRect().y()).toUtf8());
+        json.append(QString("      \"width\": %1,\n").arg(widget->sceneBoundingRect().width()).toUtf8());
+        json.append(QString("      \"height\": %1,\n").arg(widget->sceneBoundingRect().height()).toUtf8());
 
-                QMap<QString, QString> datastoreEntries = widget->datastoreEntries();
+        json.append(QString("      \"nominalWidth\": %1,\n").arg(widget->boundingRect().width()).toUtf8());
+        json.append(QString("      \"nominalHeight\": %1,\n").arg(widget->boundingRect().height()).toUtf8());
 
-                foreach(QString entry, datastoreEntries.keys())
-                {
-                    QString sep = ",";
-                    if (entry == datastoreEntries.keys().last())
-                        sep = "";
-
-                    jsonFile.write(QString("          \"%1\": \"%2\"%3\n")
-                                   .arg(entry)
-                                   .arg(datastoreEntries.value(entry))
-                                   .arg(sep)
-                                   .toUtf8());
-                }
-                jsonFile.write(QString("      }\n").toUtf8());
+        QString url = UBPersistenceManager::widgetDirectory + "/" + widget->uuid().toString() + ".wgt";
+        json.append(QString("      \"src\": \"%1\",\n").arg(url).toUtf8());
+        QString startFile = widget->mainHtmlFileName();
+        json.append(QString("      \"startFile\": \"%1\",\n").arg(startFile).toUtf8());
 
-                jsonFile.write(QString("    }\n").toUtf8());
+        QMap<QString, QString> preferences = widget->UBGraphicsWidgetItem::preferences();
 
-                first = false;
-            }
+        json.append(QString("      \"preferences\": {\n").toUtf8());
 
-            jsonFile.write("  ]\n");
-            jsonFile.write("}\n");
+        foreach(QString key, preferences.keys())
+        {
+            QString sep = ",";
+            if (key == preferences.keys().last())
+                sep = "";
+
+            json.append(QString("          \"%1\": \"%2\"%3\n")
+                           .arg(key)
+                           .arg(preferences.value(key))
+                           .arg(sep)
+                           .toUtf8());
         }
-        else
+        json.append(QString("      },\n").toUtf8());
+
+        json.append(QString("      \"datastore\": {\n").toUtf8());
+
+        QMap<QString, QString> datastoreEntries = widget->datastoreEntries();
+
+        foreach(QString entry, datastoreEntries.keys())
         {
-            qWarning() << "Cannot open file" << filename << "for saving page state";
+            QString sep = ",";
+            if (entry == datastoreEntries.keys().last())
+                sep = "";
+
+            json.append(QString("          \"%1\": \"%2\"%3\n")
+                           .arg(entry)
+                           .arg(datastoreEntries.value(entry))
+                           .arg(sep)
+                           .toUtf8());
         }
+        json.append(QString("      }\n").toUtf8());
+
+        json.append(QString("    }\n").toUtf8());
 
-        delete scene;
+        first = false;
     }
 
-    updateGoogleMapApiKey();
+    json.append("  ]\n");
+    json.append("}\n");
+
+    return json;
 }
 
 
-void UBDocumentPublisher::generateWidgetPropertyScript(UBGraphicsW3CWidgetItem *widgetItem, int pageNumber)
+QStringList UBDocumentPublisher::widgetPropertyScript(UBGraphicsW3CWidgetItem *widgetItem, int pageNumber)
 {
-
     QMap<QString, QString> preferences = widgetItem->UBGraphicsWidgetItem::preferences();
     QMap<QString, QString> datastoreEntries = widgetItem->datastoreEntries();
 
-    QString startFileName = widgetItem->mainHtmlFileName();
+    QStringList lines;
+
+    lines << "";
+    lines << "  <script type=\"text/javascript\">";
+
+    lines << "    var widget = {};";
+    lines << "    widget.id = '" + widgetItem->metadatas().id + "';";
+    lines << "    widget.name = '" + widgetItem->metadatas().name + "';";
+    lines << "    widget.description = '" + widgetItem->metadatas().description + "';";
+    lines << "    widget.author = '" + widgetItem->metadatas().author + "';";
+    lines << "    widget.authorEmail = '" + widgetItem->metadatas().authorEmail + "';";
+    lines << "    widget.authorHref = '" + widgetItem->metadatas().authorHref + "';";
+    lines << "    widget.version = '" + widgetItem->metadatas().version + "';";
 
-    if (!startFileName.startsWith("http://"))
+    lines << "    widget.uuid = '" + UBStringUtils::toCanonicalUuid(widgetItem->uuid()) + "';";
+
+    lines << "    widget.width = " + QString("%1").arg(widgetItem->nominalSize().width()) + ";";
+    lines << "    widget.height = " + QString("%1").arg(widgetItem->nominalSize().height()) + ";";
+    lines << "    widget.openUrl = function(url) { window.open(url); }";
+    lines << "    widget.preferences = new Array()";
+
+    foreach(QString pref, preferences.keys())
     {
-        QString startFilePath = mPublishingPath + "/" + UBPersistenceManager::widgetDirectory + "/" + widgetItem->uuid().toString() + ".wgt/" + startFileName;
+        lines << "      widget.preferences['" + pref + "'] = '" + preferences.value(pref) + "';";
+    }
 
-        QFile startFile(startFilePath);
+    lines << "    widget.preferences.key = function(index) {";
+    lines << "      var currentIndex = 0;";
+    lines << "      for(key in widget.preferences){";
+    lines << "        if (currentIndex == index){ return key;}";
+    lines << "        currentIndex++;";
+    lines << "      }";
+    lines << "      return '';";
+    lines << "    }";
+
+    lines << "    widget.preferences.getItem = function(key) {";
+    lines << "      return widget.preferences[key];";
+    lines << "    }";
+
+    lines << "    widget.preferences.setItem = function(key, value) {}";
+    lines << "    widget.preferences.removeItem = function(key) {}";
+    lines << "    widget.preferences.clear = function() {}";
+
+    lines << "    var uniboard = {};";
+    lines << "    uniboard.pageCount = " + QString("%1").arg(mPublishingSize) + ";";
+    lines << "    uniboard.currentPageNumber = " + QString("%1").arg(pageNumber) + ";";
+    lines << "    uniboard.uuid = '" + UBStringUtils::toCanonicalUuid(widgetItem->uuid()) + "'";
+    lines << "    uniboard.lang = navigator.language;";
+    lines << "    uniboard.locale = function() {return navigator.language}";
+    lines << "    uniboard.messages = {}";
+    lines << "    uniboard.messages.subscribeToTopic = function(topicName){}";
+    lines << "    uniboard.messages.unsubscribeFromTopic = function(topicName){}";
+    lines << "    uniboard.messages.sendMessage = function(topicName, message){}";
+
+    lines << "    uniboard.datastore = {};";
+    lines << "    uniboard.datastore.document = new Array();";
+    foreach(QString entry, datastoreEntries.keys())
+    {
+        lines << "      uniboard.datastore.document['" + entry + "'] = '" + datastoreEntries.value(entry) + "';";
+    }
 
-        if (startFile.exists())
-        {
-            if (startFile.open(QIODevice::ReadWrite))
-            {
-                QTextStream stream(&startFile);
-                QStringList lines;
+    lines << "    uniboard.datastore.document.key = function(index) {";
+    lines << "      var currentIndex = 0;";
+    lines << "      for(key in uniboard.datastore.document){";
+    lines << "        if (currentIndex == index){ return key;}";
+    lines << "        currentIndex++;";
+    lines << "      }";
+    lines << "      return '';";
+    lines << "    }";
+
+    lines << "    uniboard.datastore.document.getItem = function(key) {";
+    lines << "      return uniboard.datastore.document[key];";
+    lines << "    }";
+
+    lines << "    uniboard.datastore.document.setItem = function(key, value) {}";
+    lines << "    uniboard.datastore.document.removeItem = function(key) {}";
+    lines << "    uniboard.datastore.document.clear = function() {}";
+
+    lines << "    uniboard.setTool = function(tool){}";
+    lines << "    uniboard.setPenColor = function(color){}";
+    lines << "    uniboard.setMarkerColor = function(color){}";
+
+    lines << "    uniboard.pageThumbnail = function(pageNumber){";
+    lines << "      var nb;";
+    lines << "      if (pageNumber < 10) return 'page00' + pageNumber + '.thumbnail.jpg';";
+    lines << "      if (pageNumber < 100) return 'page0' + pageNumber + '.thumbnail.jpg';";
+    lines << "      return 'page' + pageNumber + '.thumbnail.jpg;'";
+    lines << "    }";
+
+    lines << "    uniboard.zoom = function(factor, x, y){}";
+    lines << "    uniboard.move = function(x, y){}";
+    lines << "    uniboard.move = function(x, y){}";
+    lines << "    uniboard.moveTo = function(x, y){}";
+    lines << "    uniboard.drawLineTo = function(x, y, width){}";
+    lines << "    uniboard.eraseLineTo = function(x, y, width){}";
+    lines << "    uniboard.clear = function(){}";
+    lines << "    uniboard.setBackground = function(dark, crossed){}";
+    lines << "    uniboard.addObject = function(url, width, height, x, y, background){}";
+    lines << "    uniboard.resize = function(width, height){window.resizeTo(width, height);}";
+
+    lines << "    uniboard.showMessage = function(message){alert(message);}";
+    lines << "    uniboard.centerOn = function(x, y){}";
+    lines << "    uniboard.addText = function(text, x, y){}";
+
+    lines << "    uniboard.setPreference = function(key, value){}";
+    lines << "    uniboard.preference = function(key, defValue){";
+    lines << "      var pref = widget.preferences[key];";
+    lines << "      if (pref == undefined) ";
+    lines << "        return defValue;";
+    lines << "      else ";
+    lines << "        return pref;";
+    lines << "    }";
+    lines << "    uniboard.preferenceKeys = function(){";
+    lines << "        var keys = new Array();";
+    lines << "        for(key in widget.preferences){";
+    lines << "            keys.push(key);";
+    lines << "        }";
+    lines << "        return keys;";
+    lines << "    }";
+
+    lines << "    uniboard.datastore.document.key = function(index) {";
+    lines << "        var currentIndex = 0;";
+    lines << "        for(key in uniboard.datastore.document){";
+    lines << "            if (currentIndex == index){ return key;}";
+    lines << "            currentIndex++;";
+    lines << "        }";
+    lines << "        return '';";
+    lines << "    }";
+
+    lines << "    uniboard.datastore.document.getItem = function(key) {";
+    lines << "        return uniboard.datastore.document[key];";
+    lines << "    }";
+
+    lines << "    uniboard.datastore.document.setItem = function(key, value) {}";
+    lines << "    uniboard.datastore.document.removeItem = function(key) {}";
+    lines << "    uniboard.datastore.document.clear = function() {}";
+
+    lines << "  </script>";
+    lines << "";
+
+    return lines;
+}
 
-                bool addedJs = false;
 
-                QString line;
-                do
-                {
-                    line = stream.readLine();
-                    if (!line.isNull())
-                    {
-                        lines << line;
-
-                        if (!addedJs && line.contains("<head") && line.contains(">") )  // TODO UB 4.6, this is naive ... the HEAD tag may be on several lines
-                        {
-                            lines << "";
-                            lines << "  <script type=\"text/javascript\">";
-
-                            lines << "    var widget = {};";
-                            lines << "    widget.id = '" + widgetItem->metadatas().id + "';";
-                            lines << "    widget.name = '" + widgetItem->metadatas().name + "';";
-                            lines << "    widget.description = '" + widgetItem->metadatas().description + "';";
-                            lines << "    widget.author = '" + widgetItem->metadatas().author + "';";
-                            lines << "    widget.authorEmail = '" + widgetItem->metadatas().authorEmail + "';";
-                            lines << "    widget.authorHref = '" + widgetItem->metadatas().authorHref + "';";
-                            lines << "    widget.version = '" + widgetItem->metadatas().version + "';";
-
-                            lines << "    widget.uuid = '" + UBStringUtils::toCanonicalUuid(widgetItem->uuid()) + "';";
-
-                            lines << "    widget.width = " + QString("%1").arg(widgetItem->nominalSize().width()) + ";";
-                            lines << "    widget.height = " + QString("%1").arg(widgetItem->nominalSize().height()) + ";";
-                            lines << "    widget.openUrl = function(url) { window.open(url); }";
-                            lines << "    widget.preferences = new Array()";
-
-                            foreach(QString pref, preferences.keys())
-                            {
-                                lines << "      widget.preferences['" + pref + "'] = '" + preferences.value(pref) + "';";
-                            }
-
-                            lines << "    widget.preferences.key = function(index) {";
-                            lines << "      var currentIndex = 0;";
-                            lines << "      for(key in widget.preferences){";
-                            lines << "        if (currentIndex == index){ return key;}";
-                            lines << "        currentIndex++;";
-                            lines << "      }";
-                            lines << "      return '';";
-                            lines << "    }";
-
-                            lines << "    widget.preferences.getItem = function(key) {";
-                            lines << "      return widget.preferences[key];";
-                            lines << "    }";
-
-                            lines << "    widget.preferences.setItem = function(key, value) {}";
-                            lines << "    widget.preferences.removeItem = function(key) {}";
-                            lines << "    widget.preferences.clear = function() {}";
-
-                            lines << "    var uniboard = {};";
-                            lines << "    uniboard.pageCount = " + QString("%1").arg(mPublishingSize) + ";";
-                            lines << "    uniboard.currentPageNumber = " + QString("%1").arg(pageNumber) + ";";
-                            lines << "    uniboard.uuid = '" + UBStringUtils::toCanonicalUuid(widgetItem->uuid()) + "'";
-                            lines << "    uniboard.lang = navigator.language;";
-                            lines << "    uniboard.locale = function() {return navigator.language}";
-                            lines << "    uniboard.messages = {}";
-                            lines << "    uniboard.messages.subscribeToTopic = function(topicName){}";
-                            lines << "    uniboard.messages.unsubscribeFromTopic = function(topicName){}";
-                            lines << "    uniboard.messages.sendMessage = function(topicName, message){}";
-
-                            lines << "    uniboard.datastore = {};";
-                            lines << "    uniboard.datastore.document = new Array();";
-                            foreach(QString entry, datastoreEntries.keys())
-                            {
-                                lines << "      uniboard.datastore.document['" + entry + "'] = '" + datastoreEntries.value(entry) + "';";
-                            }
-
-                            lines << "    uniboard.datastore.document.key = function(index) {";
-                            lines << "      var currentIndex = 0;";
-                            lines << "      for(key in uniboard.datastore.document){";
-                            lines << "        if (currentIndex == index){ return key;}";
-                            lines << "        currentIndex++;";
-                            lines << "      }";
-                            lines << "      return '';";
-                            lines << "    }";
-
-                            lines << "    uniboard.datastore.document.getItem = function(key) {";
-                            lines << "      return uniboard.datastore.document[key];";
-                            lines << "    }";
-
-                            lines << "    uniboard.datastore.document.setItem = function(key, value) {}";
-                            lines << "    uniboard.datastore.document.removeItem = function(key) {}";
-                            lines << "    uniboard.datastore.document.clear = function() {}";
-
-                            lines << "    uniboard.setTool = function(tool){}";
-                            lines << "    uniboard.setPenColor = function(color){}";
-                            lines << "    uniboard.setMarkerColor = function(color){}";
-
-                            lines << "    uniboard.pageThumbnail = function(pageNumber){";
-                            lines << "      var nb;";
-                            lines << "      if (pageNumber < 10) return 'page00' + pageNumber + '.thumbnail.jpg';";
-                            lines << "      if (pageNumber < 100) return 'page0' + pageNumber + '.thumbnail.jpg';";
-                            lines << "      return 'page' + pageNumber + '.thumbnail.jpg;'";
-                            lines << "    }";
-
-                            lines << "    uniboard.zoom = function(factor, x, y){}";
-                            lines << "    uniboard.move = function(x, y){}";
-                            lines << "    uniboard.move = function(x, y){}";
-                            lines << "    uniboard.moveTo = function(x, y){}";
-                            lines << "    uniboard.drawLineTo = function(x, y, width){}";
-                            lines << "    uniboard.eraseLineTo = function(x, y, width){}";
-                            lines << "    uniboard.clear = function(){}";
-                            lines << "    uniboard.setBackground = function(dark, crossed){}";
-                            lines << "    uniboard.addObject = function(url, width, height, x, y, background){}";
-                            lines << "    uniboard.resize = function(width, height){window.resizeTo(width, height);}";
-
-                            lines << "    uniboard.showMessage = function(message){alert(message);}";
-                            lines << "    uniboard.centerOn = function(x, y){}";
-                            lines << "    uniboard.addText = function(text, x, y){}";
-
-                            lines << "    uniboard.setPreference = function(key, value){}";
-                            lines << "    uniboard.preference = function(key, defValue){";
-                            lines << "      var pref = widget.preferences[key];";
-                            lines << "      if (pref == undefined) ";
-                            lines << "        return defValue;";
-                            lines << "      else ";
-                            lines << "        return pref;";
-                            lines << "    }";
-                            lines << "    uniboard.preferenceKeys = function(){";
-                            lines << "        var keys = new Array();";
-                            lines << "        for(key in widget.preferences){";
-                            lines << "            keys.push(key);";
-                            lines << "        }";
-                            lines << "        return keys;";
-                            lines << "    }";
-
-                            lines << "    uniboard.datastore.document.key = function(index) {";
-                            lines << "        var currentIndex = 0;";
-                            lines << "        for(key in uniboard.datastore.document){";
-                            lines << "            if (currentIndex == index){ return key;}";
-                            lines << "            currentIndex++;";
-                            lines << "        }";
-                            lines << "        return '';";
-                            lines << "    }";
-
-                            lines << "    uniboard.datastore.document.getItem = function(key) {";
-                            lines << "        return uniboard.datastore.document[key];";
-                            lines << "    }";
-
-                            lines << "    uniboard.datastore.document.setItem = function(key, value) {}";
-                            lines << "    uniboard.datastore.document.removeItem = function(key) {}";
-                            lines << "    uniboard.datastore.document.clear = function() {}";
-
-                            lines << "  </script>";
-                            lines << "";
-
-                            addedJs = true;
-                        }
-                    }
-                }
-                while (!line.isNull());
+QByteArray UBDocumentPublisher::injectWidgetScript(const QByteArray& pContent, const QStringList& pScript)
+{
+    QTextStream stream(pContent);
+    QStringList lines;
 
-                startFile.resize(0);
-                startFile.write(lines.join("\n").toUtf8()); // TODO UB 4.x detect real html encoding
+    bool addedJs = false;
+
+    QString line;
+    do
+    {
+        line = stream.readLine();
+        if (!line.isNull())
+        {
+            lines << line;
 
-                startFile.close();
+            if (!addedJs && line.contains("<head") && line.contains(">") )  // TODO UB 4.6, this is naive ... the HEAD tag may be on several lines
+            {
+                lines << pScript;
+                addedJs = true;
             }
         }
     }
-    else{
-        qWarning() << "Remote Widget start file, cannot inject widget preferences and datastore entries";
-    }
+    while (!line.isNull());
+
+    return lines.join("\n").toUtf8(); // TODO UB 4.x detect real html encoding
 }
 
 void UBDocumentPublisher::init()
@@ -31,6 +31,8 @@ typedef struct
 class UBDocumentProxy;
 class UBServerXMLHttpRequest;
 class UBGraphicsW3CWidgetItem;
+class UBGraphicsScene;
+class QuaZipFile;
 class QWebView;
 
 class UBProxyLoginDlg : public QDialog
@@ -94,10 +96,14 @@ signals:
 
 protected:
 
-    virtual void updateGoogleMapApiKey();
-    virtual void rasterizeScenes();
-    virtual void upgradeDocumentForPublishing();
-    virtual void generateWidgetPropertyScript(UBGraphicsW3CWidgetItem *widgetItem, int pageNumber);
+    /*
+     * Loads every page once and adds its jpeg raster and json description to the archive,
+     * the same scene is painted into the pdf.
+     */
+    virtual bool publishScenes(QuaZipFile* pOutZipFile, const QString& pPdfFilename);
+    virtual bool publishDocumentFiles(QuaZipFile* pOutZipFile);
+    virtual QByteArray pageJson(UBGraphicsScene *pScene, const QList<UBGraphicsW3CWidgetItem*>& pWidgets);
+    virtual QStringList widgetPropertyScript(UBGraphicsW3CWidgetItem *widgetItem, int pageNumber);
 
 private slots:
 
@@ -125,7 +131,14 @@ private:
     bool bLoginCookieSet;
 
     void buildUbwFile();
+    bool publishDir(QuaZipFile* pOutZipFile, const QDir& pDir, const QString& pDestPath);
+    static bool addFileToZip(QuaZipFile* pOutZipFile, const QString& pFilePath, const QString& pName, bool pCompress);
+    static bool addToZip(QuaZipFile* pOutZipFile, const QString& pName, const QByteArray& pData, bool pCompress);
+    static QByteArray injectWidgetScript(const QByteArray& pContent, const QStringList& pScript);
+
     QString mTmpZipFile;
+    QHash<QString, QStringList> mWidgetScripts; // widget start file in the archive, script added to its head
+    QSet<QString> mGoogleMapWidgets;
     QList<QNetworkCookie> mCookies;
     sDocumentInfos mDocInfos;
 
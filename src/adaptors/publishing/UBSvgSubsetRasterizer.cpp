@@ -13,13 +13,26 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QtConcurrentRun>
+
 #include "UBSvgSubsetRasterizer.h"
 
+#include "frameworks/UBFileSystemUtils.h"
+
+#include "core/UBPersistenceManager.h"
+
+#include "document/UBDocumentProxy.h"
+
 #include "domain/UBGraphicsScene.h"
 #include "adaptors/UBSvgSubsetAdaptor.h"
 
 #include "core/memcheck.h"
 
+// a jpeg of a full page is a few hundred kB
+QCache<QString, UBSvgSubsetRasterizer::RasterizedPage> UBSvgSubsetRasterizer::sRasterizedPages(64 * 1024);
+QMutex UBSvgSubsetRasterizer::sRasterizedPagesMutex;
+QList<QImage> UBSvgSubsetRasterizer::sImagePool;
+
 UBSvgSubsetRasterizer::UBSvgSubsetRasterizer(UBDocumentProxy* document, int pageIndex, QObject* parent)
     : QObject(parent)
     , mDocument(document)
@@ -43,17 +56,148 @@ bool UBSvgSubsetRasterizer::rasterizeToFile(const QString& filename)
             return false;
     }
 
-    UBGraphicsScene* scene = UBSvgSubsetAdaptor::loadScene(mDocument, mPageIndex);
+    QByteArray jpeg = rasterizeToJpeg().result();
 
-    if (!scene)
+    if (jpeg.isEmpty())
+        return false;
+
+    QFile file(filename);
+
+    if (!file.open(QIODevice::WriteOnly))
         return false;
 
+    bool success = file.write(jpeg) == jpeg.size();
+
+    file.close();
+
+    return success;
+}
+
+
+QFuture<QByteArray> UBSvgSubsetRasterizer::rasterizeToJpeg(UBGraphicsScene* scene)
+{
+    QString svgPath = mDocument->persistencePath() + UBFileSystemUtils::digitFileFormat("/page%1.svg", mPageIndex);
+
+    if (!scene)
+        scene = UBPersistenceManager::persistenceManager()->getDocumentScene(mDocument, mPageIndex);
+
+    // a scene modified since it was persisted is newer than its svg, it is neither looked up nor kept
+    QFileInfo svgInfo(svgPath);
+    QDateTime svgLastModified;
+    QString svgHash;
+
+    if ((!scene || !scene->isModified()) && svgInfo.exists())
+    {
+        svgLastModified = svgInfo.lastModified();
+
+        QFile svgFile(svgPath);
+        if (svgFile.open(QIODevice::ReadOnly))
+        {
+            svgHash = UBFileSystemUtils::md5(svgFile.readAll());
+            svgFile.close();
+        }
+
+        QMutexLocker locker(&sRasterizedPagesMutex);
+
+        RasterizedPage* page = sRasterizedPages.object(svgPath);
+
+        if (page && page->svgLastModified == svgLastModified && page->svgHash == svgHash)
+        {
+            QFutureInterface<QByteArray> result;
+            result.reportStarted();
+            result.reportFinished(&page->jpeg);
+
+            return result.future();
+        }
+    }
+
+    bool ownsScene = false;
+
+    if (!scene)
+    {
+        scene = UBSvgSubsetAdaptor::loadScene(mDocument, mPageIndex);
+        ownsScene = true;
+    }
+
+    if (!scene)
+    {
+        QFutureInterface<QByteArray> result;
+        result.reportStarted();
+        result.reportFinished();
+
+        return result.future();
+    }
+
+    QFuture<QByteArray> jpeg = QtConcurrent::run(&UBSvgSubsetRasterizer::encodeJpeg, rasterize(scene), svgPath, svgLastModified, svgHash);
+
+    if (ownsScene)
+        delete scene;
+
+    return jpeg;
+}
+
+
+QByteArray UBSvgSubsetRasterizer::encodeJpeg(QImage image, QString svgPath, QDateTime svgLastModified, QString svgHash)
+{
+    QByteArray jpeg;
+    QBuffer buffer(&jpeg);
+
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "JPG", 100);
+    buffer.close();
+
+    if (!svgHash.isEmpty() && !jpeg.isEmpty())
+    {
+        RasterizedPage* page = new RasterizedPage;
+        page->svgLastModified = svgLastModified;
+        page->svgHash = svgHash;
+        page->jpeg = jpeg;
+
+        QMutexLocker locker(&sRasterizedPagesMutex);
+        sRasterizedPages.insert(svgPath, page, qMax(1, jpeg.size() / 1024));
+    }
+
+    return jpeg;
+}
+
+
+void UBSvgSubsetRasterizer::releasePooledImages()
+{
+    // the compressions still pending keep their own reference
+    sImagePool.clear();
+}
+
+
+/*
+ * The buffers go back to the pool once the jpeg compression releases them, a buffer still
+ * shared with a pending compression is never painted into.
+ */
+QImage& UBSvgSubsetRasterizer::pooledImage(const QSize& size)
+{
+    for (int i = 0; i < sImagePool.count(); i++)
+    {
+        if (sImagePool.at(i).size() == size && sImagePool.at(i).isDetached())
+            return sImagePool[i];
+    }
+
+    if (sImagePool.count() > QThread::idealThreadCount())
+        sImagePool.removeFirst();
+
+    sImagePool << QImage(size, QImage::Format_RGB32);
+
+    return sImagePool.last();
+}
+
+
+QImage UBSvgSubsetRasterizer::rasterize(UBGraphicsScene* scene)
+{
     QRectF sceneRect = scene->normalizedSceneRect();
 
     qreal width = sceneRect.width();
     qreal height = sceneRect.height();
 
-    QImage image(width, height, QImage::Format_ARGB32);
+    // always filled with an opaque background, jpeg has no alpha anyway
+    QImage& image = pooledImage(QSize(width, height));
     QRectF imageRect(0, 0, width, height);
 
     QPainter painter(&image);
@@ -78,9 +222,7 @@ bool UBSvgSubsetRasterizer::rasterizeToFile(const QString& filename)
     scene->setRenderingQuality(UBItem::RenderingQualityNormal);
     scene->setRenderingContext(UBGraphicsScene::Screen);
 
-    bool success = image.save(filename, "JPG", 100);
+    painter.end();
 
-    delete scene;
-
-    return success;
+    return image;
 }
@@ -19,6 +19,7 @@
 #include <QtGui>
 
 class UBDocumentProxy;
+class UBGraphicsScene;
 
 class UBSvgSubsetRasterizer : QObject
 {
@@ -30,10 +31,37 @@ class UBSvgSubsetRasterizer : QObject
 
         bool rasterizeToFile(const QString& filename);
 
+        /*
+         * The page as jpeg, compressed on the thread pool. A page whose svg has not changed
+         * since it was last rasterized gives back that jpeg, already finished.
+         * scene is the page when the caller has it loaded, it is otherwise taken from the scene
+         * cache or from the svg.
+         */
+        QFuture<QByteArray> rasterizeToJpeg(UBGraphicsScene* scene = 0);
+
+        static QImage rasterize(UBGraphicsScene* scene);
+
+        // drops the page buffers kept between rasterizations, once a batch of pages is done
+        static void releasePooledImages();
+
     private:
+        struct RasterizedPage
+        {
+            QDateTime svgLastModified;
+            QString svgHash;
+            QByteArray jpeg;
+        };
+
+        static QByteArray encodeJpeg(QImage image, QString svgPath, QDateTime svgLastModified, QString svgHash);
+        static QImage& pooledImage(const QSize& size);
+
         UBDocumentProxy* mDocument;
         int mPageIndex;
 
+        static QCache<QString, RasterizedPage> sRasterizedPages; // by svg path, cost in kB
+        static QMutex sRasterizedPagesMutex;
+        static QList<QImage> sImagePool;
+
 };
 
 #endif /* UBSVGSUBSETRASTERIZER_H_ */
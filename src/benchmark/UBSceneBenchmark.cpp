@@ -0,0 +1,1660 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UBSceneBenchmark.h"
+
+#include "core/UB.h"
+#include "core/UBApplication.h"
+#include "core/UBSettings.h"
+#include "core/UBPersistenceManager.h"
+#include "core/UBUndoManager.h"
+
+#include "board/UBBoardController.h"
+#include "board/UBBoardView.h"
+#include "board/UBDrawingController.h"
+
+#include "adaptors/UBCFFSubsetAdaptor.h"
+#include "adaptors/UBSvgSubsetAdaptor.h"
+#include "adaptors/UBThumbnailAdaptor.h"
+
+#include "document/UBDocumentProxy.h"
+
+#include "domain/UBGraphicsScene.h"
+#include "domain/UBGraphicsPixmapItem.h"
+#include "domain/UBGraphicsPolygonItem.h"
+#include "domain/UBGraphicsGroupContainerItem.h"
+#include "domain/UBGraphicsItemUndoCommand.h"
+#include "domain/UBGraphicsItemTransformUndoCommand.h"
+
+#include "frameworks/UBFileSystemUtils.h"
+
+#include "tools/UBGraphicsProtractor.h"
+
+#include "podcast/UBAbstractVideoEncoder.h"
+#include "podcast/UBPodcastFramePool.h"
+
+#include "core/memcheck.h"
+
+// the synthetic content only depends on the parameters
+static const uint sRandomSeed = 4242;
+
+static const int sPointsPerStroke = 24;
+static const int sEraserSweeps = 6;
+static const int sEraserMovesPerSweep = 40;
+static const int sDragSteps = 50;
+static const int sSettingsReads = 1000000;
+static const int sCffPageCount = 4;
+static const int sCffShapesPerPage = 200; // split evenly between rect, ellipse, polygon and polyline
+static const int sPhotoCount = 40;
+static const int sPhotoColumnCount = 8;
+static const int sPhotoWidth = 3264; // 12 megapixel camera pictures
+static const int sPhotoHeight = 2448;
+static const int sToolPaintFrames = 100;
+static const int sViewPaintSegments = 200;
+static const qreal sDisplayScale = 0.75; // projector smaller than the control screen
+static const int sHeavyPageSegments = 100000;
+static const int sErasedPageSegments = 50000;
+static const int sGroupRounds = 20;
+static const int sUndoBudgetRemovals = 2000;
+static const int sUndoBudgetImages = 3; // what the budget of the history holds
+static const int sUndoBudgetImageWidth = 1920;
+static const int sUndoBudgetImageHeight = 1080;
+static const int sGroupSize = 3;
+static const int sPodcastFrames = 300;
+static const int sPodcastFrameInterval = 100; // ms, the default 10 frames per second
+static const int sPodcastHeldFrames = 2; // what the encoder still works on when the next frame comes
+
+
+/*
+ * Keeps a reference on the frames it receives as the encoders do while they convert them,
+ * and only counts them.
+ */
+class UBBenchmarkVideoEncoder : public UBAbstractVideoEncoder
+{
+    public:
+
+        UBBenchmarkVideoEncoder()
+            : mEncodedFrameCount(0)
+        {
+            // NOOP
+        }
+
+        virtual bool start() { return true; }
+
+        virtual bool stop() { return true; }
+
+        virtual void newPixmap(const QImage& pImage, long timestamp)
+        {
+            Q_UNUSED(timestamp);
+
+            mHeldFrames.enqueue(pImage);
+
+            if (mHeldFrames.size() > sPodcastHeldFrames)
+                mHeldFrames.dequeue();
+
+            mEncodedFrameCount++;
+        }
+
+        virtual QString videoFileExtension() const { return "none"; }
+
+        virtual QString lastErrorMessage() { return QString(); }
+
+        virtual void setRecordAudio(bool pRecordAudio) { Q_UNUSED(pRecordAudio); }
+
+        int encodedFrameCount() const
+        {
+            return mEncodedFrameCount;
+        }
+
+    private:
+
+        QQueue<QImage> mHeldFrames;
+
+        int mEncodedFrameCount;
+};
+
+
+// the top level objects of the page from the bottom up, what the z order buttons move between
+static QList<QGraphicsItem*> objectsByZ(UBGraphicsScene* pScene)
+{
+    QMultiMap<qreal, QGraphicsItem*> objects;
+
+    foreach(QGraphicsItem* item, pScene->items())
+    {
+        if (!item->parentItem() && item->data(UBGraphicsItemData::itemLayerType).toInt() == itemLayerType::ObjectItem)
+            objects.insert(item->data(UBGraphicsItemData::ItemOwnZValue).toReal(), item);
+    }
+
+    return objects.values();
+}
+
+
+// what the page images hold in memory, each at the level it was last painted at
+static qint64 decodedPixmapBytes(UBGraphicsScene* pScene)
+{
+    qint64 bytes = 0;
+
+    foreach(QGraphicsItem* item, pScene->items())
+    {
+        if (UBGraphicsPixmapItem* pixmapItem = qgraphicsitem_cast<UBGraphicsPixmapItem*>(item))
+        {
+            QPixmap decoded = pixmapItem->decodedPixmap();
+            bytes += qint64(decoded.width()) * decoded.height() * 4;
+        }
+    }
+
+    return bytes;
+}
+
+
+// the colour of the frame at the middle of the item, invalid when another item covers it there,
+// the frame being the whole scene rendered with Qt::KeepAspectRatio
+static QColor renderedItemColor(UBGraphicsScene* pScene, QGraphicsItem* pItem, const QImage& pFrame)
+{
+    QPointF middle = pItem->sceneBoundingRect().center();
+
+    QList<QGraphicsItem*> itemsAtMiddle = pScene->items(middle);
+
+    if (itemsAtMiddle.isEmpty() || itemsAtMiddle.first() != pItem)
+        return QColor();
+
+    QRectF source = pScene->normalizedSceneRect();
+    qreal scale = qMin(pFrame.width() / source.width(), pFrame.height() / source.height());
+    QPointF offset((pFrame.width() - source.width() * scale) / 2, (pFrame.height() - source.height() * scale) / 2);
+
+    QPoint pixel = ((middle - source.topLeft()) * scale + offset).toPoint();
+
+    if (!pFrame.rect().contains(pixel))
+        return QColor();
+
+    return QColor(pFrame.pixel(pixel));
+}
+
+
+UBSceneBenchmark::UBSceneBenchmark(const Parameters& pParameters, QObject *pParent)
+    : QObject(pParent)
+    , mParameters(pParameters)
+    , mDocument(0)
+    , mScene(0)
+    , mPhotoDocument(0)
+    , mHeavyScene(0)
+    , mRecoloredScene(0)
+{
+    // NOOP
+}
+
+
+UBSceneBenchmark::~UBSceneBenchmark()
+{
+    cleanupDocument();
+}
+
+
+void UBSceneBenchmark::run()
+{
+    mMeasures.clear();
+    mFailures.clear();
+    mErasedSegmentsDigest.clear();
+
+    setupDocument();
+
+    measure("save", &UBSceneBenchmark::savePass);
+    measure("load", &UBSceneBenchmark::loadPass);
+    measure("thumbnail", &UBSceneBenchmark::thumbnailPass);
+    measure("render", &UBSceneBenchmark::renderPass);
+    measure("eraser", &UBSceneBenchmark::eraserPass);
+    measure("eraserDeterminism", &UBSceneBenchmark::eraserDeterminismPass);
+    measure("undoDelete", &UBSceneBenchmark::undoDeletePass);
+    measure("undoBudget", &UBSceneBenchmark::undoBudgetPass);
+    measure("groupReorder", &UBSceneBenchmark::groupReorderPass);
+    measure("drag", &UBSceneBenchmark::dragPass);
+    measure("settings", &UBSceneBenchmark::settingsPass);
+    measure("cffImport", &UBSceneBenchmark::cffImportPass);
+    measure("photoPage", &UBSceneBenchmark::photoPagePass);
+    measure("rulerPaint", &UBSceneBenchmark::rulerPaintPass);
+    measure("trianglePaint", &UBSceneBenchmark::trianglePaintPass);
+    measure("protractorPaint", &UBSceneBenchmark::protractorPaintPass);
+    measure("displayPaint", &UBSceneBenchmark::displayPaintPass);
+    measure("sharedDisplayPaint", &UBSceneBenchmark::sharedDisplayPaintPass);
+    measure("recolorItems", &UBSceneBenchmark::recolorItemsPass);
+    measure("backgroundSwitch", &UBSceneBenchmark::backgroundSwitchPass);
+    measure("podcastReplay", &UBSceneBenchmark::podcastReplayPass);
+
+    cleanupDocument();
+}
+
+
+void UBSceneBenchmark::measure(const QString& pName, Pass pPass)
+{
+    Measure result;
+    result.name = pName;
+
+    mCounters.clear();
+
+    for (int i = 0; i < mParameters.warmUpCount; i++)
+        (this->*pPass)();
+
+    for (int i = 0; i < mParameters.repetitionCount; i++)
+        result.samples << (this->*pPass)();
+
+    result.counters = mCounters;
+
+    mMeasures << result;
+}
+
+
+void UBSceneBenchmark::check(bool pCondition, const QString& pFailure)
+{
+    if (!pCondition && !mFailures.contains(pFailure))
+    {
+        qWarning() << "benchmark check failed:" << pFailure;
+        mFailures << pFailure;
+    }
+}
+
+
+void UBSceneBenchmark::setupDocument()
+{
+    cleanupDocument();
+
+    mDocument = new UBDocumentProxy(UBFileSystemUtils::createTempDir("SceneBenchmark"));
+    mScene = new UBGraphicsScene(mDocument);
+
+    addStrokes(mScene);
+    addImages(mScene);
+    addTexts(mScene);
+    addWidgets(mScene);
+
+    // let the widgets start loading before anything is measured
+    QApplication::processEvents();
+}
+
+
+void UBSceneBenchmark::cleanupDocument()
+{
+    delete mScene;
+    mScene = 0;
+
+    delete mHeavyScene;
+    mHeavyScene = 0;
+    mHeavySegments.clear();
+
+    delete mRecoloredScene;
+    mRecoloredScene = 0;
+    mRecoloredSegments.clear();
+
+    if (mDocument)
+    {
+        UBSvgSubsetAdaptor::waitForPendingImages(mDocument->persistencePath());
+        UBFileSystemUtils::deleteDir(mDocument->persistencePath());
+
+        delete mDocument;
+        mDocument = 0;
+    }
+
+    if (mPhotoDocument)
+    {
+        // the image levels may still be generated in the background
+        UBGraphicsPixmapItem::deleteLevels(mPhotoDocument->persistencePath());
+        UBFileSystemUtils::deleteDir(mPhotoDocument->persistencePath());
+
+        delete mPhotoDocument;
+        mPhotoDocument = 0;
+    }
+}
+
+
+QPointF UBSceneBenchmark::randomPoint(const QRectF& pArea) const
+{
+    return QPointF(pArea.left() + pArea.width() * (qrand() % 1000) / 1000.0
+        , pArea.top() + pArea.height() * (qrand() % 1000) / 1000.0);
+}
+
+
+void UBSceneBenchmark::addStrokes(UBGraphicsScene* pScene, int pStylusTool)
+{
+    // the pen keeps the original seed, other tools draw elsewhere on the page
+    qsrand(sRandomSeed + pStylusTool);
+
+    UBDrawingController* drawingController = UBDrawingController::drawingController();
+    int previousTool = drawingController->stylusTool();
+    drawingController->setStylusTool(pStylusTool);
+
+    bool undoEnabled = pScene->isURStackIsEnabled();
+    pScene->setURStackEnable(false);
+
+    QSize nominalSize = pScene->nominalSize();
+    QRectF area(-nominalSize.width() / 2, -nominalSize.height() / 2, nominalSize.width(), nominalSize.height());
+
+    // strokes go through the same input path as the pen does
+    for (int i = 0; i < mParameters.strokeCount; i++)
+    {
+        QPointF point = randomPoint(area);
+        pScene->inputDevicePress(point);
+
+        for (int j = 0; j < sPointsPerStroke; j++)
+        {
+            point += QPointF((qrand() % 41) - 20, (qrand() % 41) - 20);
+            pScene->inputDeviceMove(point, 0.5 + (qrand() % 50) / 100.0);
+        }
+
+        pScene->inputDeviceRelease();
+    }
+
+    pScene->setURStackEnable(undoEnabled);
+    drawingController->setStylusTool(previousTool);
+}
+
+
+void UBSceneBenchmark::addImages(UBGraphicsScene* pScene)
+{
+    qsrand(sRandomSeed + 1);
+
+    QSize nominalSize = pScene->nominalSize();
+    QRectF area(-nominalSize.width() / 2, -nominalSize.height() / 2, nominalSize.width() / 2, nominalSize.height() / 2);
+
+    for (int i = 0; i < mParameters.imageCount; i++)
+    {
+        QImage image(640, 480, QImage::Format_ARGB32_Premultiplied);
+
+        // gradients keep the encoders from taking shortcuts on flat colors
+        QLinearGradient gradient(0, 0, image.width(), image.height());
+        gradient.setColorAt(0, QColor::fromHsv((i * 37) % 360, 200, 230));
+        gradient.setColorAt(1, QColor::fromHsv((i * 37 + 180) % 360, 200, 120));
+
+        QPainter painter(&image);
+        painter.fillRect(image.rect(), gradient);
+        painter.setPen(Qt::white);
+        painter.drawText(image.rect(), Qt::AlignCenter, QString::number(i));
+        painter.end();
+
+        pScene->addPixmap(QPixmap::fromImage(image), 0, randomPoint(area));
+    }
+}
+
+
+void UBSceneBenchmark::addTexts(UBGraphicsScene* pScene)
+{
+    qsrand(sRandomSeed + 2);
+
+    QSize nominalSize = pScene->nominalSize();
+    QRectF area(-nominalSize.width() / 2, -nominalSize.height() / 2, nominalSize.width() * 3 / 4, nominalSize.height() * 3 / 4);
+
+    for (int i = 0; i < mParameters.textCount; i++)
+    {
+        QString text = QString("Text item %1, the quick brown fox jumps over the lazy dog.").arg(i);
+
+        pScene->addTextWithFont(text, randomPoint(area), 12 + i % 24, "", i % 3 == 0, i % 5 == 0);
+    }
+}
+
+
+void UBSceneBenchmark::addWidgets(UBGraphicsScene* pScene)
+{
+    if (mParameters.widgetCount <= 0)
+        return;
+
+    qsrand(sRandomSeed + 3);
+
+    QString widgetPath = UBSettings::settings()->applicationApplicationsLibraryDirectory() + "/Calculatrice.wgt";
+
+    if (!QFileInfo(widgetPath).exists())
+    {
+        qWarning() << "benchmark widget not found" << widgetPath;
+        return;
+    }
+
+    QSize nominalSize = pScene->nominalSize();
+    QRectF area(-nominalSize.width() / 2, -nominalSize.height() / 2, nominalSize.width() / 2, nominalSize.height() / 2);
+
+    for (int i = 0; i < mParameters.widgetCount; i++)
+        pScene->addW3CWidget(QUrl::fromLocalFile(widgetPath), randomPoint(area));
+}
+
+
+void UBSceneBenchmark::addStrokeSegments(UBGraphicsScene* pScene, int pSegmentCount,
+        QList<StrokeSegment>* pSegments, bool pWithColorRoles)
+{
+    qsrand(sRandomSeed + 4);
+
+    // the pen colours and a translucent marker, as dark and light background pairs
+    QList<QPair<QColor, QColor> > colors;
+    colors << qMakePair(QColor(Qt::white), QColor(Qt::black))
+           << qMakePair(QColor(Qt::yellow), QColor(Qt::red))
+           << qMakePair(QColor(Qt::cyan), QColor(Qt::blue))
+           << qMakePair(QColor(Qt::green), QColor(Qt::darkGreen))
+           << qMakePair(QColor(255, 255, 0, 128), QColor(255, 255, 0, 128));
+
+    QSize nominalSize = pScene->nominalSize();
+    QRectF area(-nominalSize.width() / 2, -nominalSize.height() / 2, nominalSize.width(), nominalSize.height());
+
+    QSet<QGraphicsItem*> segments;
+    QPointF point = randomPoint(area);
+
+    for (int i = 0; i < pSegmentCount; i++)
+    {
+        // a new stroke every sPointsPerStroke segments, all segments of a stroke share its colour
+        if (i % sPointsPerStroke == 0)
+            point = randomPoint(area);
+
+        QPointF previous = point;
+        point += QPointF((qrand() % 41) - 20, (qrand() % 41) - 20);
+
+        const QPair<QColor, QColor>& color = colors.at((i / sPointsPerStroke) % colors.size());
+
+        UBGraphicsPolygonItem* segment = new UBGraphicsPolygonItem(QLineF(previous, point), 2 + qrand() % 6);
+        segment->setColor(pScene->isDarkBackground() ? color.first : color.second);
+        if (pWithColorRoles)
+            segment->setColorsOnBackgrounds(color.first, color.second);
+        segment->setData(UBGraphicsItemData::ItemLayerType, QVariant(UBItemLayerType::Graphic));
+
+        segments << segment;
+
+        if (pSegments)
+        {
+            StrokeSegment strokeSegment;
+            strokeSegment.item = segment;
+            strokeSegment.colorOnDarkBackground = color.first;
+            strokeSegment.colorOnLightBackground = color.second;
+
+            *pSegments << strokeSegment;
+        }
+    }
+
+    pScene->addItems(segments);
+}
+
+
+qint64 UBSceneBenchmark::savePass()
+{
+    mScene->setModified(true);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    UBSvgSubsetAdaptor::persistScene(mDocument, mScene, 0);
+
+    return timer.nsecsElapsed();
+}
+
+
+qint64 UBSceneBenchmark::loadPass()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    UBGraphicsScene* scene = UBSvgSubsetAdaptor::loadScene(mDocument, 0);
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    delete scene;
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::thumbnailPass()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    UBThumbnailAdaptor::persistScene(mDocument, mScene, 0, true);
+
+    return timer.nsecsElapsed();
+}
+
+
+qint64 UBSceneBenchmark::renderPass()
+{
+    QImage target(mParameters.renderSize, QImage::Format_ARGB32_Premultiplied);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    target.fill(Qt::white);
+
+    QPainter painter(&target);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    mScene->render(&painter, QRectF(target.rect()), mScene->normalizedSceneRect(), Qt::KeepAspectRatio);
+
+    painter.end();
+
+    return timer.nsecsElapsed();
+}
+
+
+qint64 UBSceneBenchmark::eraserPass()
+{
+    // erasing is destructive, every round starts from the same freshly drawn strokes
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+    addStrokes(scene);
+
+    UBDrawingController* drawingController = UBDrawingController::drawingController();
+    int previousTool = drawingController->stylusTool();
+    drawingController->setStylusTool(UBStylusTool::Eraser);
+
+    QSize nominalSize = scene->nominalSize();
+    QRectF area(-nominalSize.width() / 2, -nominalSize.height() / 2, nominalSize.width(), nominalSize.height());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int sweep = 0; sweep < sEraserSweeps; sweep++)
+    {
+        qreal y = area.top() + area.height() * (sweep + 0.5) / sEraserSweeps;
+
+        scene->inputDevicePress(QPointF(area.left(), y));
+
+        for (int move = 1; move <= sEraserMovesPerSweep; move++)
+            scene->inputDeviceMove(QPointF(area.left() + area.width() * move / sEraserMovesPerSweep, y));
+
+        scene->inputDeviceRelease();
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    drawingController->setStylusTool(previousTool);
+
+    delete scene;
+
+    if (UBApplication::undoStack)
+        UBApplication::undoStack->clear();
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::eraserDeterminismPass()
+{
+    qint64 singleThreadElapsed = 0;
+    qint64 elapsed = 0;
+    int singleThreadRemaining = 0;
+    int remaining = 0;
+
+    QByteArray singleThreadDigest = erasedSegmentsDigest(false, singleThreadElapsed, singleThreadRemaining);
+    QByteArray digest = erasedSegmentsDigest(true, elapsed, remaining);
+
+    if (mErasedSegmentsDigest.isEmpty())
+        mErasedSegmentsDigest = digest;
+
+    check(digest == singleThreadDigest, "eraserDeterminism: the threaded eraser left other polygons than the single threaded one");
+    check(digest == mErasedSegmentsDigest, "eraserDeterminism: two runs left different polygons");
+
+    mCounters.insert("segments", sErasedPageSegments);
+    mCounters.insert("remainingPolygons", remaining);
+    mCounters.insert("singleThreadRemainingPolygons", singleThreadRemaining);
+    mCounters.insert("singleThreadNanoseconds", singleThreadElapsed);
+
+    return elapsed;
+}
+
+
+QByteArray UBSceneBenchmark::erasedSegmentsDigest(bool pUseThreads, qint64& pElapsed, int& pRemainingPolygons)
+{
+    // seeded, the same page every time
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+    scene->setShouldUseOMP(pUseThreads);
+    addStrokeSegments(scene, sErasedPageSegments);
+
+    UBDrawingController* drawingController = UBDrawingController::drawingController();
+    int previousTool = drawingController->stylusTool();
+    drawingController->setStylusTool(UBStylusTool::Eraser);
+
+    QSize nominalSize = scene->nominalSize();
+    QRectF area(-nominalSize.width() / 2, -nominalSize.height() / 2, nominalSize.width(), nominalSize.height());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // horizontal sweeps, then diagonal ones crossing what the first left cut
+    for (int sweep = 0; sweep < 2 * sEraserSweeps; sweep++)
+    {
+        qreal y = area.top() + area.height() * ((sweep % sEraserSweeps) + 0.5) / sEraserSweeps;
+        qreal slope = sweep < sEraserSweeps ? 0 : area.height() / (2 * area.width());
+
+        scene->inputDevicePress(QPointF(area.left(), y));
+
+        for (int move = 1; move <= sEraserMovesPerSweep; move++)
+        {
+            qreal x = area.width() * move / sEraserMovesPerSweep;
+            scene->inputDeviceMove(QPointF(area.left() + x, y + x * slope));
+        }
+
+        scene->inputDeviceRelease();
+    }
+
+    pElapsed = timer.nsecsElapsed();
+
+    drawingController->setStylusTool(previousTool);
+
+    // the remaining polygons regardless of the item order, they must not depend on the threads
+    QList<QByteArray> polygons;
+
+    foreach(QGraphicsItem* item, scene->items())
+    {
+        UBGraphicsPolygonItem* segment = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+
+        if (!segment)
+            continue;
+
+        QByteArray polygon;
+        QDataStream stream(&polygon, QIODevice::WriteOnly);
+        stream << segment->polygon() << segment->zValue();
+
+        polygons << polygon;
+    }
+
+    qSort(polygons);
+
+    QCryptographicHash digest(QCryptographicHash::Sha1);
+
+    foreach(const QByteArray& polygon, polygons)
+        digest.addData(polygon);
+
+    pRemainingPolygons = polygons.size();
+
+    delete scene;
+
+    if (UBApplication::undoStack)
+        UBApplication::undoStack->clear();
+
+    return digest.result();
+}
+
+
+qint64 UBSceneBenchmark::undoDeletePass()
+{
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+    addStrokes(scene);
+
+    // what a select all and delete leaves in the history
+    QSet<QGraphicsItem*> strokes;
+
+    foreach(QGraphicsItem* item, scene->getFastAccessItems())
+    {
+        if (!item->parentItem() && item->isVisible())
+            strokes << item;
+    }
+
+    scene->removeItems(strokes);
+    UBApplication::undoStack->push(new UBGraphicsItemUndoCommand(scene, strokes, QSet<QGraphicsItem*>()));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    UBApplication::undoStack->undo();
+    UBApplication::undoStack->redo();
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    // the scene owns the removed strokes, they go with it
+    UBApplication::undoStack->clear();
+    delete scene;
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::undoBudgetPass()
+{
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+
+    // every image counts for its full size in the history, sharing one pixmap keeps the pass
+    // itself from needing gigabytes if the budget is not enforced
+    QPixmap pixmap(sUndoBudgetImageWidth, sUndoBudgetImageHeight);
+    pixmap.fill(Qt::darkCyan);
+
+    UBGraphicsPixmapItem* firstImage = new UBGraphicsPixmapItem();
+    firstImage->setPixmap(pixmap);
+
+    // room for a few deleted images, the others are collapsed as they come
+    qint64 budget = sUndoBudgetImages * UBUndoManager::estimatedFootprint(firstImage);
+
+    UBUndoManager history;
+    history.setMemoryBudget(budget);
+
+    int overBudgetCount = 0;
+    int maxReferencedItems = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < sUndoBudgetRemovals; i++)
+    {
+        UBGraphicsPixmapItem* image = firstImage;
+
+        if (i > 0)
+        {
+            image = new UBGraphicsPixmapItem();
+            image->setPixmap(pixmap);
+        }
+
+        scene->addItem(image);
+        scene->removeItem(image);
+        history.push(new UBGraphicsItemUndoCommand(scene, image, 0));
+
+        if (history.memoryUsage() > budget)
+            overBudgetCount++;
+
+        maxReferencedItems = qMax(maxReferencedItems, history.referencedItemCount());
+    }
+
+    while (history.canUndo())
+        history.undo();
+
+    // everything left is back on the page
+    qint64 usageAfterUndo = history.memoryUsage();
+
+    while (history.canRedo())
+        history.redo();
+
+    if (history.memoryUsage() > budget)
+        overBudgetCount++;
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    mCounters.insert("deletedImages", sUndoBudgetRemovals);
+    mCounters.insert("keptCommands", history.count());
+    mCounters.insert("budget", budget);
+    mCounters.insert("overBudget", overBudgetCount);
+    mCounters.insert("maxReferencedItems", maxReferencedItems);
+    mCounters.insert("usageAfterUndo", usageAfterUndo);
+
+    check(overBudgetCount == 0, "undoBudget: the history went over its memory budget");
+    check(maxReferencedItems <= sUndoBudgetImages, "undoBudget: the history kept more deleted images than its budget holds");
+    check(usageAfterUndo == 0, "undoBudget: items back on the page are still counted in the history usage");
+
+    // the images the history still holds go back to the scene, which owns them
+    while (history.canUndo())
+        history.undo();
+
+    history.clear();
+    delete scene;
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::groupReorderPass()
+{
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+    addImages(scene);
+    addTexts(scene);
+
+    qsrand(sRandomSeed + 6);
+
+    qint64 elapsed = 0;
+    int mismatchCount = reorderMismatches(scene, elapsed);
+
+    for (int round = 0; round < sGroupRounds; round++)
+    {
+        QList<QGraphicsItem*> objects = objectsByZ(scene);
+        QList<QGraphicsItem*> members;
+
+        while (members.size() < qMin(sGroupSize, objects.size()))
+            members << objects.takeAt(qrand() % objects.size());
+
+        QElapsedTimer timer;
+        timer.start();
+
+        UBGraphicsGroupContainerItem* group = scene->createGroup(members);
+
+        elapsed += timer.nsecsElapsed();
+
+        mismatchCount += reorderMismatches(scene, elapsed);
+
+        // every other group is kept, later groups may then take it in
+        if (round % 2 == 0)
+        {
+            timer.start();
+
+            group->destroy();
+
+            elapsed += timer.nsecsElapsed();
+
+            mismatchCount += reorderMismatches(scene, elapsed);
+        }
+    }
+
+    mCounters.insert("groups", sGroupRounds);
+    mCounters.insert("mismatches", mismatchCount);
+
+    check(mismatchCount == 0, "groupReorder: an object did not end up where the z order button puts it");
+
+    delete scene;
+
+    if (UBApplication::undoStack)
+        UBApplication::undoStack->clear();
+
+    return elapsed;
+}
+
+
+int UBSceneBenchmark::reorderMismatches(UBGraphicsScene* pScene, qint64& pElapsed)
+{
+    int mismatchCount = 0;
+
+    QList<UBZLayerController::moveDestination> destinations;
+    destinations << UBZLayerController::up << UBZLayerController::down
+                 << UBZLayerController::top << UBZLayerController::bottom;
+
+    foreach(UBZLayerController::moveDestination destination, destinations)
+    {
+        QList<QGraphicsItem*> objects = objectsByZ(pScene);
+
+        if (objects.isEmpty())
+            break;
+
+        int rank = qrand() % objects.size();
+        QGraphicsItem* item = objects.at(rank);
+
+        int expectedRank = rank;
+
+        if (destination == UBZLayerController::up)
+            expectedRank = qMin(rank + 1, objects.size() - 1);
+        else if (destination == UBZLayerController::down)
+            expectedRank = qMax(rank - 1, 0);
+        else if (destination == UBZLayerController::top)
+            expectedRank = objects.size() - 1;
+        else
+            expectedRank = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        pScene->changeZLevelTo(item, destination);
+
+        pElapsed += timer.nsecsElapsed();
+
+        if (objectsByZ(pScene).indexOf(item) != expectedRank)
+            mismatchCount++;
+    }
+
+    return mismatchCount;
+}
+
+
+qint64 UBSceneBenchmark::dragPass()
+{
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+    addImages(scene);
+
+    QList<QGraphicsItem*> selection;
+
+    foreach(QGraphicsItem* item, scene->getFastAccessItems())
+    {
+        if (!item->parentItem() && item->isVisible())
+        {
+            item->setSelected(true);
+            selection << item;
+        }
+    }
+
+    QList<QPointF> startPositions;
+
+    foreach(QGraphicsItem* item, selection)
+        startPositions << item->pos();
+
+    UBApplication::undoStack->clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // every selected item commits its own undo step at the end of each small move
+    for (int step = 0; step < sDragSteps; step++)
+    {
+        foreach(QGraphicsItem* item, selection)
+        {
+            QPointF previousPosition = item->pos();
+            item->moveBy(3, 2);
+
+            UBApplication::undoStack->push(new UBGraphicsItemTransformUndoCommand(item, previousPosition
+                    , item->transform(), item->zValue()));
+        }
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    int undoEntries = UBApplication::undoStack->count();
+
+    // a move the history did not record must not shift where undo puts the items back
+    if (!selection.isEmpty())
+        selection.first()->moveBy(7, 5);
+
+    UBApplication::undoStack->undo();
+
+    int misplacedItems = 0;
+
+    for (int i = 0; i < selection.size(); i++)
+    {
+        if (selection.at(i)->pos() != startPositions.at(i))
+            misplacedItems++;
+    }
+
+    mCounters.insert("items", selection.size());
+    mCounters.insert("commits", selection.size() * sDragSteps);
+    mCounters.insert("undoEntries", undoEntries);
+
+    check(undoEntries == 1, "drag: the moves of the selection did not merge into one undo step");
+    check(misplacedItems == 0, "drag: undo did not put the dragged items back where they started");
+
+    UBApplication::undoStack->clear();
+    delete scene;
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::settingsPass()
+{
+    // the getters the drawing tools call on every input event
+    UBSettings* settings = UBSettings::settings();
+
+    volatile qreal sink = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < sSettingsReads; i++)
+    {
+        sink = sink + settings->currentPenWidth();
+        sink = sink + settings->currentEraserWidth();
+        sink = sink + (settings->isDarkBackground() ? 1 : 0);
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    // too cheap for whole nanoseconds
+    mCounters.insert("calls", 3 * sSettingsReads);
+    mCounters.insert("picosecondsPerCall", elapsed * 1000 / (3 * sSettingsReads));
+
+    return elapsed;
+}
+
+
+void UBSceneBenchmark::writeCffDocument(const QString& pPath)
+{
+    QFile file(pPath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "cannot write benchmark IWB document to" << pPath;
+        return;
+    }
+
+    const QString svgNamespace = "http://www.w3.org/2000/svg";
+    const QString iwbNamespace = "http://www.becta.org.uk/iwb";
+
+    QRectF area(0, 0, 1000, 750);
+
+    qsrand(sRandomSeed);
+
+    QXmlStreamWriter writer(&file);
+    writer.setAutoFormatting(true);
+    writer.writeStartDocument();
+
+    writer.writeDefaultNamespace(iwbNamespace);
+    writer.writeStartElement(iwbNamespace, "iwb");
+
+    writer.writeDefaultNamespace(svgNamespace);
+    writer.writeStartElement(svgNamespace, "svg");
+    writer.writeAttribute("width", QString::number(area.width()));
+    writer.writeAttribute("height", QString::number(area.height()));
+    writer.writeAttribute("viewbox", QString("%1 %2 %3 %4").arg(area.left()).arg(area.top()).arg(area.width()).arg(area.height()));
+
+    writer.writeStartElement(svgNamespace, "pageset");
+
+    for (int page = 0; page < sCffPageCount; page++)
+    {
+        writer.writeStartElement(svgNamespace, "page");
+
+        for (int i = 0; i < sCffShapesPerPage; i++)
+        {
+            QPointF origin = randomPoint(area.adjusted(0, 0, -100, -100));
+            QString fill = QString("rgb(%1,%2,%3)").arg(qrand() % 256).arg(qrand() % 256).arg(qrand() % 256);
+            QString stroke = QString("rgb(%1,%2,%3)").arg(qrand() % 256).arg(qrand() % 256).arg(qrand() % 256);
+            QString strokeWidth = QString::number(1 + qrand() % 6);
+
+            QStringList points;
+            for (int j = 0; j < 6; j++)
+            {
+                QPointF point = origin + randomPoint(QRectF(0, 0, 100, 100));
+                points << QString("%1,%2").arg(point.x()).arg(point.y());
+            }
+
+            switch (i % 4)
+            {
+                case 0:
+                    writer.writeStartElement(svgNamespace, "rect");
+                    writer.writeAttribute("x", QString::number(origin.x()));
+                    writer.writeAttribute("y", QString::number(origin.y()));
+                    writer.writeAttribute("width", QString::number(20 + qrand() % 80));
+                    writer.writeAttribute("height", QString::number(20 + qrand() % 80));
+                    writer.writeAttribute("fill", fill);
+                    break;
+                case 1:
+                    writer.writeStartElement(svgNamespace, "ellipse");
+                    writer.writeAttribute("cx", QString::number(origin.x() + 50));
+                    writer.writeAttribute("cy", QString::number(origin.y() + 50));
+                    writer.writeAttribute("rx", QString::number(10 + qrand() % 40));
+                    writer.writeAttribute("ry", QString::number(10 + qrand() % 40));
+                    writer.writeAttribute("fill", fill);
+                    break;
+                case 2:
+                    writer.writeStartElement(svgNamespace, "polygon");
+                    writer.writeAttribute("points", points.join(" "));
+                    writer.writeAttribute("fill", fill);
+                    break;
+                default:
+                    writer.writeStartElement(svgNamespace, "polyline");
+                    writer.writeAttribute("points", points.join(" "));
+                    break;
+            }
+
+            writer.writeAttribute("stroke", stroke);
+            writer.writeAttribute("stroke-width", strokeWidth);
+            writer.writeEndElement();
+        }
+
+        writer.writeEndElement(); // page
+    }
+
+    writer.writeEndElement(); // pageset
+    writer.writeEndElement(); // svg
+    writer.writeEndElement(); // iwb
+
+    writer.writeEndDocument();
+}
+
+
+qint64 UBSceneBenchmark::cffImportPass()
+{
+    QString sourceDir = UBFileSystemUtils::createTempDir("SceneBenchmarkCff");
+    QString sourcePath = sourceDir + "/content.xml";
+
+    writeCffDocument(sourcePath);
+
+    UBDocumentProxy* document = new UBDocumentProxy(UBFileSystemUtils::createTempDir("SceneBenchmarkCffDocument"));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool imported = UBCFFSubsetAdaptor::ConvertCFFFileToUbz(sourcePath, document);
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    mCounters.insert("imported", imported ? 1 : 0);
+    mCounters.insert("pages", document->pageCount());
+    mCounters.insert("shapes", sCffPageCount * sCffShapesPerPage);
+    mCounters.insert("microsecondsPerPage", elapsed / 1000 / qMax(1, document->pageCount()));
+
+    // drops the cached scenes and the persisted pages along with the proxy
+    UBPersistenceManager::persistenceManager()->deleteDocument(document);
+    UBFileSystemUtils::deleteDir(sourceDir);
+
+    return elapsed;
+}
+
+
+void UBSceneBenchmark::writePhotoDocument()
+{
+    mPhotoDocument = new UBDocumentProxy(UBFileSystemUtils::createTempDir("SceneBenchmarkPhotos"));
+
+    UBGraphicsScene* scene = new UBGraphicsScene(mPhotoDocument);
+
+    QSize nominalSize = scene->nominalSize();
+    int rowCount = (sPhotoCount + sPhotoColumnCount - 1) / sPhotoColumnCount;
+    qreal cellWidth = (qreal)nominalSize.width() / sPhotoColumnCount;
+    qreal cellHeight = (qreal)nominalSize.height() / rowCount;
+    qreal scaleFactor = qMin(cellWidth / sPhotoWidth, cellHeight / sPhotoHeight);
+
+    for (int i = 0; i < sPhotoCount; i++)
+    {
+        QImage image(sPhotoWidth, sPhotoHeight, QImage::Format_RGB32);
+
+        QLinearGradient gradient(0, 0, image.width(), image.height());
+        gradient.setColorAt(0, QColor::fromHsv((i * 37) % 360, 200, 230));
+        gradient.setColorAt(1, QColor::fromHsv((i * 37 + 180) % 360, 200, 120));
+
+        QPainter painter(&image);
+        painter.fillRect(image.rect(), gradient);
+        painter.setPen(QPen(Qt::white, 40));
+        painter.drawEllipse(image.rect().adjusted(200, 200, -200, -200));
+        painter.end();
+
+        QByteArray jpeg;
+        QBuffer buffer(&jpeg);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "JPEG", 90);
+
+        QPointF center(-nominalSize.width() / 2 + cellWidth * (i % sPhotoColumnCount + 0.5)
+            , -nominalSize.height() / 2 + cellHeight * (i / sPhotoColumnCount + 0.5));
+
+        UBGraphicsPixmapItem* pixmapItem = scene->addPixmap(QPixmap::fromImage(image), 0, center, scaleFactor);
+        pixmapItem->setOriginalData(jpeg, "jpeg");
+    }
+
+    UBSvgSubsetAdaptor::persistScene(mPhotoDocument, scene, 0);
+
+    if (UBApplication::undoStack)
+        UBApplication::undoStack->clear();
+
+    delete scene;
+
+    // a first load schedules the generation of the image levels, the passes use them
+    delete UBSvgSubsetAdaptor::loadScene(mPhotoDocument, 0);
+    QThreadPool::globalInstance()->waitForDone();
+}
+
+
+qint64 UBSceneBenchmark::photoPagePass()
+{
+    if (!mPhotoDocument)
+        writePhotoDocument();
+
+    QImage target(mParameters.renderSize, QImage::Format_ARGB32_Premultiplied);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // the images are only decoded once painted, the first render is part of loading the page
+    UBGraphicsScene* scene = UBSvgSubsetAdaptor::loadScene(mPhotoDocument, 0);
+
+    qint64 loaded = timer.nsecsElapsed();
+
+    target.fill(Qt::white);
+
+    QPainter painter(&target);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    scene->render(&painter, QRectF(target.rect()), scene->normalizedSceneRect(), Qt::KeepAspectRatio);
+
+    painter.end();
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    qint64 decodedBytes = decodedPixmapBytes(scene);
+
+    // zooming in on one photo decodes its full resolution, zooming back out must give it up
+    QGraphicsItem* zoomedItem = 0;
+
+    foreach(QGraphicsItem* item, scene->items())
+    {
+        if (qgraphicsitem_cast<UBGraphicsPixmapItem*>(item))
+        {
+            zoomedItem = item;
+            break;
+        }
+    }
+
+    qint64 zoomedInBytes = 0;
+
+    if (zoomedItem)
+    {
+        target.fill(Qt::white);
+        painter.begin(&target);
+        scene->render(&painter, QRectF(target.rect()), zoomedItem->sceneBoundingRect(), Qt::KeepAspectRatio);
+        painter.end();
+
+        zoomedInBytes = decodedPixmapBytes(scene);
+
+        target.fill(Qt::white);
+        painter.begin(&target);
+        scene->render(&painter, QRectF(target.rect()), scene->normalizedSceneRect(), Qt::KeepAspectRatio);
+        painter.end();
+    }
+
+    qint64 zoomedOutBytes = decodedPixmapBytes(scene);
+
+    check(zoomedInBytes > decodedBytes, "zooming in on a photo did not decode a finer level");
+    check(zoomedOutBytes == decodedBytes, "zooming back out kept the finer level of a photo");
+
+    mCounters.insert("photos", sPhotoCount);
+    mCounters.insert("loadNanoseconds", loaded);
+    mCounters.insert("decodedBytes", decodedBytes);
+    mCounters.insert("zoomedInDecodedBytes", zoomedInBytes);
+    mCounters.insert("fullResolutionBytes", qint64(sPhotoCount) * sPhotoWidth * sPhotoHeight * 4);
+
+    delete scene;
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::paintTool(AddTool pAddTool)
+{
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+    (scene->*pAddTool)(QPointF(0, 0));
+
+    QGraphicsItem* tool = scene->tools().values().value(0);
+
+    if (!tool)
+    {
+        delete scene;
+        return 0;
+    }
+
+    // large enough for every rotation of the tool
+    QRectF bounds = tool->sceneBoundingRect();
+    qreal side = qMax(bounds.width(), bounds.height()) * 1.5;
+    QRectF source(bounds.center().x() - side / 2, bounds.center().y() - side / 2, side, side);
+
+    tool->setTransformOriginPoint(tool->boundingRect().center());
+
+    // the protractor is rotated by its start angle, what dragging its rotate button changes
+    UBGraphicsProtractor* protractor = qgraphicsitem_cast<UBGraphicsProtractor*>(tool);
+
+    QImage target(mParameters.renderSize, QImage::Format_ARGB32_Premultiplied);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int frame = 0; frame < sToolPaintFrames; frame++)
+    {
+        if (protractor)
+            protractor->setAngle(frame * 360. / sToolPaintFrames);
+        else
+            tool->setRotation(frame * 360. / sToolPaintFrames);
+
+        target.fill(0); // transparent
+
+        QPainter painter(&target);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+
+        scene->render(&painter, QRectF(target.rect()), source, Qt::KeepAspectRatio);
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    mCounters.insert("frames", sToolPaintFrames);
+    mCounters.insert("nanosecondsPerFrame", elapsed / sToolPaintFrames);
+
+    delete scene;
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::rulerPaintPass()
+{
+    return paintTool(&UBGraphicsScene::addRuler);
+}
+
+
+qint64 UBSceneBenchmark::trianglePaintPass()
+{
+    return paintTool(&UBGraphicsScene::addTriangle);
+}
+
+
+qint64 UBSceneBenchmark::protractorPaintPass()
+{
+    return paintTool(&UBGraphicsScene::addProtractor);
+}
+
+
+qint64 UBSceneBenchmark::paintViews(bool pShareRendering)
+{
+    UBGraphicsScene* scene = new UBGraphicsScene(mDocument);
+    addStrokes(scene);
+
+    // translucent highlighter strokes are shared with the display like the opaque ones
+    addStrokes(scene, UBStylusTool::Marker);
+
+    UBBoardView controlView(UBApplication::boardController, 0, true);
+    UBBoardView displayView(UBApplication::boardController, UBItemLayerType::FixedBackground, UBItemLayerType::Tool, 0);
+
+    QSize displaySize = mParameters.renderSize * sDisplayScale;
+
+    controlView.resize(mParameters.renderSize);
+    displayView.resize(displaySize);
+    displayView.scale(sDisplayScale, sDisplayScale);
+
+    controlView.setScene(scene);
+    displayView.setScene(scene);
+
+    if (pShareRendering)
+        displayView.setRenderingSource(&controlView);
+
+    // visible for the views, never on screen
+    controlView.setAttribute(Qt::WA_DontShowOnScreen);
+    displayView.setAttribute(Qt::WA_DontShowOnScreen);
+    controlView.show();
+    displayView.show();
+
+    QImage controlFrame(mParameters.renderSize, QImage::Format_ARGB32_Premultiplied);
+    QImage displayFrame(displaySize, QImage::Format_ARGB32_Premultiplied);
+
+    // both views start from a full frame, then only the stroke damage is painted
+    controlView.viewport()->render(&controlFrame);
+    displayView.viewport()->render(&displayFrame);
+
+    controlView.resetFrameStatistics();
+    displayView.resetFrameStatistics();
+
+    UBDrawingController* drawingController = UBDrawingController::drawingController();
+    int previousTool = drawingController->stylusTool();
+    drawingController->setStylusTool(UBStylusTool::Pen);
+
+    bool undoEnabled = scene->isURStackIsEnabled();
+    scene->setURStackEnable(false);
+
+    QPointF point(0, 0);
+    scene->inputDevicePress(point);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < sViewPaintSegments; i++)
+    {
+        QPointF previous = point;
+        point += QPointF((qrand() % 41) - 20, (qrand() % 41) - 20);
+
+        scene->inputDeviceMove(point, 1.0);
+
+        QRectF damage = QRectF(previous, point).normalized().adjusted(-20, -20, 20, 20);
+
+        QRect controlDamage = controlView.mapFromScene(damage).boundingRect();
+        controlView.viewport()->render(&controlFrame, controlDamage.topLeft(), QRegion(controlDamage));
+
+        QRect displayDamage = displayView.mapFromScene(damage).boundingRect();
+        displayView.viewport()->render(&displayFrame, displayDamage.topLeft(), QRegion(displayDamage));
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    scene->inputDeviceRelease();
+    scene->setURStackEnable(undoEnabled);
+    drawingController->setStylusTool(previousTool);
+
+    mCounters.insert("segments", sViewPaintSegments);
+    mCounters.insert("controlNanosecondsPerFrame", controlView.frameTime() / qMax(1, controlView.frameCount()));
+    mCounters.insert("displayNanosecondsPerFrame", displayView.frameTime() / qMax(1, displayView.frameCount()));
+
+    displayView.setRenderingSource(0);
+    displayView.setScene(0);
+    controlView.setScene(0);
+
+    delete scene;
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::displayPaintPass()
+{
+    return paintViews(false);
+}
+
+
+qint64 UBSceneBenchmark::sharedDisplayPaintPass()
+{
+    return paintViews(true);
+}
+
+
+qint64 UBSceneBenchmark::switchBackground(bool pRecolorItems)
+{
+    UBGraphicsScene*& scene = pRecolorItems ? mRecoloredScene : mHeavyScene;
+    QList<StrokeSegment>& segments = pRecolorItems ? mRecoloredSegments : mHeavySegments;
+
+    if (!scene)
+    {
+        // before the stroke palette the segments had no colour roles, only their brush
+        scene = new UBGraphicsScene(mDocument);
+        addStrokeSegments(scene, sHeavyPageSegments, &segments, !pRecolorItems);
+    }
+
+    bool isDark = !scene->isDarkBackground();
+
+    QImage target(mParameters.renderSize, QImage::Format_ARGB32_Premultiplied);
+
+    // the switch is only over once the page shows the new colours, a frame is painted after it
+    QElapsedTimer timer;
+    timer.start();
+
+    scene->setBackground(isDark, false);
+
+    if (pRecolorItems)
+    {
+        // what the scene did before the stroke palette, views stop updating while every
+        // segment gets its new brush
+        QMap<QGraphicsView*, QGraphicsView::ViewportUpdateMode> previousUpdateModes;
+        foreach(QGraphicsView* view, scene->views())
+        {
+            previousUpdateModes.insert(view, view->viewportUpdateMode());
+            view->setViewportUpdateMode(QGraphicsView::NoViewportUpdate);
+        }
+
+        foreach(const StrokeSegment& segment, segments)
+            segment.item->setColor(isDark ? segment.colorOnDarkBackground : segment.colorOnLightBackground);
+
+        foreach(QGraphicsView* view, scene->views())
+            view->setViewportUpdateMode(previousUpdateModes.value(view));
+    }
+
+    target.fill(isDark ? Qt::black : Qt::white);
+
+    QPainter painter(&target);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    scene->render(&painter, QRectF(target.rect()), scene->normalizedSceneRect(), Qt::KeepAspectRatio);
+
+    painter.end();
+
+    qint64 elapsed = timer.nsecsElapsed();
+
+    // wide opaque segments nothing covers show their colour for the new background
+    int sampledSegments = 0;
+
+    foreach(const StrokeSegment& segment, segments)
+    {
+        QColor expected = isDark ? segment.colorOnDarkBackground : segment.colorOnLightBackground;
+
+        if (segment.item->originalWidth() < 5 || segment.item->originalLine().length() < segment.item->originalWidth()
+                || expected.alpha() != 255)
+            continue;
+
+        QColor rendered = renderedItemColor(scene, segment.item, target);
+
+        if (!rendered.isValid())
+            continue;
+
+        check(qAbs(rendered.red() - expected.red()) <= 2
+                && qAbs(rendered.green() - expected.green()) <= 2
+                && qAbs(rendered.blue() - expected.blue()) <= 2,
+                QString("segment painted %1 instead of %2 on the %3 background")
+                    .arg(rendered.name()).arg(expected.name()).arg(isDark ? "dark" : "light"));
+
+        if (++sampledSegments == 20)
+            break;
+    }
+
+    check(sampledSegments > 0, "no uncovered segment to sample after the background switch");
+
+    mCounters.insert("segments", sHeavyPageSegments);
+    mCounters.insert("sampledSegments", sampledSegments);
+
+    return elapsed;
+}
+
+
+qint64 UBSceneBenchmark::recolorItemsPass()
+{
+    return switchBackground(true);
+}
+
+
+qint64 UBSceneBenchmark::backgroundSwitchPass()
+{
+    return switchBackground(false);
+}
+
+
+qint64 UBSceneBenchmark::podcastReplayPass()
+{
+    qsrand(sRandomSeed + 5);
+
+    UBPodcastFramePool framePool;
+    framePool.reset(mParameters.renderSize, QImage::Format_RGB32);
+    framePool.fill(Qt::white);
+
+    UBBenchmarkVideoEncoder encoder;
+
+    // the same sequence painted on a single image, what every sent frame must look like
+    QImage expected(mParameters.renderSize, QImage::Format_RGB32);
+    expected.fill(QColor(Qt::white).rgb());
+
+    QRectF frameArea(framePool.frameRect());
+
+    int mismatchCount = 0;
+    qint64 elapsed = 0;
+
+    for (int i = 0; i < sPodcastFrames; i++)
+    {
+        // one tick in four has nothing new, like when the teacher talks
+        QRect changedRect;
+
+        if (qrand() % 4 != 0)
+            changedRect = QRectF(randomPoint(frameArea), QSizeF(8 + qrand() % 120, 8 + qrand() % 60)).toAlignedRect();
+
+        QColor color = QColor::fromRgb(qrand() % 256, qrand() % 256, qrand() % 256);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QRegion damage;
+
+        if (!changedRect.isEmpty())
+        {
+            QImage& frame = framePool.beginFrame();
+
+            {
+                QPainter p(&frame);
+                p.fillRect(changedRect, color);
+            }
+
+            damage = changedRect.intersected(framePool.frameRect());
+            framePool.endFrame(damage);
+        }
+
+        encoder.newFrame(framePool.latestFrame(), damage, i * sPodcastFrameInterval);
+
+        elapsed += timer.nsecsElapsed();
+
+        if (!changedRect.isEmpty())
+        {
+            QPainter p(&expected);
+            p.fillRect(changedRect, color);
+        }
+
+        if (framePool.latestFrame() != expected)
+            mismatchCount++;
+    }
+
+    mCounters.insert("frames", sPodcastFrames);
+    mCounters.insert("encodedFrames", encoder.encodedFrameCount());
+    mCounters.insert("allocations", framePool.allocationCount());
+    mCounters.insert("mismatches", mismatchCount);
+
+    check(mismatchCount == 0, "podcastReplay: a sent frame differs from the painted sequence");
+    check(framePool.allocationCount() == framePool.capacity(), "podcastReplay: the frame pool allocated while the encoder kept up");
+    check(encoder.encodedFrameCount() < sPodcastFrames, "podcastReplay: duplicate frames reached the encoder");
+
+    return elapsed;
+}
+
+
+QString UBSceneBenchmark::toJson() const
+{
+    QString json;
+    QTextStream out(&json);
+
+    out << "{\n";
+    out << "  \"version\": \"" << QCoreApplication::applicationVersion() << "\",\n";
+    out << "  \"idealThreadCount\": " << QThread::idealThreadCount() << ",\n";
+    out << "  \"parameters\": {\n";
+    out << "    \"strokes\": " << mParameters.strokeCount << ",\n";
+    out << "    \"images\": " << mParameters.imageCount << ",\n";
+    out << "    \"texts\": " << mParameters.textCount << ",\n";
+    out << "    \"widgets\": " << mParameters.widgetCount << ",\n";
+    out << "    \"warmUps\": " << mParameters.warmUpCount << ",\n";
+    out << "    \"repetitions\": " << mParameters.repetitionCount << ",\n";
+    out << "    \"renderWidth\": " << mParameters.renderSize.width() << ",\n";
+    out << "    \"renderHeight\": " << mParameters.renderSize.height() << "\n";
+    out << "  },\n";
+    out << "  \"results\": [";
+
+    for (int i = 0; i < mMeasures.size(); i++)
+    {
+        const Measure& measure = mMeasures.at(i);
+
+        QList<qint64> sorted = measure.samples;
+        qSort(sorted);
+
+        qint64 total = 0;
+        QStringList samples;
+
+        foreach(qint64 sample, measure.samples)
+        {
+            total += sample;
+            samples << QString::number(sample / 1000000.0, 'f', 3);
+        }
+
+        double min = sorted.isEmpty() ? 0 : sorted.first() / 1000000.0;
+        double max = sorted.isEmpty() ? 0 : sorted.last() / 1000000.0;
+        double median = sorted.isEmpty() ? 0 : sorted.at(sorted.size() / 2) / 1000000.0;
+        double mean = sorted.isEmpty() ? 0 : total / 1000000.0 / sorted.size();
+
+        out << (i > 0 ? ",\n" : "\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << measure.name << "\",\n";
+        out << "      \"unit\": \"ms\",\n";
+        out << "      \"min\": " << QString::number(min, 'f', 3) << ",\n";
+        out << "      \"median\": " << QString::number(median, 'f', 3) << ",\n";
+        out << "      \"mean\": " << QString::number(mean, 'f', 3) << ",\n";
+        out << "      \"max\": " << QString::number(max, 'f', 3) << ",\n";
+        out << "      \"samples\": [" << samples.join(", ") << "]";
+
+        if (!measure.counters.isEmpty())
+        {
+            QStringList counters;
+
+            foreach(const QString& counter, measure.counters.keys())
+                counters << QString("\"%1\": %2").arg(counter).arg(measure.counters.value(counter));
+
+            out << ",\n      \"counters\": {" << counters.join(", ") << "}";
+        }
+
+        out << "\n";
+        out << "    }";
+    }
+
+    out << "\n  ],\n";
+
+    QStringList failures;
+
+    foreach(const QString& failure, mFailures)
+        failures << "\"" + failure + "\"";
+
+    out << "  \"failures\": [" << failures.join(", ") << "]\n";
+    out << "}\n";
+
+    out.flush();
+
+    return json;
+}
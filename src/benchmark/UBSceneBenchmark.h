@@ -0,0 +1,194 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UBSCENEBENCHMARK_H_
+#define UBSCENEBENCHMARK_H_
+
+#include <QtGui>
+
+#include "core/UB.h"
+
+class UBDocumentProxy;
+class UBGraphicsScene;
+class UBGraphicsPolygonItem;
+
+/*
+ * Times the scene hot paths (load, save, thumbnail, full render, eraser, undo and drag) on a
+ * synthetic document, so changes to them can be compared from one build to the next. The
+ * eraser also sweeps a page of fifty thousand stroke segments single and multi threaded,
+ * checking every run leaves exactly the same polygons. Thousands of large images are deleted one by one past the undo
+ * memory budget, the history having to stay within it and to keep only the few images it holds. Objects are grouped, reordered and ungrouped, every new z order
+ * being checked against the order of the page items. The settings getters the drawing tools
+ * read on every input event are timed as well, and so is
+ * the import of a synthetic IWB (CFF) file made of vector shapes. A page of large photos is
+ * loaded and rendered to compare what its images take in memory with their full resolution.
+ * The ruler, triangle and protractor are repainted while they rotate, as when dragged.
+ * A pen stroke is painted on a control and a display view of a page heavy with pen and
+ * highlighter strokes, with the display painting on its own then from the control view's rendering.
+ * A page of a hundred thousand stroke segments switches between light and dark background,
+ * once recolouring every segment of a page without colour roles as the scene used to and once
+ * through the stroke palette, the new frame having to show the strokes in their new colours.
+ * A recorded podcast frame sequence is replayed through the frame pool to an encoder that
+ * holds on to its last frames, every frame is compared with the same sequence painted directly.
+ *
+ * Besides timings, the passes check what they produced, a failed check is listed in the
+ * results and makes the run fail.
+ *
+ * Every pass runs a few untimed warm-up rounds then the measured repetitions, only
+ * the work under test is inside the timed section. Results are reported as JSON.
+ */
+class UBSceneBenchmark : public QObject
+{
+    Q_OBJECT;
+
+    public:
+
+        struct Parameters
+        {
+            Parameters()
+                : strokeCount(200)
+                , imageCount(10)
+                , textCount(20)
+                , widgetCount(2)
+                , warmUpCount(2)
+                , repetitionCount(10)
+                , renderSize(1920, 1080)
+            {
+                // NOOP
+            }
+
+            int strokeCount;
+            int imageCount;
+            int textCount;
+            int widgetCount;
+
+            int warmUpCount;
+            int repetitionCount;
+
+            QSize renderSize;
+        };
+
+        UBSceneBenchmark(const Parameters& pParameters, QObject *pParent = 0);
+        virtual ~UBSceneBenchmark();
+
+        void run();
+
+        QString toJson() const;
+
+        bool hasFailed() const
+        {
+            return !mFailures.isEmpty();
+        }
+
+    private:
+
+        struct Measure
+        {
+            QString name;
+            QList<qint64> samples; // nanoseconds
+
+            // what the pass reports besides time, from its last run
+            QMap<QString, qint64> counters;
+        };
+
+        // a stroke segment and its pen colours for both backgrounds
+        struct StrokeSegment
+        {
+            UBGraphicsPolygonItem* item;
+            QColor colorOnDarkBackground;
+            QColor colorOnLightBackground;
+        };
+
+        typedef qint64 (UBSceneBenchmark::*Pass)();
+
+        void measure(const QString& pName, Pass pPass);
+
+        void check(bool pCondition, const QString& pFailure);
+
+        void setupDocument();
+        void cleanupDocument();
+
+        void addStrokes(UBGraphicsScene* pScene, int pStylusTool = UBStylusTool::Pen);
+        void addImages(UBGraphicsScene* pScene);
+        void addTexts(UBGraphicsScene* pScene);
+        void addWidgets(UBGraphicsScene* pScene);
+        // without colour roles the segments keep the brush they are given, as before the stroke palette
+        void addStrokeSegments(UBGraphicsScene* pScene, int pSegmentCount,
+                QList<StrokeSegment>* pSegments = 0, bool pWithColorRoles = true);
+
+        QPointF randomPoint(const QRectF& pArea) const;
+
+        qint64 savePass();
+        qint64 loadPass();
+        qint64 thumbnailPass();
+        qint64 renderPass();
+        qint64 eraserPass();
+        qint64 eraserDeterminismPass();
+        qint64 undoDeletePass();
+        qint64 undoBudgetPass();
+        qint64 groupReorderPass();
+        qint64 dragPass();
+        qint64 settingsPass();
+        qint64 cffImportPass();
+        qint64 photoPagePass();
+        qint64 rulerPaintPass();
+        qint64 trianglePaintPass();
+        qint64 protractorPaintPass();
+        qint64 displayPaintPass();
+        qint64 sharedDisplayPaintPass();
+        qint64 recolorItemsPass();
+        qint64 backgroundSwitchPass();
+        qint64 podcastReplayPass();
+
+        typedef void (UBGraphicsScene::*AddTool)(QPointF);
+        qint64 paintTool(AddTool pAddTool);
+
+        qint64 paintViews(bool pShareRendering);
+
+        int reorderMismatches(UBGraphicsScene* pScene, qint64& pElapsed);
+
+        // digest of the polygons left by the eraser sweeps over a fresh seeded page
+        QByteArray erasedSegmentsDigest(bool pUseThreads, qint64& pElapsed, int& pRemainingPolygons);
+
+        qint64 switchBackground(bool pRecolorItems);
+
+        void writeCffDocument(const QString& pPath);
+        void writePhotoDocument();
+
+        Parameters mParameters;
+
+        UBDocumentProxy* mDocument;
+        UBGraphicsScene* mScene;
+
+        UBDocumentProxy* mPhotoDocument;
+
+        UBGraphicsScene* mHeavyScene;
+        QList<StrokeSegment> mHeavySegments;
+
+        // the same page without colour roles, recoloured segment by segment
+        UBGraphicsScene* mRecoloredScene;
+        QList<StrokeSegment> mRecoloredSegments;
+
+        QList<Measure> mMeasures;
+
+        QMap<QString, qint64> mCounters;
+
+        QStringList mFailures;
+
+        // what the first threaded eraser determinism run left, every later run must leave the same
+        QByteArray mErasedSegmentsDigest;
+};
+
+#endif /* UBSCENEBENCHMARK_H_ */
@@ -0,0 +1,13 @@
+
+# Built with "qmake CONFIG+=scene_benchmark", see Sankore_3.1.pro
+
+TARGET = "Open-Sankore-SceneBenchmark"
+
+BUILD_DIR = $$BUILD_DIR/benchmark
+
+HEADERS      += src/benchmark/UBSceneBenchmark.h
+
+SOURCES      -= src/core/main.cpp
+
+SOURCES      += src/benchmark/main.cpp \
+                src/benchmark/UBSceneBenchmark.cpp
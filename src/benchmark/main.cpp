@@ -0,0 +1,114 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtGui>
+#include <QTextCodec>
+
+#include "core/UBApplication.h"
+
+#include "UBSceneBenchmark.h"
+
+/*
+ * Headless scene benchmark, built with "qmake CONFIG+=scene_benchmark".
+ *
+ *   Open-Sankore-SceneBenchmark [-strokes N] [-images N] [-texts N] [-widgets N]
+ *                               [-warmup N] [-repeat N] [-size WIDTHxHEIGHT] [-output file.json]
+ *
+ * No window is ever shown. Qt 4 has no offscreen platform, so on X11 it still needs
+ * a display server, a virtual one (Xvfb) is enough.
+ */
+
+static int intArgument(const QStringList& pArgs, const QString& pName, int pDefault)
+{
+    int index = pArgs.indexOf(pName);
+
+    if (index < 0 || index + 1 >= pArgs.size())
+        return pDefault;
+
+    bool ok = false;
+    int value = pArgs.at(index + 1).toInt(&ok);
+
+    return ok ? value : pDefault;
+}
+
+
+int main(int argc, char *argv[])
+{
+    Q_INIT_RESOURCE(sankore);
+
+#if defined(Q_WS_X11)
+    QApplication::setGraphicsSystem("raster");
+#endif
+
+    UBApplication app("Sankore-SceneBenchmark", argc, argv);
+
+    QTextCodec::setCodecForTr(QTextCodec::codecForName("UTF-8"));
+    QTextCodec::setCodecForCStrings(QTextCodec::codecForName("UTF-8"));
+
+    QStringList args = app.arguments();
+
+    UBSceneBenchmark::Parameters parameters;
+    parameters.strokeCount = intArgument(args, "-strokes", parameters.strokeCount);
+    parameters.imageCount = intArgument(args, "-images", parameters.imageCount);
+    parameters.textCount = intArgument(args, "-texts", parameters.textCount);
+    parameters.widgetCount = intArgument(args, "-widgets", parameters.widgetCount);
+    parameters.warmUpCount = qMax(0, intArgument(args, "-warmup", parameters.warmUpCount));
+    parameters.repetitionCount = qMax(1, intArgument(args, "-repeat", parameters.repetitionCount));
+
+    if (args.contains("-size"))
+    {
+        QStringList size = args.value(args.indexOf("-size") + 1).split("x");
+
+        if (size.size() == 2 && size.at(0).toInt() > 0 && size.at(1).toInt() > 0)
+            parameters.renderSize = QSize(size.at(0).toInt(), size.at(1).toInt());
+    }
+
+    app.createControllers();
+
+    UBSceneBenchmark benchmark(parameters);
+    benchmark.run();
+
+    QString json = benchmark.toJson();
+
+    QString outputPath = args.contains("-output") ? args.value(args.indexOf("-output") + 1) : QString();
+
+    int result = 0;
+
+    if (outputPath.isEmpty())
+    {
+        QTextStream(stdout) << json;
+    }
+    else
+    {
+        QFile output(outputPath);
+
+        if (output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        {
+            QTextStream(&output) << json;
+        }
+        else
+        {
+            qWarning() << "cannot write benchmark results to" << outputPath;
+            result = 1;
+        }
+    }
+
+    if (benchmark.hasFailed())
+        result = 1;
+
+    app.cleanup();
+
+    return result;
+}
@@ -180,6 +180,7 @@ void UBBoardController::setupViews()
     mDisplayView = new UBBoardView(this, UBItemLayerType::FixedBackground, UBItemLayerType::Tool, 0);
     mDisplayView->setInteractive(false);
     mDisplayView->setTransformationAnchor(QGraphicsView::NoAnchor);
+    mDisplayView->setRenderingSource(mControlView);
 
     mMessageWindow = new UBMessageWindow(mControlView);
     mMessageWindow->hide();
@@ -600,10 +601,17 @@ void UBBoardController::duplicateItem(UBItem *item)
             UBGraphicsPixmapItem *pixitem = dynamic_cast<UBGraphicsPixmapItem*>(item);
             if (pixitem)
             {
-                 QBuffer buffer(&pData);
-                 buffer.open(QIODevice::WriteOnly);
-                 QString format = UBFileSystemUtils::extension(item->sourceUrl().toLocalFile());
-                 pixitem->pixmap().save(&buffer, format.toLatin1());
+                 if (pixitem->hasOriginalData())
+                 {
+                     pData = pixitem->originalData();
+                 }
+                 else
+                 {
+                     QBuffer buffer(&pData);
+                     buffer.open(QIODevice::WriteOnly);
+                     QString format = UBFileSystemUtils::extension(item->sourceUrl().toLocalFile());
+                     pixitem->pixmap().save(&buffer, format.toLatin1());
+                 }
             }
         }break;
 
@@ -1014,19 +1022,29 @@ UBItem *UBBoardController::downloadFinished(bool pSuccess, QUrl sourceUrl, QStri
         qDebug() << "accepting mime type" << mimeType << "as raster image";
 
 
-        QPixmap pix;
-        if(pData.length() == 0){
-            pix.load(sourceUrl.toLocalFile());
-        }
-        else{
-            QImage img;
-            img.loadFromData(pData);
-            pix = QPixmap::fromImage(img);
+        QByteArray imageData = pData;
+
+        if (imageData.length() == 0)
+        {
+            QFile file(sourceUrl.toLocalFile());
+
+            if (file.open(QIODevice::ReadOnly))
+            {
+                imageData = file.readAll();
+                file.close();
+            }
         }
 
+        QPixmap pix;
+        pix.loadFromData(imageData);
+
         UBGraphicsPixmapItem* pixItem = mActiveScene->addPixmap(pix, NULL, pPos, 1.);
         pixItem->setSourceUrl(sourceUrl);
 
+        // the page is saved with the downloaded file rather than a re-encoding of the pixmap
+        if (!pix.isNull())
+            pixItem->setOriginalData(imageData);
+
         if (isBackground)
         {
             mActiveScene->setAsBackgroundObject(pixItem, true);
@@ -2218,13 +2236,47 @@ void UBBoardController::processMimeData(const QMimeData* pMimeData, const QPoint
 
     if (pMimeData->hasImage())
     {
-        QImage img = qvariant_cast<QImage> (pMimeData->imageData());
-        QPixmap pix = QPixmap::fromImage(img);
+        // png and jpeg are kept as offered, so they are saved without re-encoding. The other
+        // formats (bmp, ppm, xpm...) are only decoded, the page encodes them in the background
+        // in the configured image format when saved
+        QStringList formats = pMimeData->formats();
+        QStringList keptFormats;
+        keptFormats << "image/png" << "image/jpeg";
+
+        QByteArray imageData;
+        QPixmap pix;
+
+        foreach(QString keptFormat, keptFormats)
+        {
+            if (formats.contains(keptFormat))
+            {
+                QByteArray data = pMimeData->data(keptFormat);
+
+                if (pix.loadFromData(data))
+                {
+                    imageData = data;
+                    break;
+                }
+            }
+        }
+
+        for (int i = 0; i < formats.size() && pix.isNull(); i++)
+        {
+            if (formats.at(i).startsWith("image/") && !keptFormats.contains(formats.at(i)))
+                pix.loadFromData(pMimeData->data(formats.at(i)));
+        }
+
+        if (pix.isNull())
+        {
+            QImage img = qvariant_cast<QImage> (pMimeData->imageData());
+            pix = QPixmap::fromImage(img);
+        }
 
         // validate that the image is really an image, webkit does not fill properly the image mime data
         if (pix.width() != 0 && pix.height() != 0)
         {
-            mActiveScene->addPixmap(pix, NULL, pPos, 1.);
+            UBGraphicsPixmapItem* pixItem = mActiveScene->addPixmap(pix, NULL, pPos, 1.);
+            pixItem->setOriginalData(imageData);
             return;
         }
     }
@@ -106,6 +106,11 @@ UBBoardView::~UBBoardView () {
   //NOOP
     if (suspendedMousePressEvent)
         delete suspendedMousePressEvent;
+
+    setRenderingSource (0);
+
+    if (mRenderingFollower)
+        mRenderingFollower->setRenderingSource (0);
 }
 
 void UBBoardView::init ()
@@ -147,6 +152,15 @@ void UBBoardView::init ()
 
   movingItem = NULL;
   mWidgetMoved = false;
+
+  mRenderingSource = 0;
+  mRenderingFollower = 0;
+  mSharesRendering = false;
+  mUpdateModeBeforeSharing = viewportUpdateMode ();
+  mPaintingSharedLayer = false;
+
+  mFrameCount = 0;
+  mFrameTime = 0;
 }
 
 UBGraphicsScene*
@@ -159,6 +173,14 @@ void
 UBBoardView::hideEvent (QHideEvent * event)
 {
   Q_UNUSED (event);
+
+  // a hidden control view paints nothing the display could wait for
+  if (mRenderingFollower)
+    mRenderingFollower->updateRenderingSharing ();
+
+  if (mRenderingSource)
+    updateRenderingSharing ();
+
   emit hidden ();
 }
 
@@ -1277,12 +1299,274 @@ UBBoardView::leaveEvent (QEvent * event)
   QGraphicsView::leaveEvent (event);
 }
 
+void
+UBBoardView::setRenderingSource (UBBoardView* pControlView)
+{
+  if (mRenderingSource)
+    {
+      mRenderingSource->mRenderingFollower = 0;
+      mRenderingSource->mSharedLayer = QImage ();
+      mRenderingSource->mSharedRegion = QRegion ();
+    }
+
+  if (mSharesRendering)
+    {
+      mSharesRendering = false;
+      setViewportUpdateMode (mUpdateModeBeforeSharing);
+    }
+
+  mRenderingSource = pControlView;
+
+  if (mRenderingSource)
+    mRenderingSource->mRenderingFollower = this;
+
+  viewport ()->update ();
+}
+
+void
+UBBoardView::updateRenderingSharing ()
+{
+  // the control rendering is only scaled down, and only covers what the control view shows
+  bool sharing = mRenderingSource
+      && isVisible ()
+      && mRenderingSource->isVisible ()
+      && mRenderingSource->scene () == scene ()
+      && transform ().type () <= QTransform::TxScale
+      && mRenderingSource->transform ().type () <= QTransform::TxScale
+      && transform ().m11 () <= mRenderingSource->transform ().m11 ()
+      && mRenderingSource->mapToScene (mRenderingSource->viewport ()->rect ()).boundingRect ()
+          .contains (mapToScene (viewport ()->rect ()).boundingRect ());
+
+  if (sharing == mSharesRendering)
+    return;
+
+  mSharesRendering = sharing;
+
+  // while sharing, the control view tells when to repaint, once its rendering is up to date
+  if (sharing)
+    {
+      mUpdateModeBeforeSharing = viewportUpdateMode ();
+      setViewportUpdateMode (QGraphicsView::NoViewportUpdate);
+    }
+  else
+    {
+      setViewportUpdateMode (mUpdateModeBeforeSharing);
+      mRenderingSource->mSharedLayer = QImage ();
+      mRenderingSource->mSharedRegion = QRegion ();
+    }
+
+  viewport ()->update ();
+}
+
+void
+UBBoardView::paintEvent (QPaintEvent *event)
+{
+  QElapsedTimer timer;
+  timer.start ();
+
+  mExposedRegion = event->region ();
+
+  if (mRenderingSource)
+    updateRenderingSharing ();
+
+  if (mRenderingFollower)
+    mRenderingFollower->updateRenderingSharing ();
+
+  if (mSharesRendering && paintSharedRendering (event->region ()))
+    {
+      mFrameCount++;
+      mFrameTime += timer.nsecsElapsed ();
+      return;
+    }
+
+  bool followerShares = mRenderingFollower && mRenderingFollower->mSharesRendering;
+
+  if (followerShares)
+    prepareSharedLayer (event->region ());
+
+  mPaintingSharedLayer = followerShares;
+
+  QGraphicsView::paintEvent (event);
+
+  mPaintingSharedLayer = false;
+
+  if (followerShares)
+    {
+      QTransform toFollower = viewportTransform ().inverted () * mRenderingFollower->viewportTransform ();
+
+      foreach (QRect rect, event->region ().rects ())
+        mRenderingFollower->viewport ()->update (toFollower.mapRect (rect).adjusted (-1, -1, 1, 1));
+    }
+
+  mFrameCount++;
+  mFrameTime += timer.nsecsElapsed ();
+}
+
+void
+UBBoardView::prepareSharedLayer (const QRegion& pRegion)
+{
+  if (mSharedLayer.size () != viewport ()->size () || mSharedLayerTransform != viewportTransform ())
+    {
+      // scrolled or zoomed, what was rendered no longer matches, render it all again
+      if (mSharedLayer.size () != viewport ()->size ())
+        mSharedLayer = QImage (viewport ()->size (), QImage::Format_ARGB32_Premultiplied);
+
+      mSharedLayerTransform = viewportTransform ();
+      mSharedRegion = QRegion ();
+
+      viewport ()->update ();
+      mRenderingFollower->viewport ()->update ();
+    }
+
+  QPainter painter (&mSharedLayer);
+  painter.setCompositionMode (QPainter::CompositionMode_Source);
+
+  foreach (QRect rect, pRegion.rects ())
+    painter.fillRect (rect, Qt::transparent);
+
+  // the exposed items are painted into it by drawItems
+  mSharedRegion += pRegion;
+}
+
+bool
+UBBoardView::paintSharedRendering (const QRegion& pRegion)
+{
+  QTransform toSource = viewportTransform ().inverted () * mRenderingSource->viewportTransform ();
+
+  QRect sourceRect = toSource.mapRect (pRegion.boundingRect ()).adjusted (-1, -1, 1, 1);
+
+  if (!(QRegion (sourceRect) - mRenderingSource->mSharedRegion).isEmpty ())
+    return false;
+
+  QPainter painter (viewport ());
+  painter.setClipRegion (pRegion);
+  painter.setRenderHints (renderHints ());
+
+  painter.setWorldTransform (viewportTransform ());
+  drawBackground (&painter, mapToScene (pRegion.boundingRect ()).boundingRect ());
+  painter.resetTransform ();
+
+  foreach (QRect rect, pRegion.rects ())
+    painter.drawImage (QRectF (rect), mRenderingSource->mSharedLayer, toSource.mapRect (QRectF (rect)));
+
+  // what is painted per view lies over the shared items, see drawItems
+  QList<QGraphicsItem*> perViewItems;
+
+  foreach (QGraphicsItem* item, items (pRegion.boundingRect ()))
+    {
+      if (!item->parentItem () && item->isVisible () && shouldDisplayItem (item) && isPaintedPerView (item))
+        perViewItems.prepend (item);
+    }
+
+  if (!perViewItems.isEmpty ())
+    {
+      QGraphicsItem** perViewItemArray = new QGraphicsItem*[perViewItems.size ()];
+      QStyleOptionGraphicsItem *perViewOptions = new QStyleOptionGraphicsItem[perViewItems.size ()];
+
+      for (int i = 0; i < perViewItems.size (); i++)
+        {
+          perViewItemArray[i] = perViewItems.at (i);
+          perViewOptions[i].exposedRect = perViewItems.at (i)->boundingRect ();
+        }
+
+      painter.setWorldTransform (viewportTransform ());
+
+      QGraphicsView::drawItems (&painter, perViewItems.size (), perViewItemArray, perViewOptions);
+
+      delete[] perViewOptions;
+      delete[] perViewItemArray;
+    }
+
+  return true;
+}
+
+bool
+UBBoardView::isPaintedPerView (QGraphicsItem *item)
+{
+  // children are painted along with their top level item
+  item = item->topLevelItem ();
+
+  if (item->type () == UBGraphicsItemType::CurtainItemType)
+    return true;
+
+  UBGraphicsTextItem* textItem = qgraphicsitem_cast<UBGraphicsTextItem*> (item);
+
+  // the empty text placeholder only shows on the control view
+  if (textItem)
+    return textItem->toPlainText ().isEmpty ();
+
+  return false;
+}
+
 void
 UBBoardView::drawItems (QPainter *painter, int numItems,
                         QGraphicsItem* items[],
                         const QStyleOptionGraphicsItem options[])
 {
-  if (!mFilterZIndex)
+  if (mPaintingSharedLayer)
+    {
+      // what the display shows goes through the shared layer, the control only items are painted over it
+      int sharedCount = 0;
+      int otherCount = 0;
+      bool stacked = true;
+
+      QGraphicsItem** sharedItems = new QGraphicsItem*[numItems];
+      QStyleOptionGraphicsItem *sharedOptions = new QStyleOptionGraphicsItem[numItems];
+      QGraphicsItem** otherItems = new QGraphicsItem*[numItems];
+      QStyleOptionGraphicsItem *otherOptions = new QStyleOptionGraphicsItem[numItems];
+
+      for (int i = 0; i < numItems; i++)
+        {
+          if (mRenderingFollower->shouldDisplayItem (items[i]) && !isPaintedPerView (items[i]))
+            {
+              // items come bottom first, a shared item over a control only one cannot be split out
+              stacked = stacked && otherCount == 0;
+              sharedItems[sharedCount] = items[i];
+              sharedOptions[sharedCount] = options[i];
+              sharedCount++;
+            }
+          else
+            {
+              otherItems[otherCount] = items[i];
+              otherOptions[otherCount] = options[i];
+              otherCount++;
+            }
+        }
+
+      if (stacked)
+        {
+          QPainter layerPainter (&mSharedLayer);
+          layerPainter.setClipRegion (mExposedRegion);
+          layerPainter.setRenderHints (painter->renderHints ());
+          layerPainter.setWorldTransform (painter->worldTransform ());
+
+          QGraphicsView::drawItems (&layerPainter, sharedCount, sharedItems, sharedOptions);
+
+          layerPainter.end ();
+
+          painter->save ();
+          painter->resetTransform ();
+
+          foreach (QRect rect, mExposedRegion.rects ())
+            painter->drawImage (rect, mSharedLayer, rect);
+
+          painter->restore ();
+
+          QGraphicsView::drawItems (painter, otherCount, otherItems, otherOptions);
+        }
+      else
+        {
+          mSharedRegion -= mExposedRegion;
+
+          QGraphicsView::drawItems (painter, numItems, items, options);
+        }
+
+      delete[] otherOptions;
+      delete[] otherItems;
+      delete[] sharedOptions;
+      delete[] sharedItems;
+    }
+  else if (!mFilterZIndex)
     {
       QGraphicsView::drawItems (painter, numItems, items, options);
     }
@@ -47,6 +47,26 @@ class UBBoardView : public QGraphicsView
         void setMultiselection(bool enable);
         bool isMultipleSelectionEnabled() { return mMultipleSelectionIsEnabled; }
 
+        // the display view paints what the control view rendered while it shows a part of it
+        void setRenderingSource(UBBoardView* pControlView);
+
+        int frameCount() const
+        {
+            return mFrameCount;
+        }
+
+        // nanoseconds spent painting the frameCount() frames
+        qint64 frameTime() const
+        {
+            return mFrameTime;
+        }
+
+        void resetFrameStatistics()
+        {
+            mFrameCount = 0;
+            mFrameTime = 0;
+        }
+
     signals:
 
         void resized(QResizeEvent* event);
@@ -91,6 +111,8 @@ class UBBoardView : public QGraphicsView
 
         virtual void resizeEvent(QResizeEvent * event);
 
+        virtual void paintEvent(QPaintEvent *event);
+
         virtual void drawBackground(QPainter *painter, const QRectF &rect);
 
         virtual void showEvent(QShowEvent * event);
@@ -109,6 +131,14 @@ class UBBoardView : public QGraphicsView
 
         QList<QUrl> processMimeData(const QMimeData* pMimeData);
 
+        void updateRenderingSharing();
+        bool paintSharedRendering(const QRegion& pRegion);
+        void prepareSharedLayer(const QRegion& pRegion);
+
+        // painted differently on the control view, never taken from the control view's rendering,
+        // each view paints it over the shared one
+        static bool isPaintedPerView(QGraphicsItem *item);
+
         UBBoardController* mController;
 
         int mStartLayer, mEndLayer;
@@ -154,6 +184,21 @@ class UBBoardView : public QGraphicsView
         bool mMultipleSelectionIsEnabled;
         bool isControl;
 
+        UBBoardView* mRenderingSource;
+        UBBoardView* mRenderingFollower;
+        bool mSharesRendering;
+        QGraphicsView::ViewportUpdateMode mUpdateModeBeforeSharing;
+
+        // on the control view, the items the display shows as painted for the last frames
+        QImage mSharedLayer;
+        QRegion mSharedRegion;
+        QTransform mSharedLayerTransform;
+        QRegion mExposedRegion;
+        bool mPaintingSharedLayer;
+
+        int mFrameCount;
+        qint64 mFrameTime;
+
         static bool hasSelectedParents(QGraphicsItem * item);
 
     private slots:
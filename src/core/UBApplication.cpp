@@ -57,7 +57,7 @@
 
 #include "core/memcheck.h"
 
-QPointer<QUndoStack> UBApplication::undoStack;
+QPointer<UBUndoManager> UBApplication::undoStack;
 
 UBApplicationController* UBApplication::applicationController = 0;
 UBBoardController* UBApplication::boardController = 0;
@@ -133,12 +133,14 @@ UBApplication::UBApplication(const QString &id, int &argc, char **argv) : QtSing
     UBResources::resources();
 
     if (!undoStack)
-        undoStack = new QUndoStack(staticMemoryCleaner);
+        undoStack = new UBUndoManager(staticMemoryCleaner);
 
     UBPlatformUtils::init();
 
     UBSettings *settings = UBSettings::settings();
 
+    undoStack->setMemoryBudget(settings->undoMemoryBudgetInMB->get().toLongLong() * 1024 * 1024);
+
     QString forcedLanguage("");
     if(args.contains("-lang"))
     	forcedLanguage=args.at(args.indexOf("-lang") + 1);
@@ -252,6 +254,33 @@ void UBApplication::setupTranslator(QString forcedLanguage)
 }
 
 int UBApplication::exec(const QString& pFileToImport)
+{
+    createControllers();
+
+    bool bUseMultiScreen = UBSettings::settings()->appUseMultiscreen->get().toBool();
+
+    applicationController->initScreenLayout(bUseMultiScreen);
+    boardController->setupLayout();
+
+    if (pFileToImport.length() > 0)
+    {
+        UBApplication::applicationController->importFile(pFileToImport);
+    }
+
+#if defined(Q_WS_MAC)
+    static AEEventHandlerUPP ub_proc_ae_handlerUPP = AEEventHandlerUPP(ub_appleEventProcessor);
+    AEInstallEventHandler(kCoreEventClass, kAEReopenApplication, ub_proc_ae_handlerUPP, SRefCon(UBApplication::applicationController), true);
+#endif
+    if (UBSettings::settings()->appStartMode->get() == "Desktop")
+        applicationController->showDesktop();
+    else
+        applicationController->showBoard();
+
+    return QApplication::exec();
+}
+
+
+void UBApplication::createControllers()
 {
     QPixmapCache::setCacheLimit(1024 * 100);
 
@@ -339,25 +368,6 @@ int UBApplication::exec(const QString& pFileToImport)
     connect(mainWindow->actionCut, SIGNAL(triggered()), applicationController, SLOT(actionCut()));
     connect(mainWindow->actionCopy, SIGNAL(triggered()), applicationController, SLOT(actionCopy()));
     connect(mainWindow->actionPaste, SIGNAL(triggered()), applicationController, SLOT(actionPaste()));
-
-    applicationController->initScreenLayout(bUseMultiScreen);
-    boardController->setupLayout();
-
-    if (pFileToImport.length() > 0)
-    {
-        UBApplication::applicationController->importFile(pFileToImport);
-    }
-
-#if defined(Q_WS_MAC)
-    static AEEventHandlerUPP ub_proc_ae_handlerUPP = AEEventHandlerUPP(ub_appleEventProcessor);
-    AEInstallEventHandler(kCoreEventClass, kAEReopenApplication, ub_proc_ae_handlerUPP, SRefCon(UBApplication::applicationController), true);
-#endif
-    if (UBSettings::settings()->appStartMode->get() == "Desktop")
-        applicationController->showDesktop();
-    else
-        applicationController->showBoard();
-
-    return QApplication::exec();
 }
 
 void UBApplication::importUniboardFiles()
@@ -22,6 +22,8 @@
 
 #include "transition/UniboardSankoreTransition.h"
 
+#include "UBUndoManager.h"
+
 namespace Ui
 {
     class MainWindow;
@@ -50,9 +52,12 @@ class UBApplication : public QtSingleApplication
 
         int exec(const QString& pFileToImport);
 
+        // builds the main window and the controllers without showing anything, exec() does it first
+        void createControllers();
+
 		void cleanup();
 
-        static QPointer<QUndoStack> undoStack;
+        static QPointer<UBUndoManager> undoStack;
 
         static UBApplicationController *applicationController;
         static UBBoardController* boardController;
@@ -41,11 +41,15 @@
 #include "web/UBWebController.h"
 
 #include "gui/UBScreenMirror.h"
+#include "gui/UBPreviousPageView.h"
 #include "gui/UBMainWindow.h"
 #include "gui/UBDockTeacherGuideWidget.h"
 #include "gui/UBTeacherGuideWidget.h"
 
 #include "domain/UBGraphicsPixmapItem.h"
+#include "domain/UBGraphicsScene.h"
+
+#include "adaptors/UBSvgSubsetAdaptor.h"
 
 #include "podcast/UBPodcastController.h"
 
@@ -72,6 +76,8 @@ UBApplicationController::UBApplicationController(UBBoardView *pControlView, UBBo
     , mCheckingForUpdates(false)
     , mIsShowingDesktop(false)
     , mHttp(0)
+    , mPreviousPagesSceneIndex(0)
+    , mPreviousViewsUpdatePending(false)
 {
     mDisplayManager = new UBDisplayManager(this);
 
@@ -86,13 +92,19 @@ UBApplicationController::UBApplicationController(UBBoardView *pControlView, UBBo
 
     for(int i = 0; i < mDisplayManager->numPreviousViews(); i++)
     {
-        UBBoardView *previousView = new UBBoardView(UBApplication::boardController, UBItemLayerType::FixedBackground, UBItemLayerType::Tool, 0);
-        previousView->setInteractive(false);
-        mPreviousViews.append(previousView);
+        mPreviousViews.append(new UBPreviousPageView());
     }
 
-    mBlackScene = new UBGraphicsScene(0); // deleted by UBApplicationController::destructor
-    mBlackScene->setBackground(true, false);
+    // enough to go back and forth between two pages without rendering again
+    mPreviousPageRenderings.setMaxCost(2 * mPreviousViews.size());
+
+    UBPersistenceManager* persistenceManager = UBPersistenceManager::persistenceManager();
+
+    connect(persistenceManager, SIGNAL(documentScenePersisted(UBDocumentProxy*, int)), this, SLOT(previousPagePersisted(UBDocumentProxy*, int)));
+    connect(persistenceManager, SIGNAL(documentSceneCreated(UBDocumentProxy*, int)), this, SLOT(previousPagesMoved(UBDocumentProxy*)));
+    connect(persistenceManager, SIGNAL(documentSceneMoved(UBDocumentProxy*, int)), this, SLOT(previousPagesMoved(UBDocumentProxy*)));
+    connect(persistenceManager, SIGNAL(documentSceneDeleted(UBDocumentProxy*, int)), this, SLOT(previousPagesMoved(UBDocumentProxy*)));
+    connect(persistenceManager, SIGNAL(documentWillBeDeleted(UBDocumentProxy*)), this, SLOT(previousPagesMoved(UBDocumentProxy*)));
 
     if (mDisplayManager->numScreens() >= 2)
     {
@@ -114,12 +126,11 @@ UBApplicationController::UBApplicationController(UBBoardView *pControlView, UBBo
 
 UBApplicationController::~UBApplicationController()
 {
-    foreach(UBBoardView* view, mPreviousViews)
+    foreach(UBPreviousPageView* view, mPreviousViews)
     {
         delete view;
     }
 
-    delete mBlackScene;
     delete mMirror;
     if (mHttp) delete mHttp;
 }
@@ -137,7 +148,12 @@ void UBApplicationController::initScreenLayout(bool useMultiscreen)
     mDisplayManager->setControlWidget(mMainWindow);
     mDisplayManager->setDisplayWidget(mDisplayView);
 
-    mDisplayManager->setPreviousDisplaysWidgets(mPreviousViews);
+    QList<QWidget*> previousWidgets;
+
+    foreach(UBPreviousPageView* view, mPreviousViews)
+        previousWidgets << view;
+
+    mDisplayManager->setPreviousDisplaysWidgets(previousWidgets);
     mDisplayManager->setDesktopWidget(mUninoteController->drawingView());
 
     mDisplayManager->setUseMultiScreen(useMultiscreen);
@@ -233,35 +249,125 @@ void UBApplicationController::adjustDisplayView()
 
 void UBApplicationController::adjustPreviousViews(int pActiveSceneIndex, UBDocumentProxy *pActiveDocument)
 {
-    int viewIndex = pActiveSceneIndex;
+    mPreviousPagesDocument = pActiveDocument;
+    mPreviousPagesSceneIndex = pActiveSceneIndex;
 
-    foreach(UBBoardView* previousView, mPreviousViews)
-    {
-        if (viewIndex > 0)
-        {
-            viewIndex--;
+    if (mPreviousViews.isEmpty())
+        return;
 
-            UBGraphicsScene* scene = UBPersistenceManager::persistenceManager()->loadDocumentScene(pActiveDocument, viewIndex);
+    // rendered once the page change is done, the active page comes first
+    if (!mPreviousViewsUpdatePending)
+    {
+        mPreviousViewsUpdatePending = true;
+        QTimer::singleShot(0, this, SLOT(updatePreviousViews()));
+    }
+}
 
-            if (scene)
-            {
-                previousView->setScene(scene);
 
-                qreal ratio = ((qreal)previousView->geometry().width()) / ((qreal)previousView->geometry().height());
-                QRectF sceneRect = scene->normalizedSceneRect(ratio);
-                qreal scaleRatio = previousView->geometry().width() / sceneRect.width();
+void UBApplicationController::updatePreviousViews()
+{
+    mPreviousViewsUpdatePending = false;
 
-                previousView->resetTransform();
+    int viewIndex = mPreviousPagesSceneIndex;
 
-                previousView->scale(scaleRatio, scaleRatio);
+    foreach(UBPreviousPageView* previousView, mPreviousViews)
+    {
+        viewIndex--;
 
-                previousView->centerOn(sceneRect.center());
-            }
+        if (viewIndex < 0 || !mPreviousPagesDocument)
+        {
+            previousView->setRendering(QImage());
+            continue;
         }
-        else
+
+        QPair<UBDocumentProxy*, int> key(mPreviousPagesDocument, viewIndex);
+        QImage* rendering = mPreviousPageRenderings.object(key);
+
+        if (!rendering || rendering->size() != previousView->size())
         {
-            previousView->setScene(mBlackScene);
+            rendering = new QImage(renderPreviousPage(mPreviousPagesDocument, viewIndex, previousView->size()));
+
+            if (rendering->isNull())
+            {
+                delete rendering;
+                previousView->setRendering(QImage());
+                continue;
+            }
+
+            mPreviousPageRenderings.insert(key, rendering);
         }
+
+        previousView->setRendering(*rendering);
+    }
+}
+
+
+QImage UBApplicationController::renderPreviousPage(UBDocumentProxy* pDocumentProxy, int pSceneIndex, const QSize& pSize)
+{
+    if (pSize.isEmpty())
+        return QImage();
+
+    // a page still cached is rendered from its scene, otherwise it is read for the rendering only
+    UBGraphicsScene* scene = UBPersistenceManager::persistenceManager()->getDocumentScene(pDocumentProxy, pSceneIndex);
+    bool loaded = false;
+
+    if (!scene)
+    {
+        scene = UBSvgSubsetAdaptor::loadScene(pDocumentProxy, pSceneIndex);
+        loaded = true;
+    }
+
+    if (!scene)
+        return QImage();
+
+    QImage rendering(pSize, QImage::Format_RGB32);
+    QRectF imageRect(QPointF(0, 0), pSize);
+
+    QRectF sceneRect = scene->normalizedSceneRect(imageRect.width() / imageRect.height());
+
+    QPainter painter(&rendering);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    painter.fillRect(imageRect, scene->isDarkBackground() ? Qt::black : Qt::white);
+
+    scene->setRenderingContext(UBGraphicsScene::NonScreen);
+    scene->setRenderingQuality(UBItem::RenderingQualityHigh);
+
+    scene->render(&painter, imageRect, sceneRect, Qt::KeepAspectRatio);
+
+    scene->setRenderingContext(UBGraphicsScene::Screen);
+    scene->setRenderingQuality(UBItem::RenderingQualityNormal);
+
+    painter.end();
+
+    if (loaded)
+        scene->deleteLater();
+
+    return rendering;
+}
+
+
+void UBApplicationController::previousPagePersisted(UBDocumentProxy* pDocumentProxy, int pSceneIndex)
+{
+    mPreviousPageRenderings.remove(qMakePair(pDocumentProxy, pSceneIndex));
+
+    if (pDocumentProxy == mPreviousPagesDocument
+            && pSceneIndex < mPreviousPagesSceneIndex
+            && pSceneIndex >= mPreviousPagesSceneIndex - mPreviousViews.size())
+    {
+        adjustPreviousViews(mPreviousPagesSceneIndex, mPreviousPagesDocument);
+    }
+}
+
+
+void UBApplicationController::previousPagesMoved(UBDocumentProxy* pDocumentProxy)
+{
+    // page indexes of the document changed, none of its renderings can be trusted
+    foreach(const QPair<UBDocumentProxy*, int>& key, mPreviousPageRenderings.keys())
+    {
+        if (key.first == pDocumentProxy)
+            mPreviousPageRenderings.remove(key);
     }
 }
 
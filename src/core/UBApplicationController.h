@@ -20,6 +20,7 @@
 #include <QFtp>
 
 class UBBoardView;
+class UBPreviousPageView;
 class UBDocumentProxy;
 class UBGraphicsScene;
 class UBDesktopAnnotationController;
@@ -136,6 +137,10 @@ class UBApplicationController : public QObject
     private slots:
         void updateRequestFinished(int id, bool error);
 
+        void updatePreviousViews();
+        void previousPagePersisted(UBDocumentProxy* pDocumentProxy, int pSceneIndex);
+        void previousPagesMoved(UBDocumentProxy* pDocumentProxy);
+
     protected:
 
         UBDesktopAnnotationController *mUninoteController;
@@ -144,9 +149,7 @@ class UBApplicationController : public QObject
 
         UBBoardView *mControlView;
         UBBoardView *mDisplayView;
-        QList<UBBoardView*> mPreviousViews;
-
-        UBGraphicsScene *mBlackScene;
+        QList<UBPreviousPageView*> mPreviousViews;
 
         UBScreenMirror* mMirror;
 
@@ -171,6 +174,15 @@ class UBApplicationController : public QObject
 
         void downloadJsonFinished(QString updateString);
         QHttp* mHttp;
+
+        QImage renderPreviousPage(UBDocumentProxy* pDocumentProxy, int pSceneIndex, const QSize& pSize);
+
+        QPointer<UBDocumentProxy> mPreviousPagesDocument;
+        int mPreviousPagesSceneIndex;
+        bool mPreviousViewsUpdatePending;
+
+        // pages rendered at the resolution of the previous views, kept until persisted again
+        QCache<QPair<UBDocumentProxy*, int>, QImage> mPreviousPageRenderings;
 };
 
 #endif /* UBAPPLICATIONCONTROLLER_H_ */
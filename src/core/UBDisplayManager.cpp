@@ -20,8 +20,6 @@
 #include "core/UBApplication.h"
 #include "core/UBApplicationController.h"
 
-#include "board/UBBoardView.h"
-
 #include "gui/UBBlackoutWidget.h"
 
 #include "ui_blackoutWidget.h"
@@ -162,7 +160,7 @@ void UBDisplayManager::setDisplayWidget(QWidget* pDisplayWidget)
 }
 
 
-void UBDisplayManager::setPreviousDisplaysWidgets(QList<UBBoardView*> pPreviousViews)
+void UBDisplayManager::setPreviousDisplaysWidgets(QList<QWidget*> pPreviousViews)
 {
     mPreviousDisplayWidgets = pPreviousViews;
 }
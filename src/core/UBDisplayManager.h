@@ -19,7 +19,6 @@
 #include <QtGui>
 
 class UBBlackoutWidget;
-class UBBoardView;
 
 class UBDisplayManager : public QObject
 {
@@ -39,7 +38,7 @@ class UBDisplayManager : public QObject
 
         void setDesktopWidget(QWidget* pControlWidget);
 
-        void setPreviousDisplaysWidgets(QList<UBBoardView*> pPreviousViews);
+        void setPreviousDisplaysWidgets(QList<QWidget*> pPreviousViews);
 
         bool hasControl()
         {
@@ -107,7 +106,7 @@ class UBDisplayManager : public QObject
 
         QWidget *mDesktopWidget;
 
-        QList<UBBoardView*> mPreviousDisplayWidgets;
+        QList<QWidget*> mPreviousDisplayWidgets;
 
         QList<UBBlackoutWidget*> mBlackoutWidgets;
 
@@ -38,6 +38,8 @@
 #include "board/UBBoardController.h"
 #include "board/UBBoardPaletteManager.h"
 
+#include "domain/UBGraphicsPixmapItem.h"
+
 #include "interfaces/IDataStorage.h"
 
 #include "core/memcheck.h"
@@ -86,6 +88,8 @@ void UBPersistenceManager::destroy()
 
 UBPersistenceManager::~UBPersistenceManager()
 {
+    UBSvgSubsetAdaptor::waitForPendingImages();
+
     foreach(QPointer<UBDocumentProxy> proxyGuard, documentProxies)
     {
         if (!proxyGuard.isNull())
@@ -315,6 +319,9 @@ void UBPersistenceManager::deleteDocument(UBDocumentProxy* pDocumentProxy)
 
     emit documentWillBeDeleted(pDocumentProxy);
 
+    UBSvgSubsetAdaptor::waitForPendingImages(pDocumentProxy->persistencePath());
+    UBGraphicsPixmapItem::deleteLevels(pDocumentProxy->persistencePath());
+
     UBFileSystemUtils::deleteDir(pDocumentProxy->persistencePath());
 
     documentProxies.removeAll(QPointer<UBDocumentProxy>(pDocumentProxy));
@@ -337,6 +344,8 @@ UBDocumentProxy* UBPersistenceManager::duplicateDocument(UBDocumentProxy* pDocum
 
     generatePathIfNeeded(copy);
 
+    UBSvgSubsetAdaptor::waitForPendingImages(pDocumentProxy->persistencePath());
+
     UBFileSystemUtils::copyDir(pDocumentProxy->persistencePath(), copy->persistencePath());
 
     // regenerate scenes UUIDs
@@ -621,6 +630,8 @@ void UBPersistenceManager::persistDocumentScene(UBDocumentProxy* pDocumentProxy,
         UBThumbnailAdaptor::persistScene(pDocumentProxy, pScene, pSceneIndex);
 
         pScene->setModified(false);
+
+        emit documentScenePersisted(pDocumentProxy, pSceneIndex);
     }
 
     mSceneCache.insert(pDocumentProxy, pSceneIndex, pScene);
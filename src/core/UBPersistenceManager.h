@@ -124,6 +124,9 @@ class UBPersistenceManager : public QObject
         void documentSceneWillBeDeleted(UBDocumentProxy* pDocumentProxy, int pIndex);
         void documentSceneDeleted(UBDocumentProxy* pDocumentProxy, int pDeletedIndex);
 
+        // the page file was written again, what was rendered from it is outdated
+        void documentScenePersisted(UBDocumentProxy* pDocumentProxy, int pIndex);
+
     private:
 
         int sceneCount(const UBDocumentProxy* pDocumentProxy);
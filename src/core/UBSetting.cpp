@@ -22,7 +22,12 @@
 #include "core/memcheck.h"
 
 UBSetting::UBSetting(UBSettings* parent) :
-    QObject(parent)
+    QObject(parent),
+        mOwner(parent),
+        mIsCached(false),
+        mIntValue(0),
+        mDoubleValue(0),
+        mBoolValue(false)
 {
     //NOOP
 }
@@ -34,9 +39,14 @@ UBSetting::UBSetting(UBSettings* owner, const QString& pDomain, const QString& p
         mDomain(pDomain), 
         mKey(pKey), 
         mPath(pDomain + "/" + pKey), 
-        mDefaultValue(pDefaultValue)
+        mDefaultValue(pDefaultValue),
+        mIsCached(false),
+        mIntValue(0),
+        mDoubleValue(0),
+        mBoolValue(false)
 {
-    //NOOP
+    if (mOwner)
+        mOwner->registerSetting(this);
 }
 
 UBSetting::~UBSetting()
@@ -55,7 +65,21 @@ void UBSetting::set(const QVariant& pValue)
 
 QVariant UBSetting::get()
 {
-    return mOwner->value(mPath, mDefaultValue);
+    if (!mIsCached)
+        load();
+
+    return mValue;
+}
+
+void UBSetting::load()
+{
+    mValue = mOwner->value(mPath, mDefaultValue);
+
+    mIntValue = mValue.toInt();
+    mDoubleValue = mValue.toDouble();
+    mBoolValue = mValue.toBool();
+
+    mIsCached = true;
 }
 
 QVariant UBSetting::reset()
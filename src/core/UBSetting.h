@@ -20,6 +20,12 @@
 
 class UBSettings;
 
+/*
+ * One persisted setting.
+ *
+ * The value is read from UBSettings on first use and kept decoded until a write through
+ * UBSettings::setValue invalidates it, so the typed getters are plain loads once warm.
+ */
 class UBSetting : public QObject
 {
     Q_OBJECT
@@ -50,6 +56,36 @@ class UBSetting : public QObject
             return mPath;
         }
 
+        int toInt()
+        {
+            if (!mIsCached)
+                load();
+
+            return mIntValue;
+        }
+
+        qreal toDouble()
+        {
+            if (!mIsCached)
+                load();
+
+            return mDoubleValue;
+        }
+
+        bool toBool()
+        {
+            if (!mIsCached)
+                load();
+
+            return mBoolValue;
+        }
+
+        // called by UBSettings when the stored value changes
+        void invalidate()
+        {
+            mIsCached = false;
+        }
+
     public slots:
 
         void setBool(bool pValue);
@@ -67,6 +103,16 @@ class UBSetting : public QObject
         QString mKey;
         QString mPath;
         QVariant mDefaultValue;
+
+    private:
+
+        void load();
+
+        bool mIsCached;
+        QVariant mValue;
+        int mIntValue;
+        qreal mDoubleValue;
+        bool mBoolValue;
 };
 
 
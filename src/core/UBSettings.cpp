@@ -235,6 +235,19 @@ void UBSettings::init()
     boardMarkerMediumWidth = new UBSetting(this, "Board", "MarkerMediumWidth", 24.0);
     boardMarkerStrongWidth = new UBSetting(this, "Board", "MarkerStrongWidth", 48.0);
 
+    boardPenLineWidthIndex = new UBSetting(this, "Board", "PenLineWidthIndex", 0);
+    boardPenColorIndex = new UBSetting(this, "Board", "PenColorIndex", 0);
+    boardMarkerLineWidthIndex = new UBSetting(this, "Board", "MarkerLineWidthIndex", 0);
+    boardMarkerColorIndex = new UBSetting(this, "Board", "MarkerColorIndex", 0);
+
+    boardEraserCircleWidthIndex = new UBSetting(this, "Board", "EraserCircleWidthIndex", 1);
+    boardEraserFineWidth = new UBSetting(this, "Board", "EraserFineWidth", 16);
+    boardEraserMediumWidth = new UBSetting(this, "Board", "EraserMediumWidth", 64);
+    boardEraserStrongWidth = new UBSetting(this, "Board", "EraserStrongWidth", 128);
+
+    boardDarkBackground = new UBSetting(this, "Board", "DarkBackground", 0);
+    boardCrossedBackground = new UBSetting(this, "Board", "CrossedBackground", 0);
+
     boardPenPressureSensitive = new UBSetting(this, "Board", "PenPressureSensitive", true);
     boardMarkerPressureSensitive = new UBSetting(this, "Board", "MarkerPressureSensitive", false);
 
@@ -303,6 +316,9 @@ void UBSettings::init()
 
     pageCacheSize = new UBSetting(this, "App", "PageCacheSize", 20);
 
+    // what the undo history may keep alive of the items removed from the page, 0 for no limit
+    undoMemoryBudgetInMB = new UBSetting(this, "App", "UndoMemoryBudgetInMB", 256);
+
     bitmapFileExtensions << "jpg" << "jpeg" <<  "png" <<  "tiff" << "tif" << "bmp" << "gif";
     vectoFileExtensions << "svg" <<  "svgz";
     imageFileExtensions << bitmapFileExtensions << vectoFileExtensions;
@@ -343,6 +359,9 @@ void UBSettings::init()
 
     svgViewBoxMargin = new UBSetting(this, "SVG", "ViewBoxMargin", "50");
 
+    // how the page images with no original file (captures, rendered PDF pages...) are saved
+    imageEncodingFormat = new UBSetting(this, "SVG", "ImageEncodingFormat", "png");
+
     pdfMargin = new UBSetting(this, "PDF", "Margin", "20");
     pdfPageFormat = new UBSetting(this, "PDF", "PageFormat", "A4");
     pdfResolution = new UBSetting(this, "PDF", "Resolution", "300");
@@ -418,12 +437,23 @@ QVariant UBSettings::value ( const QString & key, const QVariant & defaultValue)
 void UBSettings::setValue (const QString & key, const QVariant & value)
 {
     mUserSettings->setValue(key, value);
+
+    UBSetting* setting = mSettingsByPath.value(key);
+
+    if (setting)
+        setting->invalidate();
+}
+
+
+void UBSettings::registerSetting(UBSetting* setting)
+{
+    mSettingsByPath.insert(setting->path(), setting);
 }
 
 
 int UBSettings::penWidthIndex()
 {
-    return value("Board/PenLineWidthIndex", 0).toInt();
+    return boardPenLineWidthIndex->toInt();
 }
 
 
@@ -443,18 +473,18 @@ qreal UBSettings::currentPenWidth()
     switch (penWidthIndex())
     {
         case UBWidth::Fine:
-            width = boardPenFineWidth->get().toDouble();
+            width = boardPenFineWidth->toDouble();
             break;
         case UBWidth::Medium:
-            width = boardPenMediumWidth->get().toDouble();
+            width = boardPenMediumWidth->toDouble();
             break;
         case UBWidth::Strong:
-            width = boardPenStrongWidth->get().toDouble();
+            width = boardPenStrongWidth->toDouble();
             break;
         default:
             Q_ASSERT(false);
             //failsafe
-            width = boardPenFineWidth->get().toDouble();
+            width = boardPenFineWidth->toDouble();
             break;
     }
 
@@ -464,7 +494,7 @@ qreal UBSettings::currentPenWidth()
 
 int UBSettings::penColorIndex()
 {
-    return value("Board/PenColorIndex", 0).toInt();
+    return boardPenColorIndex->toInt();
 }
 
 
@@ -505,7 +535,7 @@ QList<QColor> UBSettings::penColors(bool onDarkBackground)
 
 int UBSettings::markerWidthIndex()
 {
-    return value("Board/MarkerLineWidthIndex", 0).toInt();
+    return boardMarkerLineWidthIndex->toInt();
 }
 
 
@@ -525,18 +555,18 @@ qreal UBSettings::currentMarkerWidth()
     switch (markerWidthIndex())
     {
         case UBWidth::Fine:
-            width = boardMarkerFineWidth->get().toDouble();
+            width = boardMarkerFineWidth->toDouble();
             break;
         case UBWidth::Medium:
-            width = boardMarkerMediumWidth->get().toDouble();
+            width = boardMarkerMediumWidth->toDouble();
             break;
         case UBWidth::Strong:
-            width = boardMarkerStrongWidth->get().toDouble();
+            width = boardMarkerStrongWidth->toDouble();
             break;
         default:
             Q_ASSERT(false);
             //failsafe
-            width = boardMarkerFineWidth->get().toDouble();
+            width = boardMarkerFineWidth->toDouble();
             break;
     }
 
@@ -546,7 +576,7 @@ qreal UBSettings::currentMarkerWidth()
 
 int UBSettings::markerColorIndex()
 {
-    return value("Board/MarkerColorIndex", 0).toInt();
+    return boardMarkerColorIndex->toInt();
 }
 
 
@@ -589,7 +619,7 @@ QList<QColor> UBSettings::markerColors(bool onDarkBackground)
 
 int UBSettings::eraserWidthIndex()
 {
-    return value("Board/EraserCircleWidthIndex", 1).toInt();
+    return boardEraserCircleWidthIndex->toInt();
 }
 
 void UBSettings::setEraserWidthIndex(int index)
@@ -599,7 +629,7 @@ void UBSettings::setEraserWidthIndex(int index)
 
 qreal UBSettings::eraserFineWidth()
 {
-    return value("Board/EraserFineWidth", 16).toDouble();
+    return boardEraserFineWidth->toDouble();
 }
 
 void UBSettings::setEraserFineWidth(qreal width)
@@ -609,7 +639,7 @@ void UBSettings::setEraserFineWidth(qreal width)
 
 qreal UBSettings::eraserMediumWidth()
 {
-    return value("Board/EraserMediumWidth", 64).toDouble();
+    return boardEraserMediumWidth->toDouble();
 }
 
 void UBSettings::setEraserMediumWidth(qreal width)
@@ -619,7 +649,7 @@ void UBSettings::setEraserMediumWidth(qreal width)
 
 qreal UBSettings::eraserStrongWidth()
 {
-    return value("Board/EraserStrongWidth", 128).toDouble();
+    return boardEraserStrongWidth->toDouble();
 }
 
 void UBSettings::setEraserStrongWidth(qreal width)
@@ -654,13 +684,13 @@ qreal UBSettings::currentEraserWidth()
 
 bool UBSettings::isDarkBackground()
 {
-    return value("Board/DarkBackground", 0).toBool();
+    return boardDarkBackground->toBool();
 }
 
 
 bool UBSettings::isCrossedBackground()
 {
-    return value("Board/CrossedBackground", 0).toBool();
+    return boardCrossedBackground->toBool();
 }
 
 
@@ -879,6 +909,16 @@ QString UBSettings::userDocumentDirectory()
     return documentDirectory;
 }
 
+QString UBSettings::userImageLevelDirectory()
+{
+    static QString levelDirectory = "";
+    if(levelDirectory.isEmpty()){
+        levelDirectory = userDataDirectory() + "/image-levels";
+        checkDirectory(levelDirectory);
+    }
+    return levelDirectory;
+}
+
 QString UBSettings::userFavoriteListFilePath()
 {
     static QString filePath = "";
@@ -104,6 +104,7 @@ class UBSettings : public QObject
         //user directories
         static QString userDataDirectory();
         static QString userDocumentDirectory();
+        static QString userImageLevelDirectory();
         static QString userFavoriteListFilePath();
         static QString userTrashDirPath();
         static QString userImageDirectory();
@@ -236,10 +237,24 @@ class UBSettings : public QObject
         UBSetting* boardPenMediumWidth;
         UBSetting* boardPenStrongWidth;
 
+        UBSetting* boardPenLineWidthIndex;
+        UBSetting* boardPenColorIndex;
+
         UBSetting* boardMarkerFineWidth;
         UBSetting* boardMarkerMediumWidth;
         UBSetting* boardMarkerStrongWidth;
 
+        UBSetting* boardMarkerLineWidthIndex;
+        UBSetting* boardMarkerColorIndex;
+
+        UBSetting* boardEraserCircleWidthIndex;
+        UBSetting* boardEraserFineWidth;
+        UBSetting* boardEraserMediumWidth;
+        UBSetting* boardEraserStrongWidth;
+
+        UBSetting* boardDarkBackground;
+        UBSetting* boardCrossedBackground;
+
         UBSetting* boardPenPressureSensitive;
         UBSetting* boardMarkerPressureSensitive;
 
@@ -275,6 +290,8 @@ class UBSettings : public QObject
 
         UBSetting* pageCacheSize;
 
+        UBSetting* undoMemoryBudgetInMB;
+
         UBSetting* boardZoomFactor;
 
         UBSetting* mirroringRefreshRateInFps;
@@ -298,6 +315,7 @@ class UBSettings : public QObject
         QMap<DocumentSizeRatio::Enum, QSize> documentSizes;
 
         UBSetting* svgViewBoxMargin;
+        UBSetting* imageEncodingFormat;
         UBSetting* pdfMargin;
         UBSetting* pdfPageFormat;
         UBSetting* pdfResolution;
@@ -380,6 +398,9 @@ class UBSettings : public QObject
         QVariant value ( const QString & key, const QVariant & defaultValue = QVariant() ) const;
         void setValue (const QString & key,const QVariant & value);
 
+        // lets setValue invalidate the cached value of the setting stored under the same path
+        void registerSetting(UBSetting* setting);
+
         void colorChanged() { emit colorContextChanged(); }
 
     signals:
@@ -390,6 +411,8 @@ class UBSettings : public QObject
         QSettings* mAppSettings;
         QSettings* mUserSettings;
 
+        QHash<QString, UBSetting*> mSettingsByPath;
+
         static const int sDefaultFontPixelSize;
         static const char *sDefaultFontFamily;
 
@@ -0,0 +1,374 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UBUndoManager.h"
+
+#include "domain/UBAbstractUndoCommand.h"
+#include "domain/UBGraphicsPixmapItem.h"
+#include "domain/UBGraphicsPolygonItem.h"
+#include "domain/UBGraphicsPDFItem.h"
+#include "domain/UBGraphicsSvgItem.h"
+#include "domain/UBGraphicsMediaItem.h"
+#include "domain/UBGraphicsWidgetItem.h"
+
+#include "core/memcheck.h"
+
+// rough costs of what cannot be measured from the item itself
+static const qint64 sItemOverhead = 512;
+static const qint64 sWebPageFootprint = 16 * 1024 * 1024;
+static const qint64 sMediaFootprint = 8 * 1024 * 1024;
+
+
+class UBUndoCheckpointCommand : public UBAbstractUndoCommand
+{
+    public:
+
+        UBUndoCheckpointCommand()
+            : mCollapsedCount(0)
+        {
+            // NOOP
+        }
+
+        void collapse()
+        {
+            mCollapsedCount++;
+            setText(QObject::tr("%1 earlier actions").arg(mCollapsedCount));
+        }
+
+    private:
+
+        int mCollapsedCount;
+};
+
+
+UBUndoManager::UBUndoManager(QObject *pParent)
+    : QObject(pParent)
+    , mIndex(0)
+    , mCheckpoint(0)
+    , mMemoryBudget(0)
+    , mMemoryUsage(0)
+{
+    // NOOP
+}
+
+
+UBUndoManager::~UBUndoManager()
+{
+    qDeleteAll(mCommands);
+}
+
+
+const QUndoCommand* UBUndoManager::command(int pIndex) const
+{
+    if (pIndex < 0 || pIndex >= mCommands.size())
+        return 0;
+
+    return mCommands.at(pIndex);
+}
+
+
+bool UBUndoManager::canUndo() const
+{
+    // nothing below the checkpoint can be brought back
+    return mIndex > (mCheckpoint ? 1 : 0);
+}
+
+
+bool UBUndoManager::canRedo() const
+{
+    return mIndex < mCommands.size();
+}
+
+
+void UBUndoManager::push(QUndoCommand* pCommand)
+{
+    if (!pCommand)
+        return;
+
+    bool couldUndo = canUndo();
+    bool couldRedo = canRedo();
+    int previousIndex = mIndex;
+
+    pCommand->redo();
+
+    // referenced first, the undone commands dropped below may share items with it
+    addReferences(pCommand);
+    updateUsage(pCommand);
+
+    while (mCommands.size() > mIndex)
+        releaseCommand(mCommands.takeLast());
+
+    QUndoCommand* top = mIndex > 0 ? mCommands.at(mIndex - 1) : 0;
+
+    if (top && top != mCheckpoint && pCommand->id() != -1 && pCommand->id() == top->id())
+    {
+        QSet<QGraphicsItem*> previousItems = removeReferences(top);
+
+        bool merged = top->mergeWith(pCommand);
+
+        addReferences(top);
+        updateUsage(top);
+
+        foreach(QGraphicsItem* item, previousItems)
+        {
+            if (!mItemReferences.contains(item))
+            {
+                updateUsage(item);
+                mItemFootprints.remove(item);
+            }
+        }
+
+        if (merged)
+        {
+            releaseCommand(pCommand);
+            emitChanges(couldUndo, couldRedo, previousIndex);
+            return;
+        }
+    }
+
+    mCommands << pCommand;
+    mIndex++;
+
+    enforceBudget();
+
+    emitChanges(couldUndo, couldRedo, previousIndex);
+}
+
+
+void UBUndoManager::undo()
+{
+    if (!canUndo())
+        return;
+
+    bool couldRedo = canRedo();
+    int previousIndex = mIndex;
+
+    mIndex--;
+    mCommands.at(mIndex)->undo();
+
+    updateUsage(mCommands.at(mIndex));
+
+    emitChanges(true, couldRedo, previousIndex);
+}
+
+
+void UBUndoManager::redo()
+{
+    if (!canRedo())
+        return;
+
+    bool couldUndo = canUndo();
+    int previousIndex = mIndex;
+
+    mCommands.at(mIndex)->redo();
+
+    updateUsage(mCommands.at(mIndex));
+
+    mIndex++;
+
+    emitChanges(couldUndo, true, previousIndex);
+}
+
+
+void UBUndoManager::clear()
+{
+    bool couldUndo = canUndo();
+    bool couldRedo = canRedo();
+    int previousIndex = mIndex;
+
+    // like QUndoStack::clear, the items are left to the caller
+    qDeleteAll(mCommands);
+    mCommands.clear();
+    mIndex = 0;
+    mCheckpoint = 0;
+
+    mCommandItems.clear();
+    mItemReferences.clear();
+    mItemFootprints.clear();
+    mCountedFootprints.clear();
+    mMemoryUsage = 0;
+
+    emitChanges(couldUndo, couldRedo, previousIndex);
+}
+
+
+void UBUndoManager::setMemoryBudget(qint64 pBytes)
+{
+    bool couldUndo = canUndo();
+    bool couldRedo = canRedo();
+    int previousIndex = mIndex;
+
+    mMemoryBudget = pBytes;
+
+    enforceBudget();
+
+    emitChanges(couldUndo, couldRedo, previousIndex);
+}
+
+
+void UBUndoManager::updateUsage(QGraphicsItem* pItem)
+{
+    mMemoryUsage -= mCountedFootprints.take(pItem);
+
+    // items on a scene would be there without the history
+    if (mItemReferences.contains(pItem) && !pItem->scene())
+    {
+        qint64 footprint = mItemFootprints.value(pItem);
+
+        mCountedFootprints.insert(pItem, footprint);
+        mMemoryUsage += footprint;
+    }
+}
+
+
+void UBUndoManager::updateUsage(QUndoCommand* pCommand)
+{
+    foreach(QGraphicsItem* item, mCommandItems.value(pCommand))
+        updateUsage(item);
+}
+
+
+qint64 UBUndoManager::estimatedFootprint(QGraphicsItem* pItem)
+{
+    if (!pItem)
+        return 0;
+
+    qint64 footprint = sItemOverhead;
+
+    if (UBGraphicsPixmapItem* pixmapItem = qgraphicsitem_cast<UBGraphicsPixmapItem*>(pItem))
+    {
+        QPixmap pixmap = pixmapItem->decodedPixmap();
+        footprint += qint64(pixmap.width()) * pixmap.height() * qMax(1, pixmap.depth() / 8);
+        footprint += pixmapItem->originalData().size();
+    }
+    else if (UBGraphicsPolygonItem* polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(pItem))
+    {
+        footprint += polygonItem->polygon().size() * sizeof(QPointF);
+    }
+    else if (qgraphicsitem_cast<UBGraphicsMediaItem*>(pItem))
+    {
+        footprint += sMediaFootprint;
+    }
+    else if (dynamic_cast<UBGraphicsWidgetItem*>(pItem))
+    {
+        footprint += sWebPageFootprint;
+    }
+    else if (qgraphicsitem_cast<UBGraphicsPDFItem*>(pItem) || qgraphicsitem_cast<UBGraphicsSvgItem*>(pItem))
+    {
+        // what the rendered page or drawing takes once cached
+        QRectF bounds = pItem->boundingRect();
+        footprint += qint64(bounds.width() * bounds.height() * 4);
+    }
+
+    foreach(QGraphicsItem* child, pItem->childItems())
+        footprint += estimatedFootprint(child);
+
+    return footprint;
+}
+
+
+void UBUndoManager::addReferences(QUndoCommand* pCommand)
+{
+    UBAbstractUndoCommand* command = dynamic_cast<UBAbstractUndoCommand*>(pCommand);
+
+    if (!command)
+        return;
+
+    QSet<QGraphicsItem*> items = command->referencedItems();
+    items.remove(0);
+
+    if (items.isEmpty())
+        return;
+
+    mCommandItems.insert(pCommand, items);
+
+    foreach(QGraphicsItem* item, items)
+    {
+        if (++mItemReferences[item] == 1)
+            mItemFootprints.insert(item, estimatedFootprint(item));
+    }
+}
+
+
+QSet<QGraphicsItem*> UBUndoManager::removeReferences(QUndoCommand* pCommand)
+{
+    QSet<QGraphicsItem*> unreferenced;
+
+    foreach(QGraphicsItem* item, mCommandItems.take(pCommand))
+    {
+        if (--mItemReferences[item] <= 0)
+        {
+            mItemReferences.remove(item);
+            unreferenced << item;
+        }
+    }
+
+    return unreferenced;
+}
+
+
+void UBUndoManager::releaseCommand(QUndoCommand* pCommand)
+{
+    QSet<QGraphicsItem*> unreferenced = removeReferences(pCommand);
+
+    foreach(QGraphicsItem* item, unreferenced)
+    {
+        updateUsage(item);
+        mItemFootprints.remove(item);
+    }
+
+    UBAbstractUndoCommand* command = dynamic_cast<UBAbstractUndoCommand*>(pCommand);
+
+    if (command && !unreferenced.isEmpty())
+        command->releaseItems(unreferenced);
+
+    delete pCommand;
+}
+
+
+void UBUndoManager::enforceBudget()
+{
+    if (mMemoryBudget <= 0)
+        return;
+
+    // the latest action always stays undoable
+    while (mMemoryUsage > mMemoryBudget && mIndex - (mCheckpoint ? 1 : 0) > 1)
+    {
+        if (!mCheckpoint)
+        {
+            mCheckpoint = new UBUndoCheckpointCommand();
+            mCommands.prepend(mCheckpoint);
+            mIndex++;
+        }
+
+        QUndoCommand* oldest = mCommands.takeAt(1);
+        mIndex--;
+
+        mCheckpoint->collapse();
+
+        releaseCommand(oldest);
+    }
+}
+
+
+void UBUndoManager::emitChanges(bool pCouldUndo, bool pCouldRedo, int pPreviousIndex)
+{
+    if (pCouldUndo == canUndo() && pCouldRedo == canRedo() && pPreviousIndex == mIndex)
+        return;
+
+    emit indexChanged(mIndex);
+    emit canUndoChanged(canUndo());
+    emit canRedoChanged(canRedo());
+}
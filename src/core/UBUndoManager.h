@@ -0,0 +1,125 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UBUNDOMANAGER_H_
+#define UBUNDOMANAGER_H_
+
+#include <QtGui>
+
+class UBUndoCheckpointCommand;
+
+/*
+ * Undo history with a memory budget.
+ *
+ * Same interface as the QUndoStack it replaces. Commands keep the items they removed
+ * from the scene alive, so the manager estimates what those out of scene items weigh.
+ * Above the budget the oldest commands are collapsed into a single checkpoint the user
+ * cannot undo past, and the items nothing else references anymore are deleted.
+ * Commands dropped from the redo side on push release their items the same way.
+ */
+class UBUndoManager : public QObject
+{
+    Q_OBJECT;
+
+    public:
+
+        UBUndoManager(QObject *pParent = 0);
+        virtual ~UBUndoManager();
+
+        void push(QUndoCommand* pCommand);
+
+        int count() const
+        {
+            return mCommands.size();
+        }
+
+        int index() const
+        {
+            return mIndex;
+        }
+
+        const QUndoCommand* command(int pIndex) const;
+
+        bool canUndo() const;
+        bool canRedo() const;
+
+        // in bytes, 0 or less means unbounded
+        void setMemoryBudget(qint64 pBytes);
+
+        qint64 memoryBudget() const
+        {
+            return mMemoryBudget;
+        }
+
+        // estimated size of the items only kept alive by the history, refreshed for the items
+        // of every command pushed, undone, redone or dropped
+        qint64 memoryUsage() const
+        {
+            return mMemoryUsage;
+        }
+
+        // number of items the history currently references, on the scene or not
+        int referencedItemCount() const
+        {
+            return mItemReferences.size();
+        }
+
+        static qint64 estimatedFootprint(QGraphicsItem* pItem);
+
+    public slots:
+
+        void undo();
+        void redo();
+        void clear();
+
+    signals:
+
+        void canUndoChanged(bool canUndo);
+        void canRedoChanged(bool canRedo);
+        void indexChanged(int index);
+
+    private:
+
+        void addReferences(QUndoCommand* pCommand);
+        QSet<QGraphicsItem*> removeReferences(QUndoCommand* pCommand);
+
+        // deletes the command and the items only it kept alive
+        void releaseCommand(QUndoCommand* pCommand);
+
+        void updateUsage(QGraphicsItem* pItem);
+        void updateUsage(QUndoCommand* pCommand);
+
+        void enforceBudget();
+
+        void emitChanges(bool pCouldUndo, bool pCouldRedo, int pPreviousIndex);
+
+        QList<QUndoCommand*> mCommands;
+        int mIndex;
+
+        // bottom command standing for the collapsed history, 0 while nothing was collapsed
+        UBUndoCheckpointCommand* mCheckpoint;
+
+        qint64 mMemoryBudget;
+
+        QHash<QUndoCommand*, QSet<QGraphicsItem*> > mCommandItems;
+        QHash<QGraphicsItem*, int> mItemReferences;
+        QHash<QGraphicsItem*, qint64> mItemFootprints;
+
+        // footprints of the referenced items off the scene, as added to mMemoryUsage
+        QHash<QGraphicsItem*, qint64> mCountedFootprints;
+        qint64 mMemoryUsage;
+};
+
+#endif /* UBUNDOMANAGER_H_ */
@@ -12,7 +12,8 @@ HEADERS      += src/core/UB.h \
                 src/core/UBDocumentManager.h \
                 src/core/UBApplicationController.h \
     src/core/UBDownloadManager.h \
-    src/core/UBDownloadThread.h
+    src/core/UBDownloadThread.h \
+    src/core/UBUndoManager.h
                 
 SOURCES      += src/core/main.cpp \
                 src/core/UBApplication.cpp \
@@ -27,6 +28,7 @@ SOURCES      += src/core/main.cpp \
                 src/core/UBDocumentManager.cpp \
                 src/core/UBApplicationController.cpp \
     src/core/UBDownloadManager.cpp \
-    src/core/UBDownloadThread.cpp
+    src/core/UBDownloadThread.cpp \
+    src/core/UBUndoManager.cpp
     
     
@@ -38,5 +38,15 @@ void UBAbstractUndoCommand::redo()
     // NOOP
 }
 
+QSet<QGraphicsItem*> UBAbstractUndoCommand::referencedItems() const
+{
+    return QSet<QGraphicsItem*>();
+}
+
+void UBAbstractUndoCommand::releaseItems(const QSet<QGraphicsItem*>& pItems)
+{
+    Q_UNUSED(pItems);
+}
+
 //void UBAbstractUndoCommand::UndoType getType(UndoType type);
 
@@ -38,6 +38,12 @@ class UBAbstractUndoCommand : public QUndoCommand
 
         virtual UndoType getType() { return undotype_UNKNOWN; }
 
+        // items the command keeps alive while they are out of their scene
+        virtual QSet<QGraphicsItem*> referencedItems() const;
+
+        // called before the command leaves the history, no other command references pItems anymore
+        virtual void releaseItems(const QSet<QGraphicsItem*>& pItems);
+
     protected:
         virtual void undo();
         virtual void redo();
@@ -0,0 +1,236 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UBEraserEngine.h"
+
+#include "UBGraphicsPolygonItem.h"
+
+#include "core/memcheck.h"
+
+// items spreading over more cells than that are kept out of the grid
+static const int sMaxCellsPerEntry = 256;
+
+
+UBEraserEngine::UBEraserEngine(qreal pCellSize)
+    : mCellSize(pCellSize)
+    , mIsValid(false)
+    , mVisitStamp(0)
+{
+    // NOOP
+}
+
+
+UBEraserEngine::~UBEraserEngine()
+{
+    // NOOP
+}
+
+
+void UBEraserEngine::build(const QList<QGraphicsItem*>& pItems)
+{
+    clear();
+
+    foreach(QGraphicsItem* item, pItems)
+    {
+        UBGraphicsPolygonItem* polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*>(item);
+
+        if (!polygonItem || mEntryIndexes.contains(polygonItem))
+            continue;
+
+        Entry entry;
+        entry.item = polygonItem;
+        entry.bounds = polygonItem->sceneBoundingRect();
+        entry.alive = true;
+        entry.visitStamp = 0;
+
+        int index = mEntries.size();
+        mEntries << entry;
+        mEntryIndexes.insert(polygonItem, index);
+
+        QRect cells = cellRange(entry.bounds);
+
+        if (cells.width() * cells.height() > sMaxCellsPerEntry)
+        {
+            mLargeEntries << index;
+            continue;
+        }
+
+        for (int row = cells.top(); row <= cells.bottom(); row++)
+        {
+            for (int column = cells.left(); column <= cells.right(); column++)
+            {
+                mCells[cellKey(column, row)] << index;
+            }
+        }
+    }
+
+    mIsValid = true;
+}
+
+
+void UBEraserEngine::clear()
+{
+    mEntries.clear();
+    mCells.clear();
+    mLargeEntries.clear();
+    mEntryIndexes.clear();
+    mVisitStamp = 0;
+    mIsValid = false;
+}
+
+
+void UBEraserEngine::remove(UBGraphicsPolygonItem* pItem)
+{
+    int index = mEntryIndexes.take(pItem);
+
+    if (index >= 0 && index < mEntries.size() && mEntries.at(index).item == pItem)
+        mEntries[index].alive = false;
+}
+
+
+QRect UBEraserEngine::cellRange(const QRectF& pSceneRect) const
+{
+    int left = qFloor(pSceneRect.left() / mCellSize);
+    int top = qFloor(pSceneRect.top() / mCellSize);
+    int right = qFloor(pSceneRect.right() / mCellSize);
+    int bottom = qFloor(pSceneRect.bottom() / mCellSize);
+
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+
+QVector<int> UBEraserEngine::candidateIndexes(const QRectF& pSceneRect)
+{
+    QVector<int> indexes;
+
+    ++mVisitStamp;
+
+    QRect cells = cellRange(pSceneRect);
+
+    for (int row = cells.top(); row <= cells.bottom(); row++)
+    {
+        for (int column = cells.left(); column <= cells.right(); column++)
+        {
+            QHash<qint64, QVector<int> >::const_iterator cell = mCells.constFind(cellKey(column, row));
+
+            if (cell == mCells.constEnd())
+                continue;
+
+            foreach(int index, cell.value())
+            {
+                Entry& entry = mEntries[index];
+
+                if (entry.visitStamp == mVisitStamp)
+                    continue;
+
+                entry.visitStamp = mVisitStamp;
+
+                if (entry.alive && entry.bounds.intersects(pSceneRect))
+                    indexes << index;
+            }
+        }
+    }
+
+    foreach(int index, mLargeEntries)
+    {
+        const Entry& entry = mEntries.at(index);
+
+        if (entry.alive && entry.bounds.intersects(pSceneRect))
+            indexes << index;
+    }
+
+    // keep the results independent of the hash iteration order
+    qSort(indexes);
+
+    return indexes;
+}
+
+
+QList<UBGraphicsPolygonItem*> UBEraserEngine::candidates(const QRectF& pSceneRect)
+{
+    QList<UBGraphicsPolygonItem*> items;
+
+    foreach(int index, candidateIndexes(pSceneRect))
+        items << mEntries.at(index).item;
+
+    return items;
+}
+
+
+QList<UBEraserEngine::Result> UBEraserEngine::erase(const QPolygonF& pEraserPolygon, bool pUseThreads)
+{
+    QVector<int> indexes = candidateIndexes(pEraserPolygon.boundingRect());
+
+    // graphics items are only read here, on the calling thread
+    QVector<QPolygonF> scenePolygons;
+    QVector<QTransform> sceneToItemTransforms;
+    QVector<UBGraphicsPolygonItem*> items;
+
+    foreach(int index, indexes)
+    {
+        UBGraphicsPolygonItem* item = mEntries.at(index).item;
+
+        if (!item->isVisible())
+            continue;
+
+        QTransform sceneTransform = item->sceneTransform();
+
+        items << item;
+        scenePolygons << sceneTransform.map(item->polygon());
+        sceneToItemTransforms << sceneTransform.inverted();
+    }
+
+    const int count = items.size();
+
+    QVector<Result> clipped(count);
+    QVector<bool> intersected(count, false);
+
+    Result* resultSlots = clipped.data();
+    bool* intersectedSlots = intersected.data();
+
+    #pragma omp parallel for if(pUseThreads)
+    for (int i = 0; i < count; i++)
+    {
+        // each iteration builds its own paths, QPainterPath caches are not thread safe
+        QPainterPath eraserPath;
+        eraserPath.addPolygon(pEraserPolygon);
+
+        QPainterPath itemPath;
+        itemPath.addPolygon(scenePolygons.at(i));
+
+        if (eraserPath.contains(itemPath))
+        {
+            intersectedSlots[i] = true;
+        }
+        else if (eraserPath.intersects(itemPath))
+        {
+            intersectedSlots[i] = true;
+            resultSlots[i].polygon = itemPath.subtracted(eraserPath).simplified().toFillPolygon(sceneToItemTransforms.at(i));
+        }
+    }
+
+    QList<Result> results;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (intersected.at(i))
+        {
+            clipped[i].item = items.at(i);
+            results << clipped.at(i);
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,102 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UBERASERENGINE_H_
+#define UBERASERENGINE_H_
+
+#include <QtGui>
+
+class UBGraphicsPolygonItem;
+
+/*
+ * Computes what an eraser stroke does to the polygon items of a scene.
+ *
+ * The stroke segments are bucketed once per eraser gesture in a uniform grid of
+ * scene cells, so each eraser move only looks at the segments under it. Clipping
+ * runs in parallel, every candidate writing to its own result slot, and results
+ * come back in index order so the outcome does not depend on the thread count.
+ */
+class UBEraserEngine
+{
+    public:
+
+        struct Result
+        {
+            Result()
+                : item(0)
+            {
+                // NOOP
+            }
+
+            UBGraphicsPolygonItem* item;
+
+            // what is left of the item once erased, empty if the item must be removed
+            QPolygonF polygon;
+        };
+
+        UBEraserEngine(qreal pCellSize = 64);
+        virtual ~UBEraserEngine();
+
+        bool isValid() const
+        {
+            return mIsValid;
+        }
+
+        void build(const QList<QGraphicsItem*>& pItems);
+
+        void clear();
+
+        void remove(UBGraphicsPolygonItem* pItem);
+
+        QList<UBGraphicsPolygonItem*> candidates(const QRectF& pSceneRect);
+
+        QList<Result> erase(const QPolygonF& pEraserPolygon, bool pUseThreads = true);
+
+    private:
+
+        struct Entry
+        {
+            UBGraphicsPolygonItem* item;
+            QRectF bounds;
+            bool alive;
+            int visitStamp;
+        };
+
+        QVector<int> candidateIndexes(const QRectF& pSceneRect);
+
+        QRect cellRange(const QRectF& pSceneRect) const;
+
+        static qint64 cellKey(int pColumn, int pRow)
+        {
+            return (qint64(pColumn) << 32) | quint32(pRow);
+        }
+
+        qreal mCellSize;
+
+        bool mIsValid;
+
+        QVector<Entry> mEntries;
+
+        QHash<qint64, QVector<int> > mCells;
+
+        // entries covering too many cells to be bucketed, tested on every query
+        QVector<int> mLargeEntries;
+
+        QHash<UBGraphicsPolygonItem*, int> mEntryIndexes;
+
+        int mVisitStamp;
+};
+
+#endif /* UBERASERENGINE_H_ */
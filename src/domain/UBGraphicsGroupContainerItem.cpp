@@ -37,8 +37,10 @@ UBGraphicsGroupContainerItem::~UBGraphicsGroupContainerItem()
     foreach (QGraphicsItem *item, childItems())
     {   
         removeFromGroup(item);
-        if (item && item->scene())
+        if (item && item->scene()) {
+            UBGraphicsItem::removeFromLayerIndex(item);
             item->scene()->removeItem(item);
+        }
     }
 }
 
@@ -83,7 +85,11 @@ void UBGraphicsGroupContainerItem::addToGroup(QGraphicsItem *item)
 
     QTransform newItemTransform(itemTransform);
     item->setPos(mapFromItem(item, 0, 0));
+
+    //a new group is not in the scene yet, reparenting takes the item out of it behind the scene's back
+    QGraphicsScene *itemScene = item->scene();
     item->setParentItem(this);
+    UBGraphicsItem::updateLayerIndex(item, itemScene);
 
     // removing position from translation component of the new transform
     if (!item->pos().isNull())
@@ -324,8 +330,10 @@ void UBGraphicsGroupContainerItem::pRemoveFromGroup(QGraphicsItem *item)
         itemTransform = item->sceneTransform();
 
     QPointF oldPos = item->mapToItem(newParent, 0, 0);
+    QGraphicsScene *itemScene = item->scene();
     item->setParentItem(newParent);
     item->setPos(oldPos);
+    UBGraphicsItem::updateLayerIndex(item, itemScene);
 
     // removing position from translation component of the new transform
     if (!item->pos().isNull())
@@ -174,6 +174,11 @@ UBGraphicsItemDelegate::~UBGraphicsItemDelegate()
 
 QVariant UBGraphicsItemDelegate::itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant &value)
 {
+    if (change == QGraphicsItem::ItemSceneChange) {
+        // QGraphicsScene::removeItem is not virtual, the z-order index learns about every removal here
+        UBGraphicsItem::removeFromLayerIndex(mDelegated);
+    }
+
     if(change == QGraphicsItem::ItemChildAddedChange){
 
     }else if (change == QGraphicsItem::ItemSelectedHasChanged) {
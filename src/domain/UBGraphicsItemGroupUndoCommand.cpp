@@ -20,6 +20,14 @@ UBGraphicsItemGroupUndoCommand::~UBGraphicsItemGroupUndoCommand()
 {
 }
 
+QSet<QGraphicsItem*> UBGraphicsItemGroupUndoCommand::referencedItems() const
+{
+    QSet<QGraphicsItem*> items = mItems.toSet();
+    items << mGroup;
+
+    return items;
+}
+
 void UBGraphicsItemGroupUndoCommand::undo()
 {
     mGroup->destroy();
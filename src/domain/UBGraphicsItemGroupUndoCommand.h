@@ -15,6 +15,8 @@ public:
 
     virtual UndoType getType() { return undotype_GRAPHICSGROUPITEM; }
 
+    virtual QSet<QGraphicsItem*> referencedItems() const;
+
 protected:
     virtual void undo();
     virtual void redo();
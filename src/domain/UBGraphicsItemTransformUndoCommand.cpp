@@ -19,25 +19,31 @@
 
 #include "core/memcheck.h"
 
+// consecutive manipulations of the same selection closer than that form one undo step
+static const int sMergeWindowMs = 1000;
+
+// commands pushed for the other items of a selection dragged together come that close
+static const int sGestureWindowMs = 100;
+
+
 UBGraphicsItemTransformUndoCommand::UBGraphicsItemTransformUndoCommand(QGraphicsItem* pItem,
      const QPointF& prevPos, const QTransform& prevTransform, const qreal& prevZValue,
      const QSizeF& prevSize)
+    : mIsTranslation(false)
+    , mFirstRedo(true)
 {
-    mItem = pItem;
-    mPreviousTransform = prevTransform;
-    mCurrentTransform = pItem->transform();
+    ItemState previousState;
+    previousState.position = prevPos;
+    previousState.transform = prevTransform;
+    previousState.zValue = prevZValue;
+    previousState.size = prevSize;
 
-    mPreviousPosition = prevPos;
-    mCurrentPosition = pItem->pos();
+    QList<QGraphicsItem*> items;
+    items << pItem;
 
-    mPreviousZValue = prevZValue;
-    mCurrentZValue = pItem->zValue();
-
-    mPreviousSize = prevSize;
-    UBResizableGraphicsItem* resizableItem = dynamic_cast<UBResizableGraphicsItem*>(pItem);
+    setStates(items, QVector<ItemState>() << previousState, QVector<ItemState>() << itemState(pItem));
 
-    if (resizableItem)
-        mCurrentSize = resizableItem->size();
+    mLastChange.start();
 }
 
 UBGraphicsItemTransformUndoCommand::~UBGraphicsItemTransformUndoCommand()
@@ -45,29 +51,196 @@ UBGraphicsItemTransformUndoCommand::~UBGraphicsItemTransformUndoCommand()
     // NOOP
 }
 
-void UBGraphicsItemTransformUndoCommand::undo()
+QSet<QGraphicsItem*> UBGraphicsItemTransformUndoCommand::referencedItems() const
 {
-    mItem->setPos(mPreviousPosition);
-    mItem->setTransform(mPreviousTransform);
-    mItem->setZValue(mPreviousZValue);
-//    UBGraphicsItem::assignZValue(mItem, mPreviousZValue);
+    return mItems.toSet();
+}
 
-    UBResizableGraphicsItem* resizableItem = dynamic_cast<UBResizableGraphicsItem*>(mItem);
+int UBGraphicsItemTransformUndoCommand::id() const
+{
+    return undotype_GRAPHICITEMTRANSFORM;
+}
 
-    if (resizableItem)
-        resizableItem->resize(mPreviousSize);
+bool UBGraphicsItemTransformUndoCommand::mergeWith(const QUndoCommand* pOther)
+{
+    const UBGraphicsItemTransformUndoCommand* other = dynamic_cast<const UBGraphicsItemTransformUndoCommand*>(pOther);
+
+    if (!other || mLastChange.elapsed() > sMergeWindowMs)
+        return false;
+
+    QSet<QGraphicsItem*> items = mItems.toSet();
+    QSet<QGraphicsItem*> otherItems = other->mItems.toSet();
+
+    bool sameSelection = (otherItems - items).isEmpty();
+
+    // the items of a selection dragged together are all still selected, those of separate drags are not
+    bool sameGesture = !sameSelection
+            && mIsTranslation && other->mIsTranslation
+            && mTranslation == other->mTranslation
+            && mLastChange.elapsed() <= sGestureWindowMs
+            && !otherItems.intersects(items)
+            && allSelected(mItems) && allSelected(other->mItems);
+
+    if (!sameSelection && !sameGesture)
+        return false;
+
+    // the other command was just applied, the items are in their final state
+    QList<QGraphicsItem*> mergedItems = mItems;
+
+    foreach(QGraphicsItem* item, other->mItems)
+    {
+        if (!items.contains(item))
+            mergedItems << item;
+    }
+
+    QVector<ItemState> previousStates;
+    QVector<ItemState> currentStates;
+
+    foreach(QGraphicsItem* item, mergedItems)
+    {
+        ItemState live = itemState(item);
+        int otherIndex = other->mItems.indexOf(item);
+        int index = mItems.indexOf(item);
+
+        ItemState current = otherIndex >= 0 ? other->currentState(otherIndex, live) : currentState(index, live);
+        ItemState beforeOther = otherIndex >= 0 ? other->previousState(otherIndex, live) : current;
+
+        previousStates << (index >= 0 ? previousState(index, beforeOther) : beforeOther);
+        currentStates << current;
+    }
+
+    setStates(mergedItems, previousStates, currentStates);
+
+    mLastChange.restart();
+
+    return true;
 }
 
-void UBGraphicsItemTransformUndoCommand::redo()
+UBGraphicsItemTransformUndoCommand::ItemState UBGraphicsItemTransformUndoCommand::itemState(QGraphicsItem* pItem)
 {
-    mItem->setPos(mCurrentPosition);
-    mItem->setTransform(mCurrentTransform);
-    mItem->setZValue(mCurrentZValue);
+    ItemState state;
+    state.position = pItem->pos();
+    state.transform = pItem->transform();
+    state.zValue = pItem->zValue();
+
+    UBResizableGraphicsItem* resizableItem = dynamic_cast<UBResizableGraphicsItem*>(pItem);
+
+    if (resizableItem)
+        state.size = resizableItem->size();
+
+    return state;
+}
 
-//    UBGraphicsItem::assignZValue(mItem, /*mCurrentZValue*/mItem->data(UBGraphicsItemData::ItemOwnZValue).toReal());
+void UBGraphicsItemTransformUndoCommand::applyState(QGraphicsItem* pItem, const ItemState& pState)
+{
+    pItem->setPos(pState.position);
+    pItem->setTransform(pState.transform);
+    pItem->setZValue(pState.zValue);
 
-    UBResizableGraphicsItem* resizableItem = dynamic_cast<UBResizableGraphicsItem*>(mItem);
+    UBResizableGraphicsItem* resizableItem = dynamic_cast<UBResizableGraphicsItem*>(pItem);
 
     if (resizableItem)
-        resizableItem->resize(mCurrentSize);
+        resizableItem->resize(pState.size);
+}
+
+UBGraphicsItemTransformUndoCommand::ItemState UBGraphicsItemTransformUndoCommand::previousState(int pIndex, const ItemState& pLiveState) const
+{
+    if (!mIsTranslation)
+        return mPreviousStates.at(pIndex);
+
+    ItemState state = pLiveState;
+    state.position = mCurrentPositions.at(pIndex) - mTranslation;
+
+    return state;
+}
+
+UBGraphicsItemTransformUndoCommand::ItemState UBGraphicsItemTransformUndoCommand::currentState(int pIndex, const ItemState& pLiveState) const
+{
+    if (!mIsTranslation)
+        return mCurrentStates.at(pIndex);
+
+    ItemState state = pLiveState;
+    state.position = mCurrentPositions.at(pIndex);
+
+    return state;
+}
+
+bool UBGraphicsItemTransformUndoCommand::allSelected(const QList<QGraphicsItem*>& pItems)
+{
+    foreach(QGraphicsItem* item, pItems)
+    {
+        if (!item->isSelected())
+            return false;
+    }
+
+    return true;
+}
+
+void UBGraphicsItemTransformUndoCommand::setStates(const QList<QGraphicsItem*>& pItems, const QVector<ItemState>& pPreviousStates
+        , const QVector<ItemState>& pCurrentStates)
+{
+    mItems = pItems;
+
+    // a plain drag is kept as the translation all the items share
+    mIsTranslation = !pItems.isEmpty();
+    mTranslation = mIsTranslation ? pCurrentStates.first().position - pPreviousStates.first().position : QPointF();
+
+    for (int i = 0; i < pItems.size() && mIsTranslation; i++)
+    {
+        const ItemState& previous = pPreviousStates.at(i);
+        const ItemState& current = pCurrentStates.at(i);
+
+        mIsTranslation = current.position - previous.position == mTranslation
+                && current.transform == previous.transform
+                && current.zValue == previous.zValue
+                && current.size == previous.size;
+    }
+
+    mCurrentPositions.clear();
+
+    if (mIsTranslation)
+    {
+        mCurrentPositions.reserve(pCurrentStates.size());
+
+        foreach(const ItemState& current, pCurrentStates)
+            mCurrentPositions << current.position;
+
+        mPreviousStates.clear();
+        mCurrentStates.clear();
+    }
+    else
+    {
+        mTranslation = QPointF();
+        mPreviousStates = pPreviousStates;
+        mCurrentStates = pCurrentStates;
+    }
+}
+
+void UBGraphicsItemTransformUndoCommand::undo()
+{
+    for (int i = 0; i < mItems.size(); i++)
+    {
+        if (mIsTranslation)
+            mItems.at(i)->setPos(mCurrentPositions.at(i) - mTranslation);
+        else
+            applyState(mItems.at(i), mPreviousStates.at(i));
+    }
+}
+
+void UBGraphicsItemTransformUndoCommand::redo()
+{
+    // the items were already transformed when the command was pushed
+    if (mFirstRedo)
+    {
+        mFirstRedo = false;
+        return;
+    }
+
+    for (int i = 0; i < mItems.size(); i++)
+    {
+        if (mIsTranslation)
+            mItems.at(i)->setPos(mCurrentPositions.at(i));
+        else
+            applyState(mItems.at(i), mCurrentStates.at(i));
+    }
 }
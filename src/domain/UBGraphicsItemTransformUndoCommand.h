@@ -22,6 +22,15 @@
 #include "UBAbstractUndoCommand.h"
 
 
+/*
+ * Undoes the moves, scales and rotations of a set of items.
+ *
+ * Consecutive manipulations of the same selection are merged into one command, and
+ * commands pushed for the other items of a multiple selection dragged together join
+ * it. Undo and redo put the items back to absolute states, whatever moved them meanwhile.
+ * While the items were only moved, and all by the same amount, those states are encoded
+ * as the position of each item after the move and the translation they share.
+ */
 class UBGraphicsItemTransformUndoCommand : public UBAbstractUndoCommand
 {
     public:
@@ -34,22 +43,62 @@ class UBGraphicsItemTransformUndoCommand : public UBAbstractUndoCommand
 
         virtual UndoType getType() { return undotype_GRAPHICITEMTRANSFORM; }
 
+        virtual QSet<QGraphicsItem*> referencedItems() const;
+
+        virtual int id() const;
+        virtual bool mergeWith(const QUndoCommand* pOther);
+
+        int itemCount() const
+        {
+            return mItems.size();
+        }
+
+        bool isTranslation() const
+        {
+            return mIsTranslation;
+        }
+
     protected:
         virtual void undo();
         virtual void redo();
 
     private:
-        QGraphicsItem* mItem;
-        QTransform mPreviousTransform;
-        QTransform mCurrentTransform;
-        QPointF mPreviousPosition;
-        QPointF mCurrentPosition;
-        QSizeF mPreviousSize;
-        QSizeF mCurrentSize;
+        struct ItemState
+        {
+            QPointF position;
+            QTransform transform;
+            qreal zValue;
+            QSizeF size;
+        };
+
+        static ItemState itemState(QGraphicsItem* pItem);
+        static void applyState(QGraphicsItem* pItem, const ItemState& pState);
+
+        // states of the item before and after this command, pLiveState giving what a plain
+        // translation does not record
+        ItemState previousState(int pIndex, const ItemState& pLiveState) const;
+        ItemState currentState(int pIndex, const ItemState& pLiveState) const;
+
+        static bool allSelected(const QList<QGraphicsItem*>& pItems);
+
+        void setStates(const QList<QGraphicsItem*>& pItems, const QVector<ItemState>& pPreviousStates
+                , const QVector<ItemState>& pCurrentStates);
+
+        QList<QGraphicsItem*> mItems;
+
+        bool mIsTranslation;
+        QPointF mTranslation;
+
+        // positions after the command, while the items were all simply moved by mTranslation
+        QVector<QPointF> mCurrentPositions;
+
+        // only filled when the items were not all simply moved by mTranslation
+        QVector<ItemState> mPreviousStates;
+        QVector<ItemState> mCurrentStates;
 
-        qreal mPreviousZValue;
-        qreal mCurrentZValue;
+        QElapsedTimer mLastChange;
 
+        bool mFirstRedo;
 };
 
 #endif /* UBGRAPHICSITEMTRANSFORMUNDOCOMMAND_H_ */
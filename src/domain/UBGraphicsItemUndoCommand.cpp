@@ -71,12 +71,38 @@ UBGraphicsItemUndoCommand::~UBGraphicsItemUndoCommand()
    //NOOP
 }
 
+QSet<QGraphicsItem*> UBGraphicsItemUndoCommand::referencedItems() const
+{
+    return mRemovedItems + mAddedItems;
+}
+
+void UBGraphicsItemUndoCommand::releaseItems(const QSet<QGraphicsItem*>& pItems)
+{
+    if (!mScene)
+        return;
+
+    // only what this command could still bring back, items on the scene stay.
+    // Children go with their parent, so they are not deleted on their own
+    QList<QGraphicsItem*> orphans;
+
+    foreach(QGraphicsItem* item, pItems)
+    {
+        if (item && !item->scene() && !pItems.contains(item->parentItem()))
+            orphans << item;
+    }
+
+    foreach(QGraphicsItem* item, orphans)
+        mScene->deleteItem(item);
+}
+
 void UBGraphicsItemUndoCommand::undo()
 {
     if (!mScene){
         return;
     }
 
+    mScene->beginItemBatch(mAddedItems.size() + mRemovedItems.size());
+
     QSetIterator<QGraphicsItem*> itAdded(mAddedItems);
     while (itAdded.hasNext())
     {
@@ -110,8 +136,8 @@ void UBGraphicsItemUndoCommand::undo()
         }
     }
 
-    // force refresh, QT is a bit lazy and take a lot of time (nb item ^2 ?) to trigger repaint
-    mScene->update(mScene->sceneRect());
+    // repaints only what changed, in one go
+    mScene->endItemBatch();
 
 }
 
@@ -125,6 +151,8 @@ void UBGraphicsItemUndoCommand::redo()
             return;
         }
 
+        mScene->beginItemBatch(mAddedItems.size() + mRemovedItems.size());
+
         QSetIterator<QGraphicsItem*> itRemoved(mRemovedItems);
         while (itRemoved.hasNext())
         {
@@ -149,8 +177,8 @@ void UBGraphicsItemUndoCommand::redo()
             }
         }
 
-        // force refresh, QT is a bit lazy and take a lot of time (nb item ^2) to trigger repaint
-        mScene->update(mScene->sceneRect());
+        // repaints only what changed, in one go
+        mScene->endItemBatch();
     }
     else
     {
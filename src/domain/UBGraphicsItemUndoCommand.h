@@ -39,6 +39,9 @@ class UBGraphicsItemUndoCommand : public UBAbstractUndoCommand
 
         virtual UndoType getType() { return undotype_GRAPHICITEM; }
 
+        virtual QSet<QGraphicsItem*> referencedItems() const;
+        virtual void releaseItems(const QSet<QGraphicsItem*>& pItems);
+
     protected:
         virtual void undo();
         virtual void redo();
@@ -57,12 +57,45 @@ void UBAudioPresentationWidget::paintEvent(QPaintEvent *event)
     QWidget::paintEvent(event);
 }
 
+UBVideoPresentationWidget::UBVideoPresentationWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    // hosts the video widget once the pipeline is loaded
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+}
+
+void UBVideoPresentationWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), QBrush(Qt::black));
+
+    if (!mPoster.isNull())
+    {
+        QSize posterSize = mPoster.size();
+        posterSize.scale(size(), Qt::KeepAspectRatio);
+
+        QRect posterRect(QPoint(0, 0), posterSize);
+        posterRect.moveCenter(rect().center());
+
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawPixmap(posterRect, mPoster);
+    }
+
+    QWidget::paintEvent(event);
+}
+
 bool UBGraphicsMediaItem::sIsMutedByDefault = false;
 
+static const QString sPosterSuffix = ".poster.png";
+
 UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsItem *parent)
         : UBGraphicsProxyWidget(parent)
+        , mMediaObject(NULL)
         , mVideoWidget(NULL)
+        , mAudioOutput(NULL)
         , mAudioWidget(NULL)
+        , mVideoPresentationWidget(NULL)
         , mMuted(sIsMutedByDefault)
         , mMutedByUserAction(sIsMutedByDefault)
         , mMediaFileUrl(pMediaFileUrl)
@@ -71,32 +104,22 @@ UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsIte
 {
     update();
 
-    mMediaObject = new Phonon::MediaObject(this);
     if (pMediaFileUrl.toLocalFile().contains("videos")) 
     {
         mMediaType = mediaType_Video;
 
-        mAudioOutput = new Phonon::AudioOutput(Phonon::VideoCategory, this);
-        mMediaObject->setTickInterval(50);
-        mVideoWidget = new Phonon::VideoWidget(); // owned and destructed by the scene ...
-        Phonon::createPath(mMediaObject, mVideoWidget);
-
-        if(mVideoWidget->sizeHint() == QSize(1,1)){
-            mVideoWidget->resize(320,240);
-        }
-
-        mVideoWidget->setMinimumSize(140,26);
+        mVideoPresentationWidget = new UBVideoPresentationWidget(); // owned and destructed by the scene ...
+        mVideoPresentationWidget->resize(320,240);
+        mVideoPresentationWidget->setMinimumSize(140,26);
 
-        setWidget(mVideoWidget);
+        setWidget(mVideoPresentationWidget);
         haveLinkedImage = true;
     }
     else    
     if (pMediaFileUrl.toLocalFile().contains("audios"))
     {
         mMediaType = mediaType_Audio;
-        mAudioOutput = new Phonon::AudioOutput(Phonon::MusicCategory, this);
 
-        mMediaObject->setTickInterval(1000);
         mAudioWidget = new UBAudioPresentationWidget();
         int borderSize = 0;
         UBAudioPresentationWidget* pAudioWidget = dynamic_cast<UBAudioPresentationWidget*>(mAudioWidget);
@@ -111,10 +134,11 @@ UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsIte
         haveLinkedImage = false;
     }
 
-    Phonon::createPath(mMediaObject, mAudioOutput);
-    
     mSource = Phonon::MediaSource(pMediaFileUrl);
-    mMediaObject->setCurrentSource(mSource);
+
+    // relative files are resolved once the item is on a scene
+    if (QFileInfo(pMediaFileUrl.toLocalFile()).isAbsolute())
+        setMediaFileName(pMediaFileUrl.toLocalFile());
 
     UBGraphicsMediaItemDelegate* itemDelegate = new UBGraphicsMediaItemDelegate(this, mMediaObject);
     itemDelegate->init();
@@ -128,7 +152,6 @@ UBGraphicsMediaItem::UBGraphicsMediaItem(const QUrl& pMediaFileUrl, QGraphicsIte
     setData(UBGraphicsItemData::itemLayerType, QVariant(itemLayerType::ObjectItem)); //Necessary to set if we want z value to be assigned correctly
 
     connect(mDelegate, SIGNAL(showOnDisplayChanged(bool)), this, SLOT(showOnDisplayChanged(bool)));
-    connect(mMediaObject, SIGNAL(hasVideoChanged(bool)), this, SLOT(hasMediaChanged(bool)));
 }
 
 
@@ -154,7 +177,7 @@ QVariant UBGraphicsMediaItem::itemChange(GraphicsItemChange change, const QVaria
     {
         if (!scene())
         {
-            mMediaObject->stop();
+            unloadPipeline();
         }
         else
         {
@@ -168,8 +191,10 @@ QVariant UBGraphicsMediaItem::itemChange(GraphicsItemChange change, const QVaria
             }
 
             if (absoluteMediaFilename.length() > 0)
-                mMediaObject->setCurrentSource(Phonon::MediaSource(absoluteMediaFilename));
+                setMediaFileName(absoluteMediaFilename);
 
+            if (UBApplication::boardController && UBApplication::boardController->activeScene() == scene())
+                loadPipeline();
         }
     }
 
@@ -177,6 +202,122 @@ QVariant UBGraphicsMediaItem::itemChange(GraphicsItemChange change, const QVaria
 }
 
 
+void UBGraphicsMediaItem::loadPipeline()
+{
+    if (mMediaObject)
+        return;
+
+    mMediaObject = new Phonon::MediaObject(this);
+
+    if (mediaType_Video == mMediaType)
+    {
+        mAudioOutput = new Phonon::AudioOutput(Phonon::VideoCategory, this);
+        mMediaObject->setTickInterval(50);
+
+        mVideoWidget = new Phonon::VideoWidget(mVideoPresentationWidget);
+        mVideoPresentationWidget->layout()->addWidget(mVideoWidget);
+        Phonon::createPath(mMediaObject, mVideoWidget);
+    }
+    else
+    {
+        mAudioOutput = new Phonon::AudioOutput(Phonon::MusicCategory, this);
+        mMediaObject->setTickInterval(1000);
+    }
+
+    Phonon::createPath(mMediaObject, mAudioOutput);
+    mAudioOutput->setMuted(mMuted);
+
+    mMediaObject->setCurrentSource(mSource);
+
+    connect(mMediaObject, SIGNAL(hasVideoChanged(bool)), this, SLOT(hasMediaChanged(bool)));
+
+    UBGraphicsMediaItemDelegate* mediaDelegate = dynamic_cast<UBGraphicsMediaItemDelegate*>(mDelegate);
+    if (mediaDelegate)
+        mediaDelegate->setMediaObject(mMediaObject);
+
+    //force start to load the media and display the first frame, hasMediaChanged seeks to the initial position
+    mMediaObject->play();
+    mMediaObject->pause();
+}
+
+
+void UBGraphicsMediaItem::unloadPipeline()
+{
+    if (!mMediaObject)
+        return;
+
+    // where playback resumes once loaded again
+    Phonon::State state = mMediaObject->state();
+
+    if (state == Phonon::PlayingState || state == Phonon::PausedState)
+        mInitialPos = mMediaObject->remainingTime() > 0 ? mMediaObject->currentTime() : 0;
+    else if (state == Phonon::StoppedState)
+        mInitialPos = 0;
+
+    keepPoster();
+
+    UBGraphicsMediaItemDelegate* mediaDelegate = dynamic_cast<UBGraphicsMediaItemDelegate*>(mDelegate);
+    if (mediaDelegate)
+        mediaDelegate->setMediaObject(NULL);
+
+    mMediaObject->stop();
+
+    delete mMediaObject;
+    mMediaObject = NULL;
+
+    delete mVideoWidget;
+    mVideoWidget = NULL;
+
+    delete mAudioOutput;
+    mAudioOutput = NULL;
+}
+
+
+void UBGraphicsMediaItem::setMediaFileName(const QString& pMediaFileName)
+{
+    if (pMediaFileName == mMediaFileName)
+        return;
+
+    mMediaFileName = pMediaFileName;
+    mSource = Phonon::MediaSource(mMediaFileName);
+
+    if (mMediaObject)
+        mMediaObject->setCurrentSource(mSource);
+
+    if (mVideoPresentationWidget && QFile::exists(posterPath()))
+        mVideoPresentationWidget->setPoster(QPixmap(posterPath()));
+}
+
+
+QString UBGraphicsMediaItem::posterPath() const
+{
+    if (mMediaFileName.isEmpty())
+        return QString();
+
+    return mMediaFileName + sPosterSuffix;
+}
+
+
+void UBGraphicsMediaItem::keepPoster()
+{
+    if (!mVideoWidget || !mVideoPresentationWidget)
+        return;
+
+    QImage frame = mVideoWidget->snapshot();
+
+    // not every backend can grab a frame
+    if (frame.isNull())
+        return;
+
+    mVideoPresentationWidget->setPoster(QPixmap::fromImage(frame));
+
+    // the first frame grabbed stays the poster of the file
+    QString poster = posterPath();
+    if (!poster.isEmpty() && !QFile::exists(poster))
+        frame.save(poster, "PNG");
+}
+
+
 void UBGraphicsMediaItem::setSourceUrl(const QUrl &pSourceUrl)
 {
     UBAudioPresentationWidget* pAudioWidget = dynamic_cast<UBAudioPresentationWidget*>(mAudioWidget);
@@ -197,6 +338,9 @@ void UBGraphicsMediaItem::clearSource()
 
     if (!UBFileSystemUtils::deleteFile(path))
         qDebug() << "cannot delete file: " << path;
+
+    if (QFile::exists(path + sPosterSuffix))
+        UBFileSystemUtils::deleteFile(path + sPosterSuffix);
 }
 
 void UBGraphicsMediaItem::toggleMute()
@@ -208,7 +352,8 @@ void UBGraphicsMediaItem::toggleMute()
 void UBGraphicsMediaItem::setMute(bool bMute)
 {
     mMuted = bMute;
-    mAudioOutput->setMuted(mMuted);
+    if (mAudioOutput)
+        mAudioOutput->setMuted(mMuted);
     mMutedByUserAction = mMuted;
     sIsMutedByDefault = mMuted;
 }
@@ -237,7 +382,11 @@ void UBGraphicsMediaItem::activeSceneChanged()
 {
     if (UBApplication::boardController->activeScene() != scene())
     {
-        mMediaObject->pause();
+        unloadPipeline();
+    }
+    else if (isVisible())
+    {
+        loadPipeline();
     }
 }
 
@@ -247,13 +396,14 @@ void UBGraphicsMediaItem::showOnDisplayChanged(bool shown)
     if (!shown)
     {
         mMuted = true;
-        mAudioOutput->setMuted(mMuted);
     }
     else if (!mMutedByUserAction)
     {
         mMuted = false;
-        mAudioOutput->setMuted(mMuted);
     }
+
+    if (mAudioOutput)
+        mAudioOutput->setMuted(mMuted);
 }
 
 UBItem* UBGraphicsMediaItem::deepCopy() const
@@ -40,6 +40,20 @@ private:
     QString mTitle;
 };
 
+class UBVideoPresentationWidget : public QWidget
+{
+public:
+    UBVideoPresentationWidget(QWidget *parent = NULL);
+
+    void setPoster(const QPixmap& poster){mPoster = poster; update();}
+    QPixmap poster(){return mPoster;}
+
+private:
+    virtual void paintEvent(QPaintEvent *event);
+
+    QPixmap mPoster;
+};
+
 class UBGraphicsMediaItem : public UBGraphicsProxyWidget
 {
     Q_OBJECT
@@ -65,11 +79,20 @@ public:
         return mMediaFileUrl;
     }
 
+    // 0 until the pipeline is loaded
     Phonon::MediaObject* mediaObject() const
     {
         return mMediaObject;
     }
 
+    /*
+     * The decoder pipeline is only built once the item is shown in the active scene or played,
+     * and torn down when its scene stops being the active one. Meanwhile a video item shows
+     * the poster frame cached next to its file.
+     */
+    void loadPipeline();
+    void unloadPipeline();
+
     void setInitialPos(qint64 p) {
         mInitialPos = p;
     }
@@ -120,15 +143,21 @@ protected:
     Phonon::AudioOutput *mAudioOutput;
     Phonon::MediaSource mSource;
     QWidget *mAudioWidget;
+    UBVideoPresentationWidget *mVideoPresentationWidget;
 
 private:
 
+    void setMediaFileName(const QString& pMediaFileName);
+    QString posterPath() const;
+    void keepPoster();
+
     bool mMuted;
     bool mMutedByUserAction;
     static bool sIsMutedByDefault;
 
     QUrl mMediaFileUrl;
     QString mMediaSource;
+    QString mMediaFileName;
 
     mediaType mMediaType;
 
@@ -33,18 +33,18 @@
 
 UBGraphicsMediaItemDelegate::UBGraphicsMediaItemDelegate(UBGraphicsMediaItem* pDelegated, Phonon::MediaObject* pMedia, QObject * parent)
     : UBGraphicsItemDelegate(pDelegated, parent, true, false)
-    , mMedia(pMedia)
+    , mPlayPauseButton(NULL)
+    , mStopButton(NULL)
+    , mMuteButton(NULL)
+    , mMediaControl(NULL)
+    , mMedia(NULL)
     , mToolBarShowTimer(NULL)
     , m_iToolBarShowingInterval(5000)
 {
     QPalette palette;
     palette.setBrush ( QPalette::Light, Qt::darkGray );
 
-    mMedia->setTickInterval(50);
-    connect(mMedia, SIGNAL(stateChanged (Phonon::State, Phonon::State)), this, SLOT(mediaStateChanged (Phonon::State, Phonon::State)));
-    connect(mMedia, SIGNAL(finished()), this, SLOT(updatePlayPauseState()));
-    connect(mMedia, SIGNAL(tick(qint64)), this, SLOT(updateTicker(qint64)));
-    connect(mMedia, SIGNAL(totalTimeChanged(qint64)), this, SLOT(totalTimeChanged(qint64)));
+    setMediaObject(pMedia);
 
     if (delegated()->hasLinkedImage())
     {
@@ -73,6 +73,26 @@ bool UBGraphicsMediaItemDelegate::mousePressEvent(QGraphicsSceneMouseEvent *even
     return UBGraphicsItemDelegate::mousePressEvent(event);
 }
 
+void UBGraphicsMediaItemDelegate::setMediaObject(Phonon::MediaObject* pMedia)
+{
+    if (mMedia)
+        mMedia->disconnect(this);
+
+    mMedia = pMedia;
+
+    if (mMedia)
+    {
+        mMedia->setTickInterval(50);
+        connect(mMedia, SIGNAL(stateChanged (Phonon::State, Phonon::State)), this, SLOT(mediaStateChanged (Phonon::State, Phonon::State)));
+        connect(mMedia, SIGNAL(finished()), this, SLOT(updatePlayPauseState()));
+        connect(mMedia, SIGNAL(tick(qint64)), this, SLOT(updateTicker(qint64)));
+        connect(mMedia, SIGNAL(totalTimeChanged(qint64)), this, SLOT(totalTimeChanged(qint64)));
+    }
+
+    if (mPlayPauseButton)
+        updatePlayPauseState();
+}
+
 void UBGraphicsMediaItemDelegate::hideToolBar()
 {
     mToolBarItem->hide();
@@ -84,7 +104,7 @@ void UBGraphicsMediaItemDelegate::buildButtons()
     connect(mPlayPauseButton, SIGNAL(clicked(bool)), this, SLOT(togglePlayPause()));
 
     mStopButton = new DelegateButton(":/images/stop.svg", mDelegated, mToolBarItem, Qt::TitleBarArea);
-    connect(mStopButton, SIGNAL(clicked(bool)), mMedia, SLOT(stop()));
+    connect(mStopButton, SIGNAL(clicked(bool)), this, SLOT(stopMedia()));
 
     mMediaControl = new DelegateMediaControl(delegated(), mToolBarItem);
     mMediaControl->setFlag(QGraphicsItem::ItemIsSelectable, true);
@@ -215,6 +235,9 @@ UBGraphicsMediaItem* UBGraphicsMediaItemDelegate::delegated()
 
 void UBGraphicsMediaItemDelegate::togglePlayPause()
 {
+    if (delegated() && !delegated()->mediaObject())
+        delegated()->loadPipeline();
+
     if (delegated() && delegated()->mediaObject()) {
 
         Phonon::MediaObject* media = delegated()->mediaObject();
@@ -243,6 +266,12 @@ void UBGraphicsMediaItemDelegate::togglePlayPause()
     }
 }
 
+void UBGraphicsMediaItemDelegate::stopMedia()
+{
+    if (mMedia)
+        mMedia->stop();
+}
+
 void UBGraphicsMediaItemDelegate::mediaStateChanged ( Phonon::State newstate, Phonon::State oldstate )
 {
     Q_UNUSED(newstate);
@@ -253,9 +282,7 @@ void UBGraphicsMediaItemDelegate::mediaStateChanged ( Phonon::State newstate, Ph
 
 void UBGraphicsMediaItemDelegate::updatePlayPauseState()
 {
-    Phonon::MediaObject* media = delegated()->mediaObject();
-
-    if (media->state() == Phonon::PlayingState)
+    if (mMedia && mMedia->state() == Phonon::PlayingState)
         mPlayPauseButton->setFileName(":/images/pause.svg");
     else
         mPlayPauseButton->setFileName(":/images/play.svg");
@@ -264,8 +291,8 @@ void UBGraphicsMediaItemDelegate::updatePlayPauseState()
 
 void UBGraphicsMediaItemDelegate::updateTicker(qint64 time)
 {
-    Phonon::MediaObject* media = delegated()->mediaObject();
-    mMediaControl->totalTimeChanged(media->totalTime());
+    if (mMedia)
+        mMediaControl->totalTimeChanged(mMedia->totalTime());
     mMediaControl->updateTicker(time);
 }
 
@@ -38,6 +38,9 @@ class UBGraphicsMediaItemDelegate :  public UBGraphicsItemDelegate
 
         bool mousePressEvent(QGraphicsSceneMouseEvent *event);
 
+        // follows the pipeline of the item, 0 while it is unloaded
+        void setMediaObject(Phonon::MediaObject* pMedia);
+
     public slots:
 
         void toggleMute();
@@ -49,6 +52,8 @@ class UBGraphicsMediaItemDelegate :  public UBGraphicsItemDelegate
 
         void togglePlayPause();
 
+        void stopMedia();
+
         void mediaStateChanged ( Phonon::State newstate, Phonon::State oldstate );
 
         void updatePlayPauseState();
@@ -18,15 +18,77 @@
 #include <QtGui>
 #include <QMimeData>
 #include <QDrag>
+#include <QtConcurrentRun>
 
 #include "UBGraphicsScene.h"
 
 #include "UBGraphicsItemDelegate.h"
 
+#include "core/UBSettings.h"
+
+#include "frameworks/UBFileSystemUtils.h"
+
 #include "core/memcheck.h"
 
+// reduced levels stop before either side goes under this many pixels
+static const int sMinimumLevelSide = 64;
+
+// level generations scheduled during this session, by image file
+static QHash<QString, QFuture<void> > sLevelGenerations;
+
+
+static QString cleanAbsolutePath(const QString& pPath)
+{
+    return QDir::cleanPath(QFileInfo(pPath).absoluteFilePath());
+}
+
+
+/*
+ * Drag data of a pixmap item, the image is only converted if the drop target asks for it.
+ */
+class UBPixmapItemMimeData : public QMimeData
+{
+    public:
+
+        UBPixmapItemMimeData(UBGraphicsPixmapItem* pItem)
+            : mItem(pItem)
+        {
+            // NOOP
+        }
+
+        virtual bool hasFormat(const QString& pMimeType) const
+        {
+            return pMimeType == sImageMimeType || QMimeData::hasFormat(pMimeType);
+        }
+
+        virtual QStringList formats() const
+        {
+            return QMimeData::formats() << sImageMimeType;
+        }
+
+    protected:
+
+        virtual QVariant retrieveData(const QString& pMimeType, QVariant::Type pType) const
+        {
+            if (pMimeType == sImageMimeType && mItem)
+                return mItem->fullPixmap().toImage();
+
+            return QMimeData::retrieveData(pMimeType, pType);
+        }
+
+    private:
+
+        static const QString sImageMimeType;
+
+        QPointer<UBGraphicsPixmapItem> mItem;
+};
+
+const QString UBPixmapItemMimeData::sImageMimeType = "application/x-qt-image";
+
+
 UBGraphicsPixmapItem::UBGraphicsPixmapItem(QGraphicsItem* parent)
     : QGraphicsPixmapItem(parent)
+    , mLevel(-1)
 {
     mDelegate = new UBGraphicsItemDelegate(this, 0, true);
     mDelegate->init();
@@ -60,16 +122,253 @@ void UBGraphicsPixmapItem::setUuid(const QUuid &pUuid)
     setData(UBGraphicsItemData::ItemUuid, QVariant(pUuid));
 }
 
+void UBGraphicsPixmapItem::setOriginalData(const QByteArray& pData, const QByteArray& pFormat)
+{
+    QByteArray format = pFormat.toLower();
+
+    if (!pData.isEmpty() && format.isEmpty())
+    {
+        QBuffer buffer;
+        buffer.setData(pData);
+        buffer.open(QIODevice::ReadOnly);
+
+        format = QImageReader::imageFormat(&buffer).toLower();
+    }
+
+    // data we could not tell the format of would be saved with the wrong extension
+    if (pData.isEmpty() || format.isEmpty())
+    {
+        mOriginalData.clear();
+        mOriginalFormat.clear();
+    }
+    else
+    {
+        mOriginalData = pData;
+        mOriginalFormat = format;
+    }
+}
+
+void UBGraphicsPixmapItem::setImageFile(const QString& pDocumentPath, const QString& pFilePath, const QByteArray& pData)
+{
+    setOriginalData(pData);
+
+    QBuffer buffer;
+    buffer.setData(mOriginalData);
+    buffer.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&buffer, mOriginalFormat);
+    QSize size = reader.size();
+
+    // images that do not tell their size up front are decoded right away
+    if (!hasOriginalData() || !size.isValid())
+    {
+        QPixmap pix;
+        pix.loadFromData(pData);
+        setPixmap(pix);
+
+        return;
+    }
+
+    prepareGeometryChange();
+
+    mImageFilePath = cleanAbsolutePath(pFilePath);
+    mLevelDirectory = levelDirectory(pDocumentPath);
+    mImageSize = size;
+    mLevelPixmap = QPixmap();
+    mLevel = -1;
+
+    update();
+
+    int count = levelCount();
+
+    // the coarsest level is written last, once it exists all the others do
+    if (count > 0 && !sLevelGenerations.contains(mImageFilePath) && !QFile::exists(levelFilePath(count)))
+    {
+        QStringList filePaths;
+        QList<QSize> sizes;
+
+        for (int level = 1; level <= count; level++)
+        {
+            filePaths << levelFilePath(level);
+            sizes << levelSize(level);
+        }
+
+        // created here, levels deleted meanwhile must not come back from the worker
+        QDir().mkpath(mLevelDirectory);
+
+        sLevelGenerations.insert(mImageFilePath,
+            QtConcurrent::run(&UBGraphicsPixmapItem::generateLevels, mOriginalData, mOriginalFormat, filePaths, sizes));
+    }
+}
+
+
+QPixmap UBGraphicsPixmapItem::fullPixmap()
+{
+    if (!isLevelOfDetailImage())
+        return pixmap();
+
+    if (mLevel != 0)
+        loadLevel(0);
+
+    return mLevelPixmap;
+}
+
+
+QPixmap UBGraphicsPixmapItem::decodedPixmap() const
+{
+    return isLevelOfDetailImage() ? mLevelPixmap : pixmap();
+}
+
+
+QRectF UBGraphicsPixmapItem::boundingRect() const
+{
+    if (!isLevelOfDetailImage())
+        return QGraphicsPixmapItem::boundingRect();
+
+    return QRectF(offset(), QSizeF(mImageSize));
+}
+
+
+QPainterPath UBGraphicsPixmapItem::shape() const
+{
+    if (!isLevelOfDetailImage())
+        return QGraphicsPixmapItem::shape();
+
+    QPainterPath path;
+    path.addRect(boundingRect());
+
+    return path;
+}
+
+
+int UBGraphicsPixmapItem::levelCount() const
+{
+    int count = 0;
+
+    while (qMin(mImageSize.width(), mImageSize.height()) >> (count + 1) >= sMinimumLevelSide)
+        count++;
+
+    return count;
+}
+
+
+QSize UBGraphicsPixmapItem::levelSize(int pLevel) const
+{
+    return QSize(qMax(1, mImageSize.width() >> pLevel), qMax(1, mImageSize.height() >> pLevel));
+}
+
+
+QString UBGraphicsPixmapItem::levelFilePath(int pLevel) const
+{
+    QFileInfo imageFile(mImageFilePath);
+
+    // photos stay photos, anything else may have transparency
+    QString suffix = mOriginalFormat == "jpeg" ? "jpg" : "png";
+
+    return mLevelDirectory + "/" + imageFile.completeBaseName() + "." + QString::number(pLevel) + "." + suffix;
+}
+
+
+QString UBGraphicsPixmapItem::levelDirectory(const QString& pDocumentPath)
+{
+    QByteArray documentKey = QCryptographicHash::hash(cleanAbsolutePath(pDocumentPath).toUtf8(), QCryptographicHash::Md5);
+
+    return UBSettings::userImageLevelDirectory() + "/" + QString::fromLatin1(documentKey.toHex());
+}
+
+
+void UBGraphicsPixmapItem::deleteLevels(const QString& pDocumentPath)
+{
+    QString documentPath = cleanAbsolutePath(pDocumentPath);
+
+    QMutableHashIterator<QString, QFuture<void> > it(sLevelGenerations);
+
+    while (it.hasNext())
+    {
+        it.next();
+
+        if (it.key().startsWith(documentPath + "/"))
+        {
+            it.value().waitForFinished();
+            it.remove();
+        }
+    }
+
+    UBFileSystemUtils::deleteDir(levelDirectory(pDocumentPath));
+}
+
+
+void UBGraphicsPixmapItem::loadLevel(int pLevel)
+{
+    QImage image;
+
+    if (pLevel > 0)
+        image.load(levelFilePath(pLevel));
+
+    if (image.isNull())
+    {
+        QBuffer buffer;
+        buffer.setData(mOriginalData);
+        buffer.open(QIODevice::ReadOnly);
+
+        // decoders like JPEG read a reduced size directly
+        QImageReader reader(&buffer, mOriginalFormat);
+
+        if (pLevel > 0)
+            reader.setScaledSize(levelSize(pLevel));
+
+        image = reader.read();
+
+        if (image.isNull())
+            qWarning() << "cannot decode image" << mImageFilePath << reader.errorString();
+    }
+
+    // not retried on failure, the item then just paints nothing
+    mLevelPixmap = QPixmap::fromImage(image);
+    mLevel = image.isNull() ? 0 : pLevel;
+}
+
+
+void UBGraphicsPixmapItem::generateLevels(const QByteArray& pData, const QByteArray& pFormat,
+    const QStringList& pFilePaths, const QList<QSize>& pSizes)
+{
+    QBuffer buffer;
+    buffer.setData(pData);
+    buffer.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&buffer, pFormat);
+    reader.setScaledSize(pSizes.first());
+
+    QImage level = reader.read();
+
+    for (int i = 0; i < pFilePaths.size() && !level.isNull(); i++)
+    {
+        if (i > 0)
+            level = level.scaled(pSizes.at(i), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        // written aside then renamed, a level file is never seen half written
+        QString filePath = pFilePaths.at(i);
+        QString partialFilePath = filePath + ".part";
+
+        if (!level.save(partialFilePath, QFileInfo(filePath).suffix().toLatin1()) || !QFile::rename(partialFilePath, filePath))
+        {
+            QFile::remove(partialFilePath);
+            return;
+        }
+    }
+}
+
+
 void UBGraphicsPixmapItem::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
-    QMimeData* pMime = new QMimeData();
-    pMime->setImageData(pixmap().toImage());
-    mDelegate->setMimeData(pMime);
-    qreal k = (qreal)pixmap().width() / 100.0;
+    mDelegate->setMimeData(new UBPixmapItemMimeData(this));
+
+    QPixmap shown = decodedPixmap();
+    qreal k = (qreal)shown.width() / 100.0;
 
-    QSize newSize((int)(pixmap().width() / k), (int)(pixmap().height() / k));
+    QSize newSize((int)(shown.width() / k), (int)(shown.height() / k));
 
-    mDelegate->setDragPixmap(pixmap().scaled(newSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    mDelegate->setDragPixmap(shown.scaled(newSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
 
     if (mDelegate->mousePressEvent(event))
     {
@@ -106,7 +405,27 @@ void UBGraphicsPixmapItem::paint(QPainter *painter, const QStyleOptionGraphicsIt
     QStyleOptionGraphicsItem styleOption = QStyleOptionGraphicsItem(*option);
     styleOption.state &= ~QStyle::State_Selected;
 
-    QGraphicsPixmapItem::paint(painter, &styleOption, widget);
+    if (!isLevelOfDetailImage())
+    {
+        QGraphicsPixmapItem::paint(painter, &styleOption, widget);
+        return;
+    }
+
+    // coarsest level that still has a pixel for each device pixel, full resolution when zoomed
+    // in or printed
+    qreal levelOfDetail = option->levelOfDetailFromTransform(painter->worldTransform());
+    int level = 0;
+
+    while (level < levelCount() && levelOfDetail * (1 << (level + 1)) <= 1.)
+        level++;
+
+    // a finer level already decoded is kept while zooming back and forth, it is given up once
+    // the item is shown two levels coarser, when it holds sixteen times the pixels painted
+    if (mLevel < 0 || level < mLevel || level > mLevel + 1)
+        loadLevel(level);
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, transformationMode() == Qt::SmoothTransformation);
+    painter->drawPixmap(boundingRect(), mLevelPixmap, QRectF(mLevelPixmap.rect()));
 }
 
 
@@ -129,6 +448,17 @@ void UBGraphicsPixmapItem::copyItemParameters(UBItem *copy) const
     if (cp)
     {
         cp->setPixmap(this->pixmap());
+        cp->setOriginalData(this->mOriginalData, this->mOriginalFormat);
+
+        if (isLevelOfDetailImage())
+        {
+            cp->prepareGeometryChange();
+            cp->mImageFilePath = mImageFilePath;
+            cp->mLevelDirectory = mLevelDirectory;
+            cp->mImageSize = mImageSize;
+            cp->mLevelPixmap = mLevelPixmap;
+            cp->mLevel = mLevel;
+        }
         cp->setPos(this->pos());
         cp->setTransform(this->transform());
         cp->setFlag(QGraphicsItem::ItemIsMovable, true);
@@ -56,6 +56,49 @@ class UBGraphicsPixmapItem : public QObject, public QGraphicsPixmapItem, public
 
         virtual void setUuid(const QUuid &pUuid);
 
+        /*
+         * Encoded image the pixmap was decoded from (downloaded, dropped, pasted or read from the
+         * document), so the page can be saved by copying it as is. An empty format is guessed
+         * from the data. Items without one, like captures, are encoded when saved.
+         */
+        void setOriginalData(const QByteArray& pData, const QByteArray& pFormat = QByteArray());
+
+        const QByteArray& originalData() const
+        {
+            return mOriginalData;
+        }
+
+        // lower case Qt image format name ("png", "jpeg", ...), empty without original data
+        QByteArray originalFormat() const
+        {
+            return mOriginalFormat;
+        }
+
+        bool hasOriginalData() const
+        {
+            return !mOriginalData.isEmpty();
+        }
+
+        /*
+         * For images read from a document: only the size is read up front, the pixels are decoded
+         * when painted, at the level of detail the painter needs. The half size levels are
+         * generated in the background and cached per document in the user data directory,
+         * so exported and duplicated documents do not carry them.
+         */
+        void setImageFile(const QString& pDocumentPath, const QString& pFilePath, const QByteArray& pData);
+
+        // waits for the levels still being generated for the document, then deletes its levels
+        static void deleteLevels(const QString& pDocumentPath);
+
+        // decodes the full resolution on demand for the images set with setImageFile
+        QPixmap fullPixmap();
+
+        // what is held in memory, possibly a reduced level
+        QPixmap decodedPixmap() const;
+
+        virtual QRectF boundingRect() const;
+        virtual QPainterPath shape() const;
+
 protected:
 
         virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -65,6 +108,35 @@ protected:
         virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 
         virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+
+    private:
+
+        bool isLevelOfDetailImage() const
+        {
+            return mImageSize.isValid();
+        }
+
+        // number of reduced levels, level 0 is the full resolution
+        int levelCount() const;
+        QSize levelSize(int pLevel) const;
+        QString levelFilePath(int pLevel) const;
+
+        static QString levelDirectory(const QString& pDocumentPath);
+
+        void loadLevel(int pLevel);
+
+        static void generateLevels(const QByteArray& pData, const QByteArray& pFormat,
+            const QStringList& pFilePaths, const QList<QSize>& pSizes);
+
+        QByteArray mOriginalData;
+        QByteArray mOriginalFormat;
+
+        QString mImageFilePath;
+        QString mLevelDirectory;
+        QSize mImageSize; // invalid unless set with setImageFile
+
+        QPixmap mLevelPixmap;
+        int mLevel; // of mLevelPixmap, -1 while nothing is decoded
 };
 
 #endif /* UBGRAPHICSPIXMAPITEM_H_ */
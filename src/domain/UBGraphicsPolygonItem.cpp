@@ -27,6 +27,7 @@ UBGraphicsPolygonItem::UBGraphicsPolygonItem (QGraphicsItem * parent)
     , mHasAlpha(false)
     , mOriginalWidth(-1)
     , mIsNominalLine(false)
+    , mColorRole(-1)
     , mStroke(0)
 {
     // NOOP
@@ -38,6 +39,7 @@ UBGraphicsPolygonItem::UBGraphicsPolygonItem (const QPolygonF & polygon, QGraphi
     : QGraphicsPolygonItem(polygon, parent)
     , mOriginalWidth(-1)
     , mIsNominalLine(false)
+    , mColorRole(-1)
     , mStroke(0)
     , mpGroup(NULL)
 {
@@ -51,6 +53,7 @@ UBGraphicsPolygonItem::UBGraphicsPolygonItem (const QLineF& pLine, qreal pWidth)
     , mOriginalLine(pLine)
     , mOriginalWidth(pWidth)
     , mIsNominalLine(true)
+    , mColorRole(-1)
     , mStroke(0)
 {
     // NOOP
@@ -101,43 +104,27 @@ void UBGraphicsPolygonItem::setColor(const QColor& pColor)
 {
     QGraphicsPolygonItem::setBrush(QBrush(pColor));
 
-    if (pColor.alphaF() >= 1.0)
-    {
-        mHasAlpha = false;
-        setPen(Qt::NoPen);
-    }
-    else
-    {
-        mHasAlpha = true;
-
-        QColor penColor = pColor;
+    mHasAlpha = pColor.alphaF() < 1.0;
+    QGraphicsPolygonItem::setPen(UBStrokePalette::pen(pColor));
+}
 
-        // trick QT antialiasing
-        // TODO UB 4.x see if we can do better ... it does not behave well with 16 bit color depth
-        qreal trickAlpha = pColor.alphaF();
 
-        if (trickAlpha >= 0.2 && trickAlpha < 0.6)
-        {
-            trickAlpha /= 12;
-        }
-        else if (trickAlpha < 0.8)
-        {
-            trickAlpha /= 5;
-        }
-        else if (trickAlpha < 1.0)
-        {
-            trickAlpha /= 2;
-        }
+QColor UBGraphicsPolygonItem::color() const
+{
+    const UBStrokePalette::Color* palette = paletteColor();
 
-        penColor.setAlphaF(trickAlpha);
-        QGraphicsPolygonItem::setPen(QPen(penColor));
-    }
+    return palette ? palette->color : QGraphicsPolygonItem::brush().color();
 }
 
 
-QColor UBGraphicsPolygonItem::color() const
+const UBStrokePalette::Color* UBGraphicsPolygonItem::paletteColor() const
 {
-    return QGraphicsPolygonItem::brush().color();
+    UBGraphicsScene* scene = qobject_cast<UBGraphicsScene*>(QGraphicsPolygonItem::scene());
+
+    if (mColorRole < 0 || !scene)
+        return 0;
+
+    return &UBStrokePalette::color(mColorRole, scene->isDarkBackground());
 }
 
 
@@ -168,11 +155,11 @@ void UBGraphicsPolygonItem::copyItemParameters(UBItem *copy) const
         cp->setStrokesGroup(this->strokesGroup());
         cp->setBrush(this->brush());
         cp->setPen(this->pen());
+        cp->setFillRule(this->fillRule());
         cp->mHasAlpha = this->mHasAlpha;
 
 
-        cp->setColorOnDarkBackground(this->colorOnDarkBackground());
-        cp->setColorOnLightBackground(this->colorOnLightBackground());
+        cp->mColorRole = this->mColorRole;
 
         cp->setData(UBGraphicsItemData::ItemLayerType, this->data(UBGraphicsItemData::ItemLayerType));
     }
@@ -180,6 +167,23 @@ void UBGraphicsPolygonItem::copyItemParameters(UBItem *copy) const
 
 void UBGraphicsPolygonItem::paint ( QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget)
 {
+    const UBStrokePalette::Color* palette = paletteColor();
+
+    // polygons are never selected, there is no selection outline to draw
+    if (palette)
+    {
+        if (palette->hasAlpha && scene()->isLightBackground())
+        {
+            painter->setCompositionMode(QPainter::CompositionMode_Darken);
+        }
+
+        painter->setPen(palette->pen);
+        painter->setBrush(palette->brush);
+        painter->drawPolygon(polygon(), fillRule());
+
+        return;
+    }
+
     if(mHasAlpha && scene() && scene()->isLightBackground())
     {
         painter->setCompositionMode(QPainter::CompositionMode_Darken);
@@ -188,6 +192,15 @@ void UBGraphicsPolygonItem::paint ( QPainter * painter, const QStyleOptionGraphi
     QGraphicsPolygonItem::paint(painter, option, widget);
 }
 
+QVariant UBGraphicsPolygonItem::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    // polygons have no delegate to keep the z-order index in step for them
+    if (change == QGraphicsItem::ItemSceneChange)
+        UBGraphicsItem::removeFromLayerIndex(this);
+
+    return QGraphicsPolygonItem::itemChange(change, value);
+}
+
 QPainterPath UBGraphicsPolygonItem::shape() const
 {
 
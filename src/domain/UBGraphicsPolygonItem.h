@@ -21,6 +21,7 @@
 #include "UBItem.h"
 #include "UBGraphicsStrokesGroup.h"
 #include "domain/UBGraphicsGroupContainerItem.h"
+#include "domain/UBStrokePalette.h"
 
 class UBItem;
 class UBGraphicsScene;
@@ -95,22 +96,21 @@ class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
 
         QColor colorOnDarkBackground() const
         {
-            return mColorOnDarkBackground;
-        }
-
-        void setColorOnDarkBackground(QColor pColorOnDarkBackground)
-        {
-            mColorOnDarkBackground = pColorOnDarkBackground;
+            return mColorRole < 0 ? QColor() : UBStrokePalette::color(mColorRole, true).color;
         }
 
         QColor colorOnLightBackground() const
         {
-            return mColorOnLightBackground;
+            return mColorRole < 0 ? QColor() : UBStrokePalette::color(mColorRole, false).color;
         }
 
-        void setColorOnLightBackground(QColor pColorOnLightBackground)
+        // both at once, a pair with an invalid side is not interned and the brush keeps painting
+        void setColorsOnBackgrounds(const QColor& pColorOnDarkBackground, const QColor& pColorOnLightBackground)
         {
-            mColorOnLightBackground = pColorOnLightBackground;
+            if (pColorOnDarkBackground.isValid() && pColorOnLightBackground.isValid())
+                mColorRole = UBStrokePalette::role(pColorOnDarkBackground, pColorOnLightBackground);
+            else
+                mColorRole = -1;
         }
 
         void setStroke(UBGraphicsStroke* stroke);
@@ -119,20 +119,24 @@ class UBGraphicsPolygonItem : public QGraphicsPolygonItem, public UBItem
     protected:
         void paint ( QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget);
         QPainterPath shape () const;
+        QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
 
     private:
 
         void clearStroke();
 
+        // the palette colour for the background of the scene, 0 without role or scene
+        const UBStrokePalette::Color* paletteColor() const;
+
         bool mHasAlpha;
 
         QLineF mOriginalLine;
         qreal mOriginalWidth;
         bool mIsNominalLine;
 
-        QColor mColorOnDarkBackground;
-        QColor mColorOnLightBackground;
+        // painted with the palette once set, setColor only applies to items without role
+        int mColorRole;
 
         UBGraphicsStroke* mStroke;
         UBGraphicsStrokesGroup* mpGroup;
@@ -58,6 +58,7 @@
 #include "UBGraphicsPDFItem.h"
 #include "UBGraphicsTextItem.h"
 #include "UBGraphicsStrokesGroup.h"
+#include "UBEraserEngine.h"
 
 #include "domain/UBGraphicsGroupContainerItem.h"
 
@@ -67,8 +68,12 @@
 
 qreal UBZLayerController::errorNumber = -20000001.0;
 
+// item batches changing at least a quarter of the page items go without BSP tree until they end
+static const int sUnindexedBatchRatio = 4;
+
 UBZLayerController::UBZLayerController(QGraphicsScene *scene) :
     mScene(scene)
+    , mIndexValid(false)
 
 {
     scopeMap.insert(itemLayerType::NoLayer,        ItemLayerTypeData( errorNumber, errorNumber));
@@ -130,106 +135,65 @@ qreal UBZLayerController::changeZLevelTo(QGraphicsItem *item, moveDestination de
         return errorNum();
     }
 
-    //select only items wiht the same z-level as item's one and push it to sortedItems QMultiMap
-    QMultiMap<qreal, QGraphicsItem*> sortedItems;
-    if (mScene->items().count()) {
-        foreach (QGraphicsItem *tmpItem, mScene->items()) {
-            if (typeForData(tmpItem) == curItemLayerType) {
+    qreal itemZ = item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
 
-                sortedItems.insert(tmpItem->data(UBGraphicsItemData::ItemOwnZValue).toReal(), tmpItem);
+    //neighbours of a grouped item are its siblings only, there are few of them so collect them on the fly.
+    //top level items are looked up in the per-layer index
+    ZOrderedItems siblings;
+    if (item->parentItem()) {
+        foreach (QGraphicsItem *sibling, item->parentItem()->childItems()) {
+            if (typeForData(sibling) == curItemLayerType) {
+                siblings.insert(sibling->data(UBGraphicsItemData::ItemOwnZValue).toReal(), sibling);
             }
         }
+    } else {
+        ensureIndex();
+        if (!mIndexEntries.contains(item)) {
+            updateItemIndex(item);
+        }
     }
 
+    const ZOrderedItems &sortedItems = item->parentItem() ? siblings : mLayerIndex[curItemLayerType];
+
     //If only one item itself - do nothing, return it's z-value
-    if (sortedItems.count() == 1 && sortedItems.values().first() == item) {
+    if (sortedItems.count() <= 1) {
         qDebug() << "only one item exists in layer. Have nothing to change";
-        return item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
+        return itemZ;
     }
 
-    QMapIterator<qreal, QGraphicsItem*>iCurElement(sortedItems);
-
+    //neighbours are read before any z value is assigned, assignments update the index
     if (dest == up) {
-        if (iCurElement.findNext(item)) {
-            if (iCurElement.hasNext()) {
-                qreal nextZ = iCurElement.peekNext().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                UBGraphicsItem::assignZValue(iCurElement.peekNext().value(), item->data(UBGraphicsItemData::ItemOwnZValue).toReal());
-                UBGraphicsItem::assignZValue(item, nextZ);
-
-                iCurElement.next();
-
-                while (iCurElement.hasNext() && iCurElement.peekNext().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal() == nextZ) {
-                    UBGraphicsItem::assignZValue(iCurElement.next().value(), nextZ);
-                }
-            }
+        ZOrderedItems::const_iterator next = sortedItems.upperBound(itemZ);
+        if (next != sortedItems.constEnd()) {
+            QGraphicsItem *nextItem = next.value();
+            qreal nextZ = next.key();
+            UBGraphicsItem::assignZValue(nextItem, itemZ);
+            UBGraphicsItem::assignZValue(item, nextZ);
         }
 
     } else if (dest == top) {
-        if (iCurElement.findNext(item)) {
-            if (iCurElement.hasNext()) {
-                UBGraphicsItem::assignZValue(item, generateZLevel(item));
-            }
+        ZOrderedItems::const_iterator last = sortedItems.constEnd() - 1;
+        if (last.value() != item) {
+            UBGraphicsItem::assignZValue(item, zValueAbove(curItemLayerType, last.key(), !item->parentItem()));
         }
 
     } else if (dest == down) {
-        iCurElement.toBack();
-        if (iCurElement.findPrevious(item)) {
-            if (iCurElement.hasPrevious()) {
-                qreal nextZ = iCurElement.peekPrevious().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                UBGraphicsItem::assignZValue(iCurElement.peekPrevious().value(), item->data(UBGraphicsItemData::ItemOwnZValue).toReal());
-                UBGraphicsItem::assignZValue(item, nextZ);
-
-                while (iCurElement.hasNext() && iCurElement.peekNext().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal() == nextZ) {
-                        UBGraphicsItem::assignZValue(iCurElement.next().value(), nextZ);
-                }
-            }
+        ZOrderedItems::const_iterator previous = sortedItems.lowerBound(itemZ);
+        if (previous != sortedItems.constBegin()) {
+            --previous;
+            QGraphicsItem *previousItem = previous.value();
+            qreal previousZ = previous.key();
+            UBGraphicsItem::assignZValue(previousItem, itemZ);
+            UBGraphicsItem::assignZValue(item, previousZ);
         }
 
     } else if (dest == bottom) {
-        iCurElement.toBack();
-        if (iCurElement.findPrevious(item)) {
-            if (iCurElement.hasPrevious()) {
-//                qreal oldz = iCurElement.peekPrevious().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                qreal oldz = item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                iCurElement.toFront();
-                qreal nextZ = iCurElement.next().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-
-                ItemLayerTypeData curItemLayerTypeData = scopeMap.value(curItemLayerType);
-//
-                //if we have some free space between lowest graphics item and layer's bottom bound,
-                //insert element close to first element in layer
-                if (nextZ >= curItemLayerTypeData.bottomLimit + curItemLayerTypeData.incStep) {
-                    qreal result = nextZ - curItemLayerTypeData.incStep;
-                    UBGraphicsItem::assignZValue(item, result);
-                } else {
-                    UBGraphicsItem::assignZValue(item, nextZ);
-                    bool doubleGap = false; //to detect if we can finish rundown since we can insert item to the free space
-
-                    while (iCurElement.peekNext().value() != item) {
-                        qreal curZ = iCurElement.value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                        qreal curNextZ = iCurElement.peekNext().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal();
-                        if (curNextZ - curZ >= 2 * curItemLayerTypeData.incStep) {
-                            UBGraphicsItem::assignZValue(iCurElement.value(), curZ + curItemLayerTypeData.incStep);
-                            doubleGap = true;
-                            break;
-                        } else {
-                            UBGraphicsItem::assignZValue(iCurElement.value(), iCurElement.next().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal());
-                        }
-                    }
-                    if (!doubleGap) {
-
-                        UBGraphicsItem::assignZValue(iCurElement.value(), oldz);
-
-                        while (iCurElement.hasNext() && (iCurElement.peekNext().value()->data(UBGraphicsItemData::ItemOwnZValue).toReal() == oldz)) {
-                            UBGraphicsItem::assignZValue(iCurElement.next().value(), oldz);
-                        }
-                    }
-                }
-            }
+        ZOrderedItems::const_iterator first = sortedItems.constBegin();
+        if (first.value() != item) {
+            UBGraphicsItem::assignZValue(item, zValueBelow(curItemLayerType, first.key(), !item->parentItem()));
         }
     }
 
-
     //clear selection of the item and then select it again to activate selectionChangeProcessing()
     item->scene()->clearSelection();
     item->setSelected(true);
@@ -238,6 +202,123 @@ qreal UBZLayerController::changeZLevelTo(QGraphicsItem *item, moveDestination de
     return item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
 }
 
+qreal UBZLayerController::zValueAbove(itemLayerType::Enum key, qreal topMostZ, bool canRenumber)
+{
+    ItemLayerTypeData &data = scopeMap[key];
+
+    qreal result = topMostZ + data.incStep;
+    if (result >= data.topLimit) {
+        //no whole step left, use the middle of the remaining space until precision runs out
+        result = (topMostZ + data.topLimit) / 2;
+        if (result <= topMostZ || result >= data.topLimit) {
+            if (!canRenumber || !renumberLayer(key)) {
+                return topMostZ;
+            }
+            return zValueAbove(key, data.curValue, false);
+        }
+    }
+
+    data.curValue = qMax(data.curValue, result);
+
+    return result;
+}
+
+qreal UBZLayerController::zValueBelow(itemLayerType::Enum key, qreal bottomMostZ, bool canRenumber)
+{
+    const ItemLayerTypeData &data = scopeMap[key];
+
+    qreal result = bottomMostZ - data.incStep;
+    if (result < data.bottomLimit) {
+        result = (bottomMostZ + data.bottomLimit) / 2;
+        if (result < data.bottomLimit || result >= bottomMostZ) {
+            if (!canRenumber || !renumberLayer(key)) {
+                return bottomMostZ;
+            }
+            return zValueBelow(key, mLayerIndex.value(key).constBegin().key(), false);
+        }
+    }
+
+    return result;
+}
+
+bool UBZLayerController::renumberLayer(itemLayerType::Enum key)
+{
+    ItemLayerTypeData &data = scopeMap[key];
+    QList<QGraphicsItem*> orderedItems = mLayerIndex.value(key).values();
+
+    qreal step = qMin(data.incStep, (data.topLimit - data.bottomLimit) / (orderedItems.count() + 2));
+    if (step <= 0) {
+        qDebug() << "no room left to reorder items of the scope" << key;
+        return false;
+    }
+
+    //spread the items evenly from the bottom of the layer, keeping their order
+    qreal z = data.bottomLimit + step;
+    foreach (QGraphicsItem *orderedItem, orderedItems) {
+        UBGraphicsItem::assignZValue(orderedItem, z);
+        z += step;
+    }
+
+    data.curValue = z - step;
+
+    return true;
+}
+
+void UBZLayerController::ensureIndex()
+{
+    if (mIndexValid) {
+        return;
+    }
+
+    mLayerIndex.clear();
+    mIndexEntries.clear();
+    mIndexValid = true;
+
+    foreach (QGraphicsItem *item, mScene->items()) {
+        if (!item->parentItem()) {
+            updateItemIndex(item);
+        }
+    }
+}
+
+void UBZLayerController::updateItemIndex(QGraphicsItem *item)
+{
+    if (!mIndexValid) {
+        return;
+    }
+
+    removeItemIndex(item);
+
+    if (item->scene() != mScene || item->parentItem()) {
+        return;
+    }
+
+    itemLayerType::Enum type = typeForData(item);
+    if (type == itemLayerType::NoLayer) {
+        return;
+    }
+
+    qreal z = item->data(UBGraphicsItemData::ItemOwnZValue).toReal();
+
+    mIndexEntries.insert(item, IndexEntry(type, z));
+    mLayerIndex[type].insert(z, item);
+}
+
+void UBZLayerController::removeItemIndex(QGraphicsItem *item)
+{
+    if (!mIndexValid) {
+        return;
+    }
+
+    QHash<QGraphicsItem*, IndexEntry>::iterator entry = mIndexEntries.find(item);
+    if (entry == mIndexEntries.end()) {
+        return;
+    }
+
+    mLayerIndex[entry.value().layerType].remove(entry.value().zValue, item);
+    mIndexEntries.erase(entry);
+}
+
 itemLayerType::Enum UBZLayerController::typeForData(QGraphicsItem *item) const
 {
     itemLayerType::Enum result = static_cast<itemLayerType::Enum>(item->data(UBGraphicsItemData::itemLayerType).toInt());
@@ -252,6 +333,7 @@ itemLayerType::Enum UBZLayerController::typeForData(QGraphicsItem *item) const
 void UBZLayerController::setLayerType(QGraphicsItem *pItem, itemLayerType::Enum pNewType)
 {
    pItem->setData(UBGraphicsItemData::itemLayerType, QVariant(pNewType));
+   updateItemIndex(pItem);
 }
 
 UBGraphicsScene::UBGraphicsScene(UBDocumentProxy* parent)
@@ -272,11 +354,14 @@ UBGraphicsScene::UBGraphicsScene(UBDocumentProxy* parent)
     , mCurrentStroke(0)
     , mShouldUseOMP(true)
     , mItemCount(0)
+    , mItemBatchDepth(0)
+    , mBatchIndexMethod(QGraphicsScene::BspTreeIndex)
     , enableUndoRedoStack(true)
     , magniferControlViewWidget(0)
     , magniferDisplayViewWidget(0)
     , mZLayerController(new UBZLayerController(this))
     , mpLastPolygon(NULL)
+    , mEraserEngine(new UBEraserEngine())
 {
     UBCoreGraphicsScene::setObjectName("BoardScene");
 #ifdef __ppc__
@@ -309,6 +394,9 @@ UBGraphicsScene::~UBGraphicsScene()
 
     if (mZLayerController)
         delete mZLayerController;
+    mZLayerController = 0;
+
+    delete mEraserEngine;
 }
 
 void UBGraphicsScene::selectionChangedProcessing()
@@ -417,6 +505,9 @@ bool UBGraphicsScene::inputDevicePress(const QPointF& scenePos, const qreal& pre
             mRemovedItems.clear();
             moveTo(scenePos);
 
+            // strokes are indexed again for each eraser gesture
+            mEraserEngine->clear();
+
             qreal eraserWidth = UBSettings::settings()->currentEraserWidth();
             eraserWidth /= UBApplication::boardController->systemScaleFactor();
             eraserWidth /= UBApplication::boardController->currentZoom();
@@ -614,6 +705,8 @@ bool UBGraphicsScene::inputDeviceRelease()
 
     mInputDeviceIsPressed = false;
 
+    mEraserEngine->clear();
+
     setDocumentUpdated();
 
     return accepted;
@@ -751,59 +844,28 @@ void UBGraphicsScene::eraseLineTo(const QPointF &pEndPoint, const qreal &pWidth)
     mPreviousPoint = pEndPoint;
 
     const QPolygonF eraserPolygon = UBGeometryUtils::lineToPolygon(line, pWidth);
-    const QRectF eraserBoundingRect = eraserPolygon.boundingRect();
-
-    QPainterPath eraserPath;
-    eraserPath.addPolygon(eraserPolygon);
-
-    // Get all the items that are intersecting with the eraser path
-    QList<QGraphicsItem*> collidItems = items(eraserBoundingRect, Qt::IntersectsItemBoundingRect);
 
-    QList<UBGraphicsPolygonItem*> intersectedItems;
-    QList<QPolygonF> intersectedPolygons;
+    // The stroke segments are only indexed once per eraser gesture, the index stays
+    // valid as erasing can only shrink or remove them
+    if (!mEraserEngine->isValid())
+        mEraserEngine->build(items());
 
-    #pragma omp parallel for
-    for(int i=0; i<collidItems.size(); i++)
-    {
-        UBGraphicsPolygonItem *pi = qgraphicsitem_cast<UBGraphicsPolygonItem*>(collidItems[i]);
-        if(pi == NULL)
-            continue;
+    QList<UBEraserEngine::Result> erasedItems = mEraserEngine->erase(eraserPolygon, mShouldUseOMP);
 
-        QPainterPath itemPainterPath;
-        itemPainterPath.addPolygon(pi->sceneTransform().map(pi->polygon()));
-        if (eraserPath.contains(itemPainterPath))
-        {
-            #pragma omp critical
-            {
-                // Compele remove item
-                intersectedItems << pi;
-                intersectedPolygons << QPolygonF();
-            }
-        }
-        else if (eraserPath.intersects(itemPainterPath))
-        {   
-            QPainterPath newPath = itemPainterPath.subtracted(eraserPath);
-            #pragma omp critical
-            {
-               intersectedItems << pi;
-               intersectedPolygons << newPath.simplified().toFillPolygon(pi->sceneTransform().inverted());
-            }
-        }
-    }
-
-    for(int i=0; i<intersectedItems.size(); i++)
+    foreach(const UBEraserEngine::Result& erased, erasedItems)
     {
-        if (intersectedPolygons[i].empty())
+        if (erased.polygon.empty())
         {
-            removeItem(intersectedItems[i]);
+            mEraserEngine->remove(erased.item);
+            removeItem(erased.item);
         }
         else
         {
-            intersectedItems[i]->setPolygon(intersectedPolygons[i]);
+            erased.item->setPolygon(erased.polygon);
         }
     }
 
-    if (!intersectedItems.empty())
+    if (!erasedItems.empty())
         setModified(true);
 }
 
@@ -850,7 +912,9 @@ void UBGraphicsScene::setBackground(bool pIsDark, bool pIsCrossed)
             }
         }
 
-        recolorAllItems();
+        // strokes take their colour from the palette side of the background when painted,
+        // nothing is recoloured, the items are only repainted
+        update();
 
         needRepaint = true;
         setModified(true);
@@ -882,43 +946,6 @@ void UBGraphicsScene::setDrawingMode(bool bModeDesktop)
     mIsDesktopMode = bModeDesktop;
 }
 
-void UBGraphicsScene::recolorAllItems()
-{
-    QMap<QGraphicsView*, QGraphicsView::ViewportUpdateMode> previousUpdateModes;
-    foreach(QGraphicsView* view, views())
-    {
-        previousUpdateModes.insert(view, view->viewportUpdateMode());
-        view->setViewportUpdateMode(QGraphicsView::NoViewportUpdate);
-    }
-
-    for(int i = 0; i < mFastAccessItems.size(); i++)
-    {
-        UBGraphicsPolygonItem *polygonItem = qgraphicsitem_cast<UBGraphicsPolygonItem*> (mFastAccessItems.at(i));
-
-        if (polygonItem)
-        {
-            QColor color;
-
-            if (mDarkBackground)
-            {
-                color = polygonItem->colorOnDarkBackground();
-            }
-            else
-            {
-                color = polygonItem->colorOnLightBackground();
-            }
-
-            polygonItem->setColor(color);
-            continue;
-        }
-    }
-
-    foreach(QGraphicsView* view, views())
-    {
-        view->setViewportUpdateMode(previousUpdateModes.value(view));
-    }
-}
-
 UBGraphicsPolygonItem* UBGraphicsScene::lineToPolygonItem(const QLineF &pLine, const qreal &pWidth)
 {
     UBGraphicsPolygonItem *polygonItem = new UBGraphicsPolygonItem(pLine, pWidth);
@@ -953,8 +980,7 @@ void UBGraphicsScene::initPolygonItem(UBGraphicsPolygonItem* polygonItem)
         polygonItem->setColor(colorOnLightBG);
     }
 
-    polygonItem->setColorOnDarkBackground(colorOnDarkBG);
-    polygonItem->setColorOnLightBackground(colorOnLightBG);
+    polygonItem->setColorsOnBackgrounds(colorOnDarkBG, colorOnLightBG);
 
     polygonItem->setData(UBGraphicsItemData::ItemLayerType, QVariant(UBItemLayerType::Graphic));
 }
@@ -997,6 +1023,8 @@ UBGraphicsScene* UBGraphicsScene::sceneDeepCopy() const
     if (this->mNominalSize.isValid())
         copy->setNominalSize(this->mNominalSize);
 
+    copy->setTeacherGuide(this->mTeacherGuide);
+
     QListIterator<QGraphicsItem*> itItems(this->mFastAccessItems);
 
     QMap<UBGraphicsStroke*, UBGraphicsStroke*> groupClone;
@@ -1241,12 +1269,10 @@ UBGraphicsMediaItem* UBGraphicsScene::addMedia(const QUrl& pMediaFileUrl, bool s
         UBApplication::undoStack->push(uc);
     }
 
-    mediaItem->mediaObject()->play();
-
-    if (!shouldPlayAsap)
+    if (shouldPlayAsap)
     {
-        mediaItem->mediaObject()->pause();
-        mediaItem->mediaObject()->seek(0);
+        mediaItem->loadPipeline();
+        mediaItem->mediaObject()->play();
     }
 
     setDocumentUpdated();
@@ -1572,46 +1598,148 @@ void UBGraphicsScene::addItem(QGraphicsItem* item)
     if (!mTools.contains(item))
       ++mItemCount;
 
-    mFastAccessItems << item;
+    fastAccessItemAdded(item);
 }
 
 void UBGraphicsScene::addItems(const QSet<QGraphicsItem*>& items)
 {
     setModified(true);
 
+    beginItemBatch(items.size());
+
     foreach(QGraphicsItem* item, items) {
         UBCoreGraphicsScene::addItem(item);
         UBGraphicsItem::assignZValue(item, mZLayerController->generateZLevel(item));
+        fastAccessItemAdded(item);
     }
 
     mItemCount += items.size();
 
-    mFastAccessItems += items.toList();
+    endItemBatch();
 }
 
 void UBGraphicsScene::removeItem(QGraphicsItem* item)
 {
     setModified(true);
     UBCoreGraphicsScene::removeItem(item);
+    mZLayerController->removeItemIndex(item);
     UBApplication::boardController->freezeW3CWidget(item, true);
 
     if (!mTools.contains(item))
       --mItemCount;
 
-    mFastAccessItems.removeAll(item);
+    fastAccessItemRemoved(item);
+}
+
+bool UBGraphicsScene::deleteItem(QGraphicsItem* item)
+{
+    mZLayerController->removeItemIndex(item);
+
+    return UBCoreGraphicsScene::deleteItem(item);
 }
 
 void UBGraphicsScene::removeItems(const QSet<QGraphicsItem*>& items)
 {
     setModified(true);
 
-    foreach(QGraphicsItem* item, items)
+    beginItemBatch(items.size());
+
+    foreach(QGraphicsItem* item, items) {
+        fastAccessItemRemoved(item);
         UBCoreGraphicsScene::removeItem(item);
+        mZLayerController->removeItemIndex(item);
+    }
 
     mItemCount -= items.size();
 
-    foreach(QGraphicsItem* item, items)
+    endItemBatch();
+}
+
+void UBGraphicsScene::beginItemBatch(int pItemCount)
+{
+    if (mItemBatchDepth++ > 0)
+        return;
+
+    mBatchDirtyRect = QRectF();
+    mBatchSelection = selectedItems();
+
+    // rebuilt once on next use rather than updated per item
+    mZLayerController->invalidateIndex();
+
+    // the BSP tree is rebuilt once at the end instead of being updated per item, worth it
+    // when the batch changes a good part of the page
+    mBatchIndexMethod = itemIndexMethod();
+
+    if (mBatchIndexMethod == QGraphicsScene::BspTreeIndex && pItemCount * sUnindexedBatchRatio >= mItemCount)
+        setItemIndexMethod(QGraphicsScene::NoIndex);
+}
+
+void UBGraphicsScene::endItemBatch()
+{
+    if (mItemBatchDepth <= 0 || --mItemBatchDepth > 0)
+        return;
+
+    // one pass over the list instead of a removeAll per item
+    if (!mBatchRemovedItems.isEmpty())
+    {
+        QList<QGraphicsItem*> remainingItems;
+        remainingItems.reserve(mFastAccessItems.size());
+
+        foreach(QGraphicsItem* item, mFastAccessItems)
+        {
+            if (!mBatchRemovedItems.contains(item))
+                remainingItems << item;
+        }
+
+        mFastAccessItems = remainingItems;
+    }
+
+    mFastAccessItems += mBatchAddedItems;
+
+    mBatchAddedItems.clear();
+    mBatchRemovedItems.clear();
+
+    if (itemIndexMethod() != mBatchIndexMethod)
+        setItemIndexMethod(mBatchIndexMethod);
+
+    // QGraphicsScene emits changed once for the updates of the whole batch
+    if (selectedItems().toSet() != mBatchSelection.toSet())
+        emit selectionChanged();
+
+    mBatchSelection.clear();
+
+    if (!mBatchDirtyRect.isEmpty())
+        update(mBatchDirtyRect);
+}
+
+void UBGraphicsScene::fastAccessItemAdded(QGraphicsItem* item)
+{
+    if (mItemBatchDepth == 0)
+    {
+        mFastAccessItems << item;
+        return;
+    }
+
+    mBatchDirtyRect |= item->sceneBoundingRect();
+
+    // removed earlier in the same batch, it never left the list
+    if (!mBatchRemovedItems.remove(item))
+        mBatchAddedItems << item;
+}
+
+void UBGraphicsScene::fastAccessItemRemoved(QGraphicsItem* item)
+{
+    if (mItemBatchDepth == 0)
+    {
         mFastAccessItems.removeAll(item);
+        return;
+    }
+
+    mBatchDirtyRect |= item->sceneBoundingRect();
+
+    // added earlier in the same batch, it never made it to the list
+    if (!mBatchAddedItems.removeOne(item))
+        mBatchRemovedItems << item;
 }
 
 void UBGraphicsScene::deselectAllItems()
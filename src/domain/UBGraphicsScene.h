@@ -22,6 +22,8 @@
 
 #include "core/UB.h"
 
+#include "interfaces/IDataStorage.h"
+
 #include "UBItem.h"
 #include "tools/UBGraphicsCurtainItem.h"
 
@@ -48,6 +50,7 @@ class UBMagnifierParams;
 class UBMagnifier;
 class UBGraphicsCache;
 class UBGraphicsGroupContainerItem;
+class UBEraserEngine;
 
 const double PI = 4.0 * atan(1.0);
 
@@ -89,10 +92,35 @@ public:
     itemLayerType::Enum typeForData(QGraphicsItem *item) const;
     void setLayerType(QGraphicsItem *pItem, itemLayerType::Enum pNewType);
 
+    //keep the z-order index in step with the scene, items are expected to go through these before being deleted
+    void updateItemIndex(QGraphicsItem *item);
+    void removeItemIndex(QGraphicsItem *item);
+    //for bulk changes, the index is rebuilt from the scene on next use
+    void invalidateIndex() {mIndexValid = false;}
+
 private:
+    typedef QMultiMap<qreal, QGraphicsItem*> ZOrderedItems;
+
+    struct IndexEntry {
+        IndexEntry() : layerType(itemLayerType::NoLayer), zValue(0) {;}
+        IndexEntry(itemLayerType::Enum type, qreal z) : layerType(type), zValue(z) {;}
+        itemLayerType::Enum layerType;
+        qreal zValue;
+    };
+
+    void ensureIndex();
+    qreal zValueAbove(itemLayerType::Enum key, qreal topMostZ, bool canRenumber);
+    qreal zValueBelow(itemLayerType::Enum key, qreal bottomMostZ, bool canRenumber);
+    bool renumberLayer(itemLayerType::Enum key);
+
     ScopeMap scopeMap;
     static qreal errorNumber;
     QGraphicsScene *mScene;
+
+    //top level items of each layer ordered by their own z value, built on first use
+    QMap<itemLayerType::Enum, ZOrderedItems> mLayerIndex;
+    QHash<QGraphicsItem*, IndexEntry> mIndexEntries;
+    bool mIndexValid;
 };
 
 class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem
@@ -127,10 +155,17 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem
 
         void addItem(QGraphicsItem* item);
         void removeItem(QGraphicsItem* item);
+        virtual bool deleteItem(QGraphicsItem* item);
 
         void addItems(const QSet<QGraphicsItem*>& item);
         void removeItems(const QSet<QGraphicsItem*>& item);
 
+        // Adds and removes made between these calls update the item list, emit the selection
+        // change and repaint the affected area only once, when the outermost batch ends.
+        // pItemCount is how many items the batch is about to add or remove, if known
+        void beginItemBatch(int pItemCount = 0);
+        void endItemBatch();
+
         UBGraphicsWidgetItem* addWidget(const QUrl& pWidgetUrl, const QPointF& pPos = QPointF(0, 0));
         UBGraphicsAppleWidgetItem* addAppleWidget(const QUrl& pWidgetUrl, const QPointF& pPos = QPointF(0, 0));
         UBGraphicsW3CWidgetItem* addW3CWidget(const QUrl& pWidgetUrl, const QPointF& pPos = QPointF(0, 0));
@@ -211,6 +246,12 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem
             return mCrossedBackground;
         }
 
+        // whether the eraser splits its work over threads, what it erases must not depend on it
+        void setShouldUseOMP(bool pShouldUseOMP)
+        {
+            mShouldUseOMP = pShouldUseOMP;
+        }
+
         bool hasBackground()
         {
             return (mBackgroundObject != 0);
@@ -272,8 +313,24 @@ class UBGraphicsScene: public UBCoreGraphicsScene, public UBItem
 
         void setNominalSize(int pWidth, int pHeight);
 
+        // children of the page teacher guide node, in document order
+        QList<tIDataStorage> teacherGuide() const
+        {
+            return mTeacherGuide;
+        }
+
+        void setTeacherGuide(const QList<tIDataStorage>& pTeacherGuide)
+        {
+            mTeacherGuide = pTeacherGuide;
+        }
+
         qreal changeZLevelTo(QGraphicsItem *item, UBZLayerController::moveDestination dest);
 
+        UBZLayerController* zLayerController() const
+        {
+            return mZLayerController;
+        }
+
         enum RenderingContext
         {
             Screen = 0, NonScreen, PdfExport, Podcast
@@ -353,8 +410,6 @@ public slots:
 
         virtual void keyReleaseEvent(QKeyEvent * keyEvent);
 
-        void recolorAllItems();
-
        virtual void drawItems (QPainter * painter, int numItems,
                 QGraphicsItem * items[], const QStyleOptionGraphicsItem options[], QWidget * widget = 0);
 
@@ -367,6 +422,9 @@ public slots:
         void createEraiser();
         void createPointer();
 
+        void fastAccessItemAdded(QGraphicsItem* item);
+        void fastAccessItemRemoved(QGraphicsItem* item);
+
         QGraphicsEllipseItem* mEraser;
         QGraphicsEllipseItem* mPointer;
 
@@ -399,6 +457,8 @@ public slots:
 
         QSize mNominalSize;
 
+        QList<tIDataStorage> mTeacherGuide;
+
         RenderingContext mRenderingContext;
 
         UBGraphicsStroke* mCurrentStroke;
@@ -409,6 +469,13 @@ public slots:
 
         QList<QGraphicsItem*> mFastAccessItems; // a local copy as QGraphicsScene::items() is very slow in Qt 4.6
 
+        int mItemBatchDepth;
+        QList<QGraphicsItem*> mBatchAddedItems;
+        QSet<QGraphicsItem*> mBatchRemovedItems;
+        QRectF mBatchDirtyRect;
+        QList<QGraphicsItem*> mBatchSelection;
+        QGraphicsScene::ItemIndexMethod mBatchIndexMethod;
+
         //int mMesure1Ms, mMesure2Ms;
 
         bool mHasCache;
@@ -421,6 +488,8 @@ public slots:
         UBZLayerController *mZLayerController;
         UBGraphicsPolygonItem* mpLastPolygon;
 
+        UBEraserEngine* mEraserEngine;
+
         bool mDrawWithCompass;
 
 };
@@ -30,10 +30,20 @@
 
 QColor UBGraphicsTextItem::lastUsedTextColor;
 
+// eighths of an octave, the raster is never scaled down by more than 9%
+static const int sScaleBucketsPerOctave = 8;
+
+// bigger text boxes, or text seen that close, are painted directly
+static const int sMaxRenderCachePixels = 1024 * 1024;
+
+// the control and the display view
+static const int sMaxRenderCacheEntries = 2;
+
 UBGraphicsTextItem::UBGraphicsTextItem(QGraphicsItem * parent)
     : QGraphicsTextItem(parent)
     , mMultiClickState(0)
     , mLastMousePressTime(QTime::currentTime())
+    , mRenderCacheRevision(-1)
 {
     mDelegate = new UBGraphicsTextItemDelegate(this, 0);
     mDelegate->init();
@@ -58,22 +68,28 @@ UBGraphicsTextItem::UBGraphicsTextItem(QGraphicsItem * parent)
 
     setUuid(QUuid::createUuid());
 
-    connect(document(), SIGNAL(contentsChanged()), mDelegate, SLOT(contentsChanged()));
-    connect(document(), SIGNAL(undoCommandAdded()), this, SLOT(undoCommandAdded()));
-
-    connect(document()->documentLayout(), SIGNAL(documentSizeChanged(const QSizeF &)),
-            this, SLOT(documentSizeChanged(const QSizeF &)));
-
+    connectDocument();
 }
 
 UBGraphicsTextItem::~UBGraphicsTextItem()
 {
+    clearRenderCache();
+
     if (mDelegate)
     {
         delete mDelegate;
     }
 }
 
+void UBGraphicsTextItem::connectDocument()
+{
+    connect(document(), SIGNAL(contentsChanged()), mDelegate, SLOT(contentsChanged()));
+    connect(document(), SIGNAL(undoCommandAdded()), this, SLOT(undoCommandAdded()));
+
+    connect(document()->documentLayout(), SIGNAL(documentSizeChanged(const QSizeF &)),
+            this, SLOT(documentSizeChanged(const QSizeF &)));
+}
+
 QVariant UBGraphicsTextItem::itemChange(GraphicsItemChange change, const QVariant &value)
 {
     QVariant newValue = value;
@@ -198,14 +214,19 @@ void UBGraphicsTextItem::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 void UBGraphicsTextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     QColor color = UBSettings::settings()->isDarkBackground() ? mColorOnDarkBackground : mColorOnLightBackground;
-    setDefaultTextColor(color);
+    if (defaultTextColor() != color)
+        setDefaultTextColor(color);
 
     // Never draw the rubber band, we draw our custom selection with the DelegateFrame
     QStyleOptionGraphicsItem styleOption = QStyleOptionGraphicsItem(*option);
     styleOption.state &= ~QStyle::State_Selected;
     styleOption.state &= ~QStyle::State_HasFocus;
 
-    QGraphicsTextItem::paint(painter, &styleOption, widget);
+    // while editing the cursor and the selection must show, without a widget it is an export or a print
+    bool painted = widget && !hasFocus() && paintFromCache(painter, &styleOption, widget);
+
+    if (!painted)
+        QGraphicsTextItem::paint(painter, &styleOption, widget);
 
     if (widget == UBApplication::boardController->controlView()->viewport() &&
             !isSelected() && toPlainText().isEmpty())
@@ -217,6 +238,98 @@ void UBGraphicsTextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem
 }
 
 
+bool UBGraphicsTextItem::paintFromCache(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    QRectF bounds = boundingRect().united(QRectF(QPointF(), document()->size()));
+
+    qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+
+    if (bounds.isEmpty() || scale <= 0)
+        return false;
+
+    // rendered at the top of its bucket, so the raster is only ever scaled down
+    int scaleBucket = qCeil(qLn(scale) / qLn(2.0) * sScaleBucketsPerOctave);
+    qreal cacheScale = qPow(2.0, qreal(scaleBucket) / sScaleBucketsPerOctave);
+
+    QSize pixmapSize(qCeil(bounds.width() * cacheScale), qCeil(bounds.height() * cacheScale));
+
+    if (pixmapSize.width() * pixmapSize.height() > sMaxRenderCachePixels)
+        return false;
+
+    bool isContentValid = document()->revision() == mRenderCacheRevision
+            && bounds.size() == mRenderCacheSize
+            && defaultTextColor() == mRenderCacheColor
+            && font() == mRenderCacheFont;
+
+    if (!isContentValid)
+        clearRenderCache();
+
+    QPixmap pixmap;
+    bool isValid = false;
+
+    for (int i = 0; i < mRenderCacheEntries.size(); i++)
+    {
+        if (mRenderCacheEntries.at(i).scaleBucket != scaleBucket)
+            continue;
+
+        RenderCacheEntry entry = mRenderCacheEntries.takeAt(i);
+        isValid = QPixmapCache::find(entry.key, &pixmap);
+
+        if (isValid)
+            mRenderCacheEntries.prepend(entry);
+
+        break;
+    }
+
+    if (!isValid)
+    {
+        pixmap = QPixmap(pixmapSize);
+        pixmap.fill(Qt::transparent);
+
+        QPainter cachePainter(&pixmap);
+        cachePainter.setRenderHints(painter->renderHints());
+        cachePainter.scale(cacheScale, cacheScale);
+        cachePainter.translate(-bounds.topLeft());
+
+        QStyleOptionGraphicsItem cacheOption(*option);
+        cacheOption.exposedRect = bounds;
+
+        QGraphicsTextItem::paint(&cachePainter, &cacheOption, widget);
+        cachePainter.end();
+
+        RenderCacheEntry entry;
+        entry.key = QPixmapCache::insert(pixmap);
+        entry.scaleBucket = scaleBucket;
+        mRenderCacheEntries.prepend(entry);
+
+        while (mRenderCacheEntries.size() > sMaxRenderCacheEntries)
+            QPixmapCache::remove(mRenderCacheEntries.takeLast().key);
+
+        mRenderCacheRevision = document()->revision();
+        mRenderCacheSize = bounds.size();
+        mRenderCacheColor = defaultTextColor();
+        mRenderCacheFont = font();
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->drawPixmap(bounds, pixmap, QRectF(pixmap.rect()));
+    painter->restore();
+
+    return true;
+}
+
+
+void UBGraphicsTextItem::clearRenderCache()
+{
+    foreach(const RenderCacheEntry& entry, mRenderCacheEntries)
+        QPixmapCache::remove(entry.key);
+
+    mRenderCacheEntries.clear();
+    mRenderCacheRevision = -1;
+}
+
+
 UBItem* UBGraphicsTextItem::deepCopy() const
 {
     UBGraphicsTextItem* copy = new UBGraphicsTextItem();
@@ -233,7 +346,9 @@ void UBGraphicsTextItem::copyItemParameters(UBItem *copy) const
     UBGraphicsTextItem *cp = dynamic_cast<UBGraphicsTextItem*>(copy);
     if (cp)
     {
-        cp->setHtml(toHtml());
+        // no need to go through html, the copy gets its own document
+        cp->setDocument(document()->clone(cp));
+        cp->connectDocument();
         cp->setPos(this->pos());
         cp->setTransform(this->transform());
         cp->setFlag(QGraphicsItem::ItemIsMovable, true);
@@ -306,7 +421,7 @@ void UBGraphicsTextItem::contentsChanged()
         scene()->setModified(true);
     }
 
-    if (toPlainText().isEmpty())
+    if (document()->isEmpty())
     {
         setTextWidth(textWidth());
     }
@@ -355,5 +470,9 @@ void UBGraphicsTextItem::remove()
 
 void UBGraphicsTextItem::documentSizeChanged(const QSizeF & newSize)
 {
+    // the layout reports the same size again on every change while loading
+    if (newSize == size())
+        return;
+
     resize(newSize.width(), newSize.height());
 }
@@ -102,6 +102,13 @@ class UBGraphicsTextItem : public QGraphicsTextItem, public UBItem, public UBRes
 
         virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
+        void connectDocument();
+
+        // draws the text from a raster kept in QPixmapCache, one per scale bucket for the views
+        // showing it at different scales, false when it cannot be used
+        bool paintFromCache(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+        void clearRenderCache();
+
     private:
         qreal mTextHeight;
 
@@ -111,6 +118,21 @@ class UBGraphicsTextItem : public QGraphicsTextItem, public UBItem, public UBRes
 
         QColor mColorOnDarkBackground;
         QColor mColorOnLightBackground;
+
+        struct RenderCacheEntry
+        {
+            QPixmapCache::Key key;
+            int scaleBucket;
+        };
+
+        // most recently used first
+        QList<RenderCacheEntry> mRenderCacheEntries;
+
+        // what the cached rasters were rendered from
+        int mRenderCacheRevision;
+        QSizeF mRenderCacheSize;
+        QColor mRenderCacheColor;
+        QFont mRenderCacheFont;
 };
 
 #endif /* UBGRAPHICSTEXTITEM_H_ */
@@ -15,6 +15,8 @@
 
 #include "UBItem.h"
 
+#include "domain/UBGraphicsScene.h"
+
 #include "core/memcheck.h"
 
 UBItem::UBItem()
@@ -33,6 +35,22 @@ void UBGraphicsItem::assignZValue(QGraphicsItem *item, qreal value)
 {
     item->setZValue(value);
     item->setData(UBGraphicsItemData::ItemOwnZValue, value);
+
+    updateLayerIndex(item, item->scene());
+}
+
+void UBGraphicsItem::updateLayerIndex(QGraphicsItem *item, QGraphicsScene *pScene)
+{
+    UBGraphicsScene *scene = qobject_cast<UBGraphicsScene*>(pScene);
+    if (scene && scene->zLayerController())
+        scene->zLayerController()->updateItemIndex(item);
+}
+
+void UBGraphicsItem::removeFromLayerIndex(QGraphicsItem *item)
+{
+    UBGraphicsScene *scene = qobject_cast<UBGraphicsScene*>(item->scene());
+    if (scene && scene->zLayerController())
+        scene->zLayerController()->removeItemIndex(item);
 }
 
 bool UBGraphicsItem::isFlippable(QGraphicsItem *item)
@@ -105,6 +105,10 @@ protected:
 public:
 
     static void assignZValue(QGraphicsItem*, qreal value);
+    // to be called once the item has been reparented, pScene being the board scene it was in
+    static void updateLayerIndex(QGraphicsItem *item, QGraphicsScene *pScene);
+    // to be called before the item leaves its board scene or is deleted while still in it
+    static void removeFromLayerIndex(QGraphicsItem *item);
     static bool isRotatable(QGraphicsItem *item);
     static bool isFlippable(QGraphicsItem *item);
 
@@ -0,0 +1,99 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UBStrokePalette.h"
+
+#include "core/memcheck.h"
+
+QVector<UBStrokePalette::Role> UBStrokePalette::sRoles;
+QHash<QPair<quint64, quint64>, int> UBStrokePalette::sRoleIndexes;
+
+
+static quint64 colorKey(const QColor& pColor)
+{
+    // invalid colours get their own key, they are kept as they were set
+    return pColor.isValid() ? (Q_UINT64_C(1) << 32) | pColor.rgba() : 0;
+}
+
+
+int UBStrokePalette::role(const QColor& pColorOnDarkBackground, const QColor& pColorOnLightBackground)
+{
+    QPair<quint64, quint64> key(colorKey(pColorOnDarkBackground), colorKey(pColorOnLightBackground));
+
+    int index = sRoleIndexes.value(key, -1);
+
+    if (index < 0)
+    {
+        Role role;
+        role.onDarkBackground = makeColor(pColorOnDarkBackground);
+        role.onLightBackground = makeColor(pColorOnLightBackground);
+
+        index = sRoles.size();
+        sRoles << role;
+        sRoleIndexes.insert(key, index);
+    }
+
+    return index;
+}
+
+
+const UBStrokePalette::Color& UBStrokePalette::color(int pRole, bool pDarkBackground)
+{
+    const Role& role = sRoles.at(pRole);
+
+    return pDarkBackground ? role.onDarkBackground : role.onLightBackground;
+}
+
+
+QPen UBStrokePalette::pen(const QColor& pColor)
+{
+    if (pColor.alphaF() >= 1.0)
+        return Qt::NoPen;
+
+    QColor penColor = pColor;
+
+    // trick QT antialiasing
+    // TODO UB 4.x see if we can do better ... it does not behave well with 16 bit color depth
+    qreal trickAlpha = pColor.alphaF();
+
+    if (trickAlpha >= 0.2 && trickAlpha < 0.6)
+    {
+        trickAlpha /= 12;
+    }
+    else if (trickAlpha < 0.8)
+    {
+        trickAlpha /= 5;
+    }
+    else if (trickAlpha < 1.0)
+    {
+        trickAlpha /= 2;
+    }
+
+    penColor.setAlphaF(trickAlpha);
+
+    return QPen(penColor);
+}
+
+
+UBStrokePalette::Color UBStrokePalette::makeColor(const QColor& pColor)
+{
+    Color color;
+    color.color = pColor;
+    color.brush = QBrush(pColor);
+    color.pen = pen(pColor);
+    color.hasAlpha = pColor.alphaF() < 1.0;
+
+    return color;
+}
@@ -0,0 +1,65 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UBSTROKEPALETTE_H_
+#define UBSTROKEPALETTE_H_
+
+#include <QtGui>
+
+/*
+ * The colours strokes are painted with, by role. A role is the pair of colours a stroke
+ * takes on a dark and on a light background. Polygon items keep their role and the scene
+ * picks the side of the palette its background calls for when they are painted, so a
+ * background switch recolours nothing. The brush and pen of both sides are made once
+ * per role.
+ *
+ * Roles are shared by all scenes and never released, a session only ever sees a handful
+ * of distinct pen and marker colours. Like the scenes, the palette is used from the GUI
+ * thread only.
+ */
+class UBStrokePalette
+{
+    public:
+
+        struct Color
+        {
+            QColor color;
+            QBrush brush;
+            QPen pen;
+            bool hasAlpha;
+        };
+
+        static int role(const QColor& pColorOnDarkBackground, const QColor& pColorOnLightBackground);
+
+        static const Color& color(int pRole, bool pDarkBackground);
+
+        // outline that smooths the antialiased edges of translucent strokes, none for opaque ones
+        static QPen pen(const QColor& pColor);
+
+    private:
+
+        struct Role
+        {
+            Color onDarkBackground;
+            Color onLightBackground;
+        };
+
+        static Color makeColor(const QColor& pColor);
+
+        static QVector<Role> sRoles;
+        static QHash<QPair<quint64, quint64>, int> sRoleIndexes;
+};
+
+#endif /* UBSTROKEPALETTE_H_ */
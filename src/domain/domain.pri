@@ -25,7 +25,9 @@ HEADERS += src/domain/UBGraphicsScene.h \
     src/domain/UBGraphicsTextItemDelegate.h \
     src/domain/UBGraphicsDelegateFrame.h \
     src/domain/UBGraphicsWidgetItemDelegate.h \
-    src/domain/UBGraphicsMediaItemDelegate.h
+    src/domain/UBGraphicsMediaItemDelegate.h \
+    src/domain/UBEraserEngine.h \
+    src/domain/UBStrokePalette.h
     
 SOURCES += src/domain/UBGraphicsScene.cpp \
     src/domain/UBGraphicsItemUndoCommand.cpp \
@@ -55,4 +57,6 @@ SOURCES += src/domain/UBGraphicsScene.cpp \
     src/domain/UBGraphicsTextItemDelegate.cpp \
     src/domain/UBGraphicsMediaItemDelegate.cpp \
     src/domain/UBGraphicsDelegateFrame.cpp \
-    src/domain/UBGraphicsWidgetItemDelegate.cpp
+    src/domain/UBGraphicsWidgetItemDelegate.cpp \
+    src/domain/UBEraserEngine.cpp \
+    src/domain/UBStrokePalette.cpp
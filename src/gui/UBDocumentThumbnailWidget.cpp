@@ -73,7 +73,7 @@ void UBDocumentThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
         	QDrag *drag = new QDrag(this);
         	QList<UBMimeDataItem> mimeDataItems;
         	foreach (QGraphicsItem *item, selectedItems())
-        		mimeDataItems.append(UBMimeDataItem(sceneItem->proxy(), mGraphicItems.indexOf(item)));
+        		mimeDataItems.append(UBMimeDataItem(sceneItem->proxy(), graphicsItemIndex(item)));
 
         	UBMimeData *mime = new UBMimeData(mimeDataItems);
         	drag->setMimeData(mime);
@@ -220,7 +220,7 @@ void UBDocumentThumbnailWidget::dropEvent(QDropEvent *event)
 
     if (mClosestDropItem)
     {
-        int targetIndex = mDropIsRight ? mGraphicItems.indexOf(mClosestDropItem) + 1 : mGraphicItems.indexOf(mClosestDropItem);
+        int targetIndex = mDropIsRight ? graphicsItemIndex(mClosestDropItem) + 1 : graphicsItemIndex(mClosestDropItem);
         if(UBDocumentContainer::pageFromSceneIndex(targetIndex) == 0){
         	event->ignore();
         	return;
@@ -235,7 +235,7 @@ void UBDocumentThumbnailWidget::dropEvent(QDropEvent *event)
         }
 
         if (1 == mimeDataItems.count() &&
-            (mimeDataItems.at(0).sceneIndex() == mGraphicItems.indexOf(mClosestDropItem) ||
+            (mimeDataItems.at(0).sceneIndex() == graphicsItemIndex(mClosestDropItem) ||
              targetIndex == mimeDataItems.at(0).sceneIndex() ||
              targetIndex == mimeDataItems.at(0).sceneIndex() + 1))
         {
@@ -0,0 +1,57 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtGui>
+
+#include "UBPreviousPageView.h"
+
+#include "core/memcheck.h"
+
+UBPreviousPageView::UBPreviousPageView(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+
+UBPreviousPageView::~UBPreviousPageView()
+{
+    // NOOP
+}
+
+
+void UBPreviousPageView::setRendering(const QImage& pRendering)
+{
+    mRendering = pRendering;
+
+    update();
+}
+
+
+void UBPreviousPageView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+
+    if (!mRendering.isNull())
+    {
+        QRect target(QPoint(0, 0), mRendering.size());
+        target.moveCenter(rect().center());
+
+        painter.drawImage(target, mRendering);
+    }
+}
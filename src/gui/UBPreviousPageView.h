@@ -0,0 +1,44 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UBPREVIOUSPAGEVIEW_H_
+#define UBPREVIOUSPAGEVIEW_H_
+
+#include <QWidget>
+#include <QImage>
+
+/*
+ * Passive screen showing one of the pages before the current one. It paints a rendering
+ * of the page made for its resolution, the page scene itself is never attached to it.
+ */
+class UBPreviousPageView : public QWidget
+{
+    Q_OBJECT
+
+    public:
+        UBPreviousPageView(QWidget *parent = 0);
+        virtual ~UBPreviousPageView();
+
+        // a null rendering leaves the screen black
+        void setRendering(const QImage& pRendering);
+
+    protected:
+        virtual void paintEvent(QPaintEvent *event);
+
+    private:
+        QImage mRendering;
+};
+
+#endif /* UBPREVIOUSPAGEVIEW_H_ */
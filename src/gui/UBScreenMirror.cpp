@@ -19,13 +19,46 @@
 #include "core/UBSetting.h"
 #include "core/UBApplication.h"
 #include "board/UBBoardController.h"
+#include "board/UBBoardView.h"
+#include "domain/UBGraphicsScene.h"
 #include "core/memcheck.h"
 
+// side of the square blocks the desktop grab is compared by
+static const int sBlockSize = 32;
+
+// when more than this fraction of the grab changed, rescale for speed rather than quality
+static const qreal sSmoothScalingMaxChangedRatio = 0.25;
+
+// above that many pending scene rects, repaint their bounding rect instead
+static const int sMaxSceneDamageRects = 16;
+
+
+static uint blockHash(const QImage& pImage, const QRect& pBlock)
+{
+    // FNV-1a over the 32 bit pixels of the block
+    uint hash = 2166136261u;
+
+    for (int y = pBlock.top(); y <= pBlock.bottom(); y++)
+    {
+        const uint* pixel = reinterpret_cast<const uint*>(pImage.scanLine(y)) + pBlock.left();
+
+        for (int x = 0; x < pBlock.width(); x++)
+        {
+            hash = (hash ^ pixel[x]) * 16777619u;
+        }
+    }
+
+    return hash;
+}
+
 
 UBScreenMirror::UBScreenMirror(QWidget* parent)
     : QWidget(parent)
     , mScreenIndex(0)
     , mSourceWidget(0)
+    , mSourceView(0)
+    , mSourceScene(0)
+    , mSceneFullRepaint(true)
     , mTimerID(0)
 {
     // NOOP
@@ -40,29 +73,57 @@ UBScreenMirror::~UBScreenMirror()
 
 void UBScreenMirror::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event);
-
     QPainter painter(this);
 
-    painter.fillRect(0, 0, width(), height(), QBrush(Qt::black));
-
-    if (!mLastPixmap.isNull())
+    if (mTarget.isNull())
     {
-        int x = (width() - mLastPixmap.width()) / 2;
-        int y = (height() - mLastPixmap.height()) / 2;
+        painter.fillRect(0, 0, width(), height(), QBrush(Qt::black));
+        return;
+    }
 
-        painter.drawPixmap(x, y, mLastPixmap);
+    foreach(const QRect& rect, event->region().rects())
+    {
+        painter.drawImage(rect.topLeft(), mTarget, rect);
     }
 }
 
 
+void UBScreenMirror::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    ensureTarget();
+}
+
+
 void UBScreenMirror::timerEvent(QTimerEvent *event)
 {
     Q_UNUSED(event);
 
-    grabPixmap();
+    if (mSourceScene)
+        renderScene();
+    else
+        grabPixmap();
 
-    update();
+    if (!mTargetDamage.isEmpty())
+    {
+        update(mTargetDamage);
+        mTargetDamage = QRegion();
+    }
+}
+
+
+void UBScreenMirror::ensureTarget()
+{
+    if (mTarget.size() != size())
+    {
+        mTarget = QImage(size(), QImage::Format_RGB32);
+        mTarget.fill(Qt::black);
+
+        mTargetDamage = mTarget.rect();
+        mBlockHashes.clear();
+        mSceneFullRepaint = true;
+    }
 }
 
 
@@ -77,10 +138,252 @@ void UBScreenMirror::grabPixmap()
         mRect.setBottomRight(bottomRight);
     }
 
-    mLastPixmap = QPixmap::grabWindow(qApp->desktop()->screen(mScreenIndex)->winId(),
-        mRect.x(), mRect.y(), mRect.width(), mRect.height());
+    ensureTarget();
+
+    QImage grab = QPixmap::grabWindow(qApp->desktop()->screen(mScreenIndex)->winId(),
+        mRect.x(), mRect.y(), mRect.width(), mRect.height()).toImage().convertToFormat(QImage::Format_RGB32);
+
+    if (grab.isNull() || mTarget.isNull())
+        return;
+
+    bool fullFrame = (grab.size() != mGrabSize || mBlockHashes.isEmpty());
+
+    QRegion changed = changedDesktopBlocks(grab);
 
-    mLastPixmap = mLastPixmap.scaled(width(), height(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    if (changed.isEmpty())
+        return;
+
+    QSize scaledSize = grab.size();
+    scaledSize.scale(size(), Qt::KeepAspectRatio);
+
+    qreal scale = (qreal)scaledSize.width() / grab.width();
+    QPointF offset((width() - scaledSize.width()) / 2, (height() - scaledSize.height()) / 2);
+
+    qint64 changedPixels = 0;
+    foreach(const QRect& rect, changed.rects())
+        changedPixels += rect.width() * rect.height();
+
+    Qt::TransformationMode mode = Qt::SmoothTransformation;
+    if (changedPixels > sSmoothScalingMaxChangedRatio * grab.width() * grab.height())
+        mode = Qt::FastTransformation;
+
+    QPainter p(&mTarget);
+
+    if (fullFrame)
+        p.fillRect(mTarget.rect(), Qt::black);
+
+    foreach(QRect sourceRect, changed.rects())
+    {
+        // a small margin hides the filtering seams between rescaled blocks
+        sourceRect = sourceRect.adjusted(-2, -2, 2, 2).intersected(grab.rect());
+
+        QRect targetRect = QRectF(offset + QPointF(sourceRect.topLeft()) * scale, QSizeF(sourceRect.size()) * scale).toAlignedRect();
+
+        p.drawImage(targetRect.topLeft(), grab.copy(sourceRect).scaled(targetRect.size(), Qt::IgnoreAspectRatio, mode));
+
+        mTargetDamage += targetRect;
+    }
+
+    if (fullFrame)
+        mTargetDamage += mTarget.rect();
+}
+
+
+QRegion UBScreenMirror::changedDesktopBlocks(const QImage& pGrab)
+{
+    int columns = (pGrab.width() + sBlockSize - 1) / sBlockSize;
+    int rows = (pGrab.height() + sBlockSize - 1) / sBlockSize;
+
+    bool reset = (pGrab.size() != mGrabSize || mBlockHashes.size() != columns * rows);
+
+    if (reset)
+    {
+        mGrabSize = pGrab.size();
+        mBlockHashes.fill(0, columns * rows);
+    }
+
+    QRegion changed;
+
+    for (int row = 0; row < rows; row++)
+    {
+        int spanStart = -1;
+        int blockTop = row * sBlockSize;
+        int blockHeight = qMin(sBlockSize, pGrab.height() - blockTop);
+
+        for (int column = 0; column < columns; column++)
+        {
+            int blockLeft = column * sBlockSize;
+            QRect block(blockLeft, blockTop, qMin(sBlockSize, pGrab.width() - blockLeft), blockHeight);
+
+            uint hash = blockHash(pGrab, block);
+            uint& previousHash = mBlockHashes[row * columns + column];
+
+            bool blockChanged = reset || hash != previousHash;
+            previousHash = hash;
+
+            // merge horizontally adjacent changed blocks into a single span
+            if (blockChanged && spanStart < 0)
+            {
+                spanStart = blockLeft;
+            }
+            else if (!blockChanged && spanStart >= 0)
+            {
+                changed += QRect(spanStart, blockTop, blockLeft - spanStart, blockHeight);
+                spanStart = -1;
+            }
+        }
+
+        if (spanStart >= 0)
+            changed += QRect(spanStart, blockTop, pGrab.width() - spanStart, blockHeight);
+    }
+
+    return changed;
+}
+
+
+void UBScreenMirror::renderScene()
+{
+    if (!mSourceView || !mSourceScene)
+        return;
+
+    ensureTarget();
+
+    QRect viewRect = mSourceView->viewport()->rect();
+
+    if (viewRect.isEmpty() || mTarget.isNull())
+        return;
+
+    QTransform viewportTransform = mSourceView->viewportTransform();
+
+    if (viewportTransform != mLastViewportTransform)
+    {
+        mLastViewportTransform = viewportTransform;
+        mSceneFullRepaint = true;
+    }
+
+    QSize scaledSize = viewRect.size();
+    scaledSize.scale(size(), Qt::KeepAspectRatio);
+
+    qreal scale = (qreal)scaledSize.width() / viewRect.width();
+
+    QTransform viewToTarget;
+    viewToTarget.translate((width() - scaledSize.width()) / 2, (height() - scaledSize.height()) / 2);
+    viewToTarget.scale(scale, scale);
+
+    QTransform sceneToTarget = viewportTransform * viewToTarget;
+    QRectF visibleSceneRect = mSourceView->mapToScene(viewRect).boundingRect();
+
+    QList<QRectF> damage;
+
+    if (mSceneFullRepaint)
+    {
+        mTarget.fill(Qt::black);
+        mTargetDamage += mTarget.rect();
+
+        damage << visibleSceneRect;
+
+        mSceneFullRepaint = false;
+    }
+    else
+    {
+        damage = mSceneDamage;
+    }
+
+    mSceneDamage.clear();
+
+    if (damage.isEmpty())
+        return;
+
+    QPainter p(&mTarget);
+
+    p.setRenderHints(QPainter::Antialiasing);
+    p.setRenderHints(QPainter::SmoothPixmapTransform);
+    p.setTransform(sceneToTarget);
+
+    foreach(QRectF rect, damage)
+    {
+        rect = rect.adjusted(-1, -1, 1, 1).intersected(visibleSceneRect);
+
+        if (rect.isEmpty())
+            continue;
+
+        p.setClipRect(rect);
+
+        if (mSourceScene->isDarkBackground())
+            p.fillRect(rect, Qt::black);
+        else
+            p.fillRect(rect, Qt::white);
+
+        mSourceScene->render(&p, rect, rect);
+
+        mTargetDamage += sceneToTarget.mapRect(rect).toAlignedRect();
+    }
+}
+
+
+void UBScreenMirror::sceneChanged(const QList<QRectF>& region)
+{
+    if (mTimerID == 0)
+        return;
+
+    mSceneDamage << region;
+
+    if (mSceneDamage.size() > sMaxSceneDamageRects)
+    {
+        QRectF boundingRect;
+
+        foreach(const QRectF& rect, mSceneDamage)
+            boundingRect = boundingRect.united(rect);
+
+        mSceneDamage.clear();
+        mSceneDamage << boundingRect;
+    }
+}
+
+
+void UBScreenMirror::invalidateScene()
+{
+    mSceneFullRepaint = true;
+}
+
+
+void UBScreenMirror::activeSceneChanged()
+{
+    if (mSourceView)
+        setSourceScene(mSourceView->scene());
+}
+
+
+void UBScreenMirror::setSourceScene(UBGraphicsScene* pScene)
+{
+    connectSourceScene(false);
+
+    mSourceScene = pScene;
+
+    // the scene changes are only followed while mirroring
+    connectSourceScene(mTimerID != 0);
+
+    mSceneDamage.clear();
+    mSceneFullRepaint = true;
+    mBlockHashes.clear();
+}
+
+
+void UBScreenMirror::connectSourceScene(bool pConnected)
+{
+    if (!mSourceScene)
+        return;
+
+    if (pConnected)
+    {
+        connect(mSourceScene, SIGNAL(changed(const QList<QRectF>&)),
+                this, SLOT(sceneChanged(const QList<QRectF>&)), Qt::UniqueConnection);
+    }
+    else
+    {
+        disconnect(mSourceScene, SIGNAL(changed(const QList<QRectF>&)),
+                this, SLOT(sceneChanged(const QList<QRectF>&)));
+    }
 }
 
 
@@ -90,7 +393,27 @@ void UBScreenMirror::setSourceWidget(QWidget *sourceWidget)
 
     mScreenIndex = qApp->desktop()->screenNumber(sourceWidget);
 
-    grabPixmap();
+    // a board view is rendered straight from its scene, anything else is grabbed from the screen
+    mSourceView = qobject_cast<UBBoardView*>(sourceWidget);
+
+    if (mSourceView)
+    {
+        connect(UBApplication::boardController, SIGNAL(activeSceneChanged()), this, SLOT(activeSceneChanged()), Qt::UniqueConnection);
+        connect(UBApplication::boardController, SIGNAL(backgroundChanged()), this, SLOT(invalidateScene()), Qt::UniqueConnection);
+
+        setSourceScene(mSourceView->scene());
+        renderScene();
+    }
+    else
+    {
+        disconnect(UBApplication::boardController, SIGNAL(activeSceneChanged()), this, SLOT(activeSceneChanged()));
+        disconnect(UBApplication::boardController, SIGNAL(backgroundChanged()), this, SLOT(invalidateScene()));
+
+        setSourceScene(0);
+        grabPixmap();
+    }
+
+    mTargetDamage = QRegion();
 
     update();
 }
@@ -113,6 +436,13 @@ void UBScreenMirror::start()
         }
 
         mTimerID = startTimer(ms);
+
+        // nothing was followed while stopped, the first tick repaints everything
+        mSceneDamage.clear();
+        mSceneFullRepaint = true;
+        mBlockHashes.clear();
+
+        connectSourceScene(true);
     }
     else
     {
@@ -129,5 +459,8 @@ void UBScreenMirror::stop()
     {
         killTimer(mTimerID);
         mTimerID = 0;
+
+        connectSourceScene(false);
+        mSceneDamage.clear();
     }
 }
@@ -18,6 +18,9 @@
 
 #include <QtGui>
 
+class UBBoardView;
+class UBGraphicsScene;
+
 class UBScreenMirror : public QWidget
 {
     Q_OBJECT;
@@ -37,23 +40,61 @@ class UBScreenMirror : public QWidget
         {
             mRect = pRect;
             mSourceWidget = 0;
+            mSourceView = 0;
+            setSourceScene(0);
         }
 
         void start();
 
         void stop();
 
+    protected:
+
+        virtual void resizeEvent(QResizeEvent *event);
+
+    private slots:
+
+        void activeSceneChanged();
+
+        void sceneChanged(const QList<QRectF>& region);
+
+        void invalidateScene();
+
     private:
 
         void grabPixmap();
 
+        void renderScene();
+
+        void setSourceScene(UBGraphicsScene* pScene);
+
+        void connectSourceScene(bool pConnected);
+
+        void ensureTarget();
+
+        QRegion changedDesktopBlocks(const QImage& pGrab);
+
         int mScreenIndex;
 
         QWidget* mSourceWidget;
 
+        UBBoardView* mSourceView;
+
+        UBGraphicsScene* mSourceScene;
+
         QRect mRect;
 
-        QPixmap mLastPixmap;
+        // mirror-sized, letterboxed copy of the source, painted incrementally
+        QImage mTarget;
+
+        QRegion mTargetDamage;
+
+        QList<QRectF> mSceneDamage;
+        bool mSceneFullRepaint;
+        QTransform mLastViewportTransform;
+
+        QSize mGrabSize;
+        QVector<uint> mBlockHashes;
 
         long mTimerID;
 
@@ -45,6 +45,7 @@
 #include "document/UBDocumentProxy.h"
 #include "document/UBDocumentController.h"
 
+#include "domain/UBGraphicsScene.h"
 #include "domain/UBGraphicsTextItem.h"
 
 #include "core/memcheck.h"
@@ -175,29 +176,26 @@ void UBTeacherGuideEditionWidget::showEvent(QShowEvent* event)
 void UBTeacherGuideEditionWidget::onActiveDocumentChanged()
 {
     int activeSceneIndex = UBApplication::boardController->activeSceneIndex();
-    if (UBApplication::boardController->pageFromSceneIndex(activeSceneIndex) != 0)
-        load(UBSvgSubsetAdaptor::readTeacherGuideNode(activeSceneIndex));
+    UBGraphicsScene* activeScene = UBApplication::boardController->activeScene();
+    if (UBApplication::boardController->pageFromSceneIndex(activeSceneIndex) != 0 && activeScene)
+        load(activeScene->teacherGuide());
 }
 
-void UBTeacherGuideEditionWidget::load(QString element)
+void UBTeacherGuideEditionWidget::load(const QList<tIDataStorage>& teacherGuide)
 {
     cleanData();
-    QDomDocument doc("TeacherGuide");
-    doc.setContent(element);
-
-    for (QDomElement element = doc.documentElement().firstChildElement();
-         !element.isNull(); element = element.nextSiblingElement()) {
-        QString tagName = element.tagName();
-        if (tagName == "title")
-            mpPageTitle->setInitialText(element.attribute("value"));
-        else if (tagName == "comment")
-            mpComment->setInitialText(element.attribute("value"));
-        else if (tagName == "media")
-            onAddItemClicked(mpAddAMediaItem, 0, &element);
-        else if (tagName == "link")
-            onAddItemClicked(mpAddALinkItem, 0, &element);
-        else if (tagName == "action")
-            onAddItemClicked(mpAddAnActionItem, 0, &element);
+
+    foreach(const tIDataStorage& node, teacherGuide) {
+        if (node.name == "title")
+            mpPageTitle->setInitialText(node.attributes.value("value"));
+        else if (node.name == "comment")
+            mpComment->setInitialText(node.attributes.value("value"));
+        else if (node.name == "media")
+            onAddItemClicked(mpAddAMediaItem, 0, &node);
+        else if (node.name == "link")
+            onAddItemClicked(mpAddALinkItem, 0, &node);
+        else if (node.name == "action")
+            onAddItemClicked(mpAddAnActionItem, 0, &node);
     }
 }
 
@@ -252,9 +250,10 @@ QVector<tIDataStorage*> UBTeacherGuideEditionWidget::save(int pageIndex)
 void UBTeacherGuideEditionWidget::onActiveSceneChanged()
 {
     int currentPage = UBApplication::boardController->currentPage();
-    if (currentPage > 0) {
+    UBGraphicsScene* activeScene = UBApplication::boardController->activeScene();
+    if (currentPage > 0 && activeScene) {
         cleanData();
-        load( UBSvgSubsetAdaptor::readTeacherGuideNode( UBApplication::boardController->activeSceneIndex()));
+        load(activeScene->teacherGuide());
         mpPageNumberLabel->setText(tr("Page: %0").arg(currentPage));
         UBDocumentProxy* documentProxy = UBApplication::boardController->selectedDocument();
         if (mpDocumentTitle)
@@ -313,7 +312,7 @@ QVector<tUBGEElementNode*> UBTeacherGuideEditionWidget::getData()
     return result;
 }
 
-void UBTeacherGuideEditionWidget::onAddItemClicked(QTreeWidgetItem* widget, int column, QDomElement *element)
+void UBTeacherGuideEditionWidget::onAddItemClicked(QTreeWidgetItem* widget, int column, const tIDataStorage* data)
 {
     int addSubItemWidgetType = widget->data(column, Qt::UserRole).toInt();
     if (addSubItemWidgetType != eUBTGAddSubItemWidgetType_None) {
@@ -325,22 +324,22 @@ void UBTeacherGuideEditionWidget::onAddItemClicked(QTreeWidgetItem* widget, int
         switch (addSubItemWidgetType) {
         case eUBTGAddSubItemWidgetType_Action: {
             UBTGActionWidget* actionWidget = new UBTGActionWidget(widget);
-            if (element)
-                actionWidget->initializeWithDom(*element);
+            if (data)
+                actionWidget->initializeWithData(*data);
             mpTreeWidget->setItemWidget(newWidgetItem, 0, actionWidget);
             break;
         }
         case eUBTGAddSubItemWidgetType_Media: {
             UBTGMediaWidget* mediaWidget = new UBTGMediaWidget(widget);
-            if (element)
-                mediaWidget->initializeWithDom(*element);
+            if (data)
+                mediaWidget->initializeWithData(*data);
             mpTreeWidget->setItemWidget(newWidgetItem,0, mediaWidget);
             break;
         }
         case eUBTGAddSubItemWidgetType_Url: {
             UBTGUrlWidget* urlWidget = new UBTGUrlWidget();
-            if (element)
-                urlWidget->initializeWithDom(*element);
+            if (data)
+                urlWidget->initializeWithData(*data);
             mpTreeWidget->setItemWidget(newWidgetItem, 0, urlWidget);
             break;
         }
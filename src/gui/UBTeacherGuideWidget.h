@@ -47,13 +47,13 @@ public:
     void cleanData();
     QVector<tUBGEElementNode*> getData();
 
-    void load(QString element);
+    void load(const QList<tIDataStorage>& teacherGuide);
     QVector<tIDataStorage*> save(int pageIndex);
 
     bool isModified();
 
 public slots:
-    void onAddItemClicked(QTreeWidgetItem* widget, int column, QDomElement* element = 0);
+    void onAddItemClicked(QTreeWidgetItem* widget, int column, const tIDataStorage* data = 0);
     void onActiveSceneChanged();
     void showEvent(QShowEvent* event);
 
@@ -96,10 +96,10 @@ UBTGActionWidget::~UBTGActionWidget()
     DELETEPTR(mpLayout);
 }
 
-void UBTGActionWidget::initializeWithDom(QDomElement element)
+void UBTGActionWidget::initializeWithData(const tIDataStorage& data)
 {
-    mpOwner->setCurrentIndex(element.attribute("owner").toInt());
-    mpTask->setInitialText(element.attribute("task"));
+    mpOwner->setCurrentIndex(data.attributes.value("owner").toInt());
+    mpTask->setInitialText(data.attributes.value("task"));
 }
 
 tUBGEElementNode* UBTGActionWidget::saveData()
@@ -338,14 +338,14 @@ UBTGMediaWidget::~UBTGMediaWidget()
     DELETEPTR(mpWorkWidget);
 }
 
-void UBTGMediaWidget::initializeWithDom(QDomElement element)
+void UBTGMediaWidget::initializeWithData(const tIDataStorage& data)
 {
     mIsInitializationMode = true;
     setAcceptDrops(false);
-    mMediaPath = UBApplication::boardController->selectedDocument()->persistencePath() + "/" + element.attribute("relativePath");
-    createWorkWidget(element.attribute("mediaType").contains("flash"));
+    mMediaPath = UBApplication::boardController->selectedDocument()->persistencePath() + "/" + data.attributes.value("relativePath");
+    createWorkWidget(data.attributes.value("mediaType").contains("flash"));
     setFixedHeight(200);
-    mpTitle->setInitialText(element.attribute("title"));
+    mpTitle->setInitialText(data.attributes.value("title"));
     mIsInitializationMode = false;
 }
 
@@ -586,10 +586,10 @@ void UBTGUrlWidget::onUrlEditionFinished()
 	}
 }
 
-void UBTGUrlWidget::initializeWithDom(QDomElement element)
+void UBTGUrlWidget::initializeWithData(const tIDataStorage& data)
 {
-    mpTitle->setText(element.attribute("title"));
-    mpUrl->setText(element.attribute("url"));
+    mpTitle->setText(data.attributes.value("title"));
+    mpUrl->setText(data.attributes.value("url"));
 }
 
 tUBGEElementNode* UBTGUrlWidget::saveData()
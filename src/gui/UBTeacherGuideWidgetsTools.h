@@ -29,6 +29,8 @@
 
 #include "customWidgets/UBMediaWidget.h"
 
+#include "interfaces/IDataStorage.h"
+
 #define TG_USER_ROLE_MIME_TYPE (Qt::UserRole+50)
 
 
@@ -38,7 +40,6 @@ class QComboBox;
 class QTextEdit;
 class QWidget;
 class UBTGAdaptableText;
-class QDomElement;
 class UBMediaWidget;
 
 typedef struct
@@ -75,7 +76,7 @@ public:
     ~UBTGActionWidget();
     void update();
     tUBGEElementNode* saveData();
-    void initializeWithDom(QDomElement element);
+    void initializeWithData(const tIDataStorage& data);
 
 private:
     QVBoxLayout* mpLayout;
@@ -140,7 +141,7 @@ public:
     UBTGMediaWidget(QString mediaPath, QTreeWidgetItem* widget = 0, QWidget* parent = 0, bool forceFlashMediaType = false, const char *name = "UBTGMediaWidget");
     ~UBTGMediaWidget();
     tUBGEElementNode* saveData();
-    void initializeWithDom(QDomElement element);
+    void initializeWithData(const tIDataStorage& data);
     void removeSource();
 
 protected:
@@ -177,7 +178,7 @@ public:
     UBTGUrlWidget(QWidget* parent = 0, const char* name = "UBTGUrlWidget");
     ~UBTGUrlWidget();
     tUBGEElementNode* saveData();
-    void initializeWithDom(QDomElement element);
+    void initializeWithData(const tIDataStorage& data);
 
 public slots:
     void onUrlEditionFinished();
@@ -31,10 +31,13 @@
 UBThumbnailWidget::UBThumbnailWidget(QWidget* parent)
     : QGraphicsView(parent)
     , mThumbnailWidth(UBSettings::defaultThumbnailWidth)
+    , mThumbnailHeight(0)
     , mSpacing(UBSettings::thumbnailSpacing)
+    , mColumnCount(1)
+    , mRowHeight(0)
+    , mElidedLabelsWidth(-1)
     , mLastSelectedThumbnail(0)
     , mSelectionSpan(0)
-    , mPrevLassoRect(QRect())
     , mLassoRectItem(0)
 
 {
@@ -83,6 +86,15 @@ void UBThumbnailWidget::setGraphicsItems(const QList<QGraphicsItem*>& pGraphicsI
     mMimeType = pMimeType;
     mLabels = pLabels;
 
+    mItemIndexes.clear();
+    for (int i = 0; i < mGraphicItems.size(); i++)
+        mItemIndexes.insert(mGraphicItems.at(i), i);
+
+    mElidedLabels.clear();
+    mElidedLabelsWidth = -1;
+    mSelectedThumbnailItems.clear();
+    mLassoSelectedItems.clear();
+
     foreach(QGraphicsItem* it, mThumbnailsScene.items())
     {
         mThumbnailsScene.removeItem(it, true);
@@ -132,6 +144,21 @@ void UBThumbnailWidget::refreshScene()
 
     qreal thumbnailHeight = mThumbnailWidth / UBSettings::minScreenRatio;
 
+    mColumnCount = nbColumns;
+    mThumbnailHeight = thumbnailHeight;
+    mRowHeight = thumbnailHeight + mSpacing + labelSpacing;
+
+    // a resize only moves the labels, eliding them again is only needed for another width
+    bool elideLabels = mElidedLabelsWidth != mThumbnailWidth || mElidedLabels.size() != mLabelsItems.size();
+
+    if (elideLabels)
+    {
+        mElidedLabels.clear();
+        mElidedLabelsWidth = mThumbnailWidth;
+    }
+
+    QFontMetrics labelMetrics(mLabelsItems.isEmpty() ? font() : mLabelsItems.at(0)->font(), this);
+
     for (int i = 0; i < mGraphicItems.size(); i++)
     {
         QGraphicsItem* item = mGraphicItems.at(i);
@@ -172,14 +199,17 @@ void UBThumbnailWidget::refreshScene()
 
         if (mLabelsItems.size() > i)
         {
-            QFontMetrics fm(mLabelsItems.at(i)->font(), this);
-            QString elidedText = fm.elidedText(mLabels.at(i), Qt::ElideRight, mThumbnailWidth);
+            if (elideLabels)
+            {
+                QString elidedText = labelMetrics.elidedText(mLabels.at(i), Qt::ElideRight, mThumbnailWidth);
+                mElidedLabels << elidedText;
 
-            mLabelsItems.at(i)->setPlainText(elidedText);
-            mLabelsItems.at(i)->setWidth(fm.width(elidedText) + 2 * mLabelsItems.at(i)->document()->documentMargin());
+                mLabelsItems.at(i)->setPlainText(elidedText);
+                mLabelsItems.at(i)->setWidth(labelMetrics.width(elidedText) + 2 * mLabelsItems.at(i)->document()->documentMargin());
+            }
 
             pos.setY(pos.y() + (thumbnailHeight + h * scaleFactor) / 2 + 5);
-            qreal labelWidth = fm.width(elidedText);
+            qreal labelWidth = labelMetrics.width(mElidedLabels.at(i));
             pos.setX(mSpacing + (mThumbnailWidth - labelWidth) / 2 + columnIndex * (mThumbnailWidth + mSpacing));
             mLabelsItems.at(i)->setPos(pos);
         }
@@ -235,7 +265,7 @@ void UBThumbnailWidget::mousePressEvent(QMouseEvent *event)
         QStyleOption option;
         option.initFrom(&rubberBand);
 
-        mPrevLassoRect = QRect();
+        mLassoSelectedItems.clear();
         mLassoRectItem = new QGraphicsRectItem(0, scene());
 
 #ifdef Q_WS_MAC
@@ -262,13 +292,11 @@ void UBThumbnailWidget::mousePressEvent(QMouseEvent *event)
 
         if (Qt::ControlModifier & event->modifiers() || Qt::ShiftModifier & event->modifiers())
         {
-           // mSelectedThumbnailItems = selectedItems().toSet();
+            mSelectedThumbnailItems = mThumbnailsScene.selectedItems().toSet();
             return;
         }
 
         mSelectedThumbnailItems.clear();
-        mPreviouslyIncrementalSelectedItemsX.clear();
-        mPreviouslyIncrementalSelectedItemsY.clear();
         QGraphicsView::mousePressEvent(event);
     }
     else if (Qt::ShiftModifier & event->modifiers())
@@ -278,8 +306,8 @@ void UBThumbnailWidget::mousePressEvent(QMouseEvent *event)
             QGraphicsItem* previousSelectedItem = dynamic_cast<QGraphicsItem*>(previousSelectedThumbnail);
             if (previousSelectedItem)
             {
-                int index1 = mGraphicItems.indexOf(previousSelectedItem);
-                int index2 = mGraphicItems.indexOf(underlyingItem);
+                int index1 = graphicsItemIndex(previousSelectedItem);
+                int index2 = graphicsItemIndex(underlyingItem);
                 if (-1 == index2)
                 {
                     mSelectedThumbnailItems = selectedItems().toSet();
@@ -296,7 +324,7 @@ void UBThumbnailWidget::mousePressEvent(QMouseEvent *event)
         mLastSelectedThumbnail = dynamic_cast<UBThumbnail*>(underlyingItem);
         if (!underlyingItem->isSelected())
         {
-            int index = mGraphicItems.indexOf(underlyingItem);
+            int index = graphicsItemIndex(underlyingItem);
             selectItemAt(index, Qt::ControlModifier & event->modifiers());
         }
         else
@@ -321,101 +349,31 @@ void UBThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
     if (mLassoRectItem)
     {
         bSelectionInProgress = true;
-        int incrementLassoMinWidth = 2;
         QPointF currentScenePos = mapToScene(event->pos());
         QRectF lassoRect(
             qMin(mMousePressScenePos.x(), currentScenePos.x()), qMin(mMousePressScenePos.y(), currentScenePos.y()),
             qAbs(mMousePressScenePos.x() - currentScenePos.x()), qAbs(mMousePressScenePos.y() - currentScenePos.y()));
-        if (QPoint() == prevMoveMousePos)
-            prevMoveMousePos = currentScenePos;
-        QRectF incrementXSelection(
-            qMin(prevMoveMousePos.x(), currentScenePos.x()), qMin(mMousePressScenePos.y(), currentScenePos.y()),
-            qAbs(prevMoveMousePos.x() - currentScenePos.x())+incrementLassoMinWidth, qAbs(mMousePressScenePos.y() - currentScenePos.y()));
-        QRectF incrementYSelection(
-            qMin(mMousePressScenePos.x(), currentScenePos.x()), qMin(prevMoveMousePos.y(), currentScenePos.y()),
-            qAbs(mMousePressScenePos.x() - currentScenePos.x()), qAbs(prevMoveMousePos.y() - currentScenePos.y())+incrementLassoMinWidth);
-
-        prevMoveMousePos = currentScenePos;
-        mLassoRectItem->setRect(lassoRect);
-
-        QSet<QGraphicsItem*> lassoSelectedThumbnailItems;
-
-        QSet<QGraphicsItem*> toUnset;
-        QSet<QGraphicsItem*> toSet;
-
-        // for horizontal moving
-        QSet<QGraphicsItem*> incSelectedItemsX = scene()->items(incrementXSelection, Qt::IntersectsItemBoundingRect).toSet();
-        foreach (QGraphicsItem *lassoSelectedItem, incSelectedItemsX)
-        {
-            if (lassoSelectedItem)
-            {
-                UBSceneThumbnailPixmap *thumbnailItem = dynamic_cast<UBSceneThumbnailPixmap*>(lassoSelectedItem);
-                if (thumbnailItem)
-                     lassoSelectedThumbnailItems += lassoSelectedItem;
-            }
-        }
-
-        if(lassoRect.width() < mPrevLassoRect.width())
-        {
-            if (!lassoSelectedThumbnailItems.contains(mPreviouslyIncrementalSelectedItemsX))
-                toUnset += mPreviouslyIncrementalSelectedItemsX - lassoSelectedThumbnailItems;
-
-        }
-        mPreviouslyIncrementalSelectedItemsX = lassoSelectedThumbnailItems;
-
-        toSet += lassoSelectedThumbnailItems + mPreviouslyIncrementalSelectedItemsX;
 
+        mLassoRectItem->setRect(lassoRect);
 
-        lassoSelectedThumbnailItems.clear();
+        QSet<QGraphicsItem*> lassoSelectedItems;
 
-        // for vertical moving
+        foreach (int index, indexesInRect(lassoRect))
+            lassoSelectedItems << mGraphicItems.at(index);
 
-        QSet<QGraphicsItem*> incSelectedItemsY = scene()->items(incrementYSelection, Qt::IntersectsItemBoundingRect).toSet();
-        foreach (QGraphicsItem *lassoSelectedItem, incSelectedItemsY)
+        // only the thumbnails the lasso entered or left since the last move change state
+        foreach (QGraphicsItem *item, mLassoSelectedItems - lassoSelectedItems)
         {
-            if (lassoSelectedItem)
-            {
-                UBSceneThumbnailPixmap *thumbnailItem = dynamic_cast<UBSceneThumbnailPixmap*>(lassoSelectedItem);
-
-                if (thumbnailItem)
-                    lassoSelectedThumbnailItems += lassoSelectedItem;
-            }
+            if (!mSelectedThumbnailItems.contains(item))
+                item->setSelected(false);
         }
 
-        if(lassoRect.height() < mPrevLassoRect.height())
-        {
-            if (!lassoSelectedThumbnailItems.contains(mPreviouslyIncrementalSelectedItemsY))
-                toUnset += mPreviouslyIncrementalSelectedItemsY - lassoSelectedThumbnailItems;
-
-        }
-        mPreviouslyIncrementalSelectedItemsY = lassoSelectedThumbnailItems;
-
-
-        toSet += lassoSelectedThumbnailItems + mPreviouslyIncrementalSelectedItemsY;
-
-
-        toSet -= toUnset;
-
-        foreach (QGraphicsItem *item, toSet)
+        foreach (QGraphicsItem *item, lassoSelectedItems - mLassoSelectedItems)
         {
             item->setSelected(true);
         }
 
-        foreach (QGraphicsItem *item, toUnset)
-        {
-            item->setSelected(false);
-        }
-
-        mSelectedThumbnailItems += lassoSelectedThumbnailItems;
-        mPrevLassoRect = lassoRect;
-
-        if (Qt::ControlModifier & event->modifiers())
-        {
-            for (int i = 0; i < mSelectedThumbnailItems.count()-1; i++)
-            {
-                mSelectedThumbnailItems.values().at(i)->setSelected(true);
-            }
-        }
+        mLassoSelectedItems = lassoSelectedItems;
     }
     else
     {
@@ -437,12 +395,10 @@ void UBThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
 
             foreach (QGraphicsItem* item, selectedItems())
             {
-                if (mGraphicItems.contains(item))
-                {
-                    if (mGraphicItems.indexOf(item) <= mItemsPaths.size()){
-                        qlElements << mItemsPaths.at(mGraphicItems.indexOf(item));
-                    }
-                }
+                int index = graphicsItemIndex(item);
+
+                if (index >= 0 && index < mItemsPaths.size())
+                    qlElements << mItemsPaths.at(index);
             }
 
             if (qlElements.size() > 0){
@@ -460,7 +416,6 @@ void UBThumbnailWidget::mouseMoveEvent(QMouseEvent *event)
 void UBThumbnailWidget::mouseReleaseEvent(QMouseEvent *event)
 {
     int elapsedTimeSincePress = mClickTime.elapsed();
-    prevMoveMousePos = QPoint();
     deleteLasso();
     QGraphicsView::mouseReleaseEvent(event);
 
@@ -476,7 +431,7 @@ void UBThumbnailWidget::keyPressEvent(QKeyEvent *event)
     {
         QGraphicsItem *lastSelectedGraphicsItem = dynamic_cast<QGraphicsItem*>(mLastSelectedThumbnail);
         if (!lastSelectedGraphicsItem) return;
-        int startSelectionIndex = mGraphicItems.indexOf(lastSelectedGraphicsItem);
+        int startSelectionIndex = graphicsItemIndex(lastSelectedGraphicsItem);
         int previousSelectedThumbnailIndex = startSelectionIndex + mSelectionSpan;
 
         switch (event->key())
@@ -706,13 +661,46 @@ int UBThumbnailWidget::columnCount() const
 }
 
 
+QList<int> UBThumbnailWidget::indexesInRect(const QRectF& pSceneRect) const
+{
+    QList<int> indexes;
+
+    if (mGraphicItems.isEmpty() || mRowHeight <= 0)
+        return indexes;
+
+    qreal columnWidth = mThumbnailWidth + mSpacing;
+
+    // a thumbnail never leaves its cell, only the cells the rect spans are looked at
+    int firstColumn = qMax(0, qFloor((pSceneRect.left() - mSpacing) / columnWidth));
+    int lastColumn = qMin(mColumnCount - 1, qFloor((pSceneRect.right() - mSpacing) / columnWidth));
+    int firstRow = qMax(0, qFloor((pSceneRect.top() - mSpacing) / mRowHeight));
+    int lastRow = qMin((mGraphicItems.size() - 1) / mColumnCount, qFloor((pSceneRect.bottom() - mSpacing) / mRowHeight));
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            int index = row * mColumnCount + column;
+
+            if (index >= mGraphicItems.size())
+                break;
+
+            if (mGraphicItems.at(index)->sceneBoundingRect().intersects(pSceneRect))
+                indexes << index;
+        }
+    }
+
+    return indexes;
+}
+
+
 void UBThumbnailWidget::mouseDoubleClickEvent(QMouseEvent * event)
 {
     QGraphicsItem* item = itemAt(event->pos());
 
     if (item)
     {
-        int index = mGraphicItems.indexOf(item);
+        int index = graphicsItemIndex(item);
         emit mouseDoubleClick(item, index);
     }
 }
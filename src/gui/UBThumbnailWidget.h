@@ -86,6 +86,13 @@ class UBThumbnailWidget : public QGraphicsView
 
     protected:
         qreal spacing() { return mSpacing; }
+
+        // position of the item in mGraphicItems, -1 if it is not a thumbnail of this widget
+        int graphicsItemIndex(QGraphicsItem* pItem) const
+        {
+            return mItemIndexes.value(pItem, -1);
+        }
+
         QList<QUrl> mItemsPaths;
         QStringList mLabels;
         bool bSelectionInProgress;
@@ -97,6 +104,9 @@ class UBThumbnailWidget : public QGraphicsView
         int rowCount() const;
         int columnCount() const;
 
+        // indexes of the thumbnails the scene rect touches, read from the grid layout
+        QList<int> indexesInRect(const QRectF& pSceneRect) const;
+
         static bool thumbnailLessThan(QGraphicsItem* item1, QGraphicsItem* item2);
 
         void deleteLasso();
@@ -105,19 +115,26 @@ class UBThumbnailWidget : public QGraphicsView
 
         QString mMimeType;
 
-        QPointF prevMoveMousePos;
-
         qreal mThumbnailWidth;
         qreal mThumbnailHeight;
         qreal mSpacing;
 
+        // grid computed by refreshScene
+        int mColumnCount;
+        qreal mRowHeight;
+
+        QHash<QGraphicsItem*, int> mItemIndexes;
+
+        // labels elided for mElidedLabelsWidth, only recomputed when the thumbnail width changes
+        qreal mElidedLabelsWidth;
+        QStringList mElidedLabels;
+
         UBThumbnail *mLastSelectedThumbnail;
         int mSelectionSpan;
-        QRectF mPrevLassoRect;
         QGraphicsRectItem *mLassoRectItem;
+        // selected before the lasso started, kept when Ctrl or Shift is held
         QSet<QGraphicsItem*> mSelectedThumbnailItems;
-        QSet<QGraphicsItem*> mPreviouslyIncrementalSelectedItemsX;
-        QSet<QGraphicsItem*> mPreviouslyIncrementalSelectedItemsY;
+        QSet<QGraphicsItem*> mLassoSelectedItems;
         QTime mClickTime;
 };
 
@@ -14,6 +14,7 @@ HEADERS += src/gui/UBThumbnailView.h \
     src/gui/UBDocumentTreeWidget.h \
     src/gui/UBMousePressFilter.h \
     src/gui/UBBlackoutWidget.h \
+    src/gui/UBPreviousPageView.h \
     src/gui/UBMainWindow.h \
     src/gui/UBToolWidget.h \
     src/gui/UBSpinningWheel.h \
@@ -60,6 +61,7 @@ SOURCES += src/gui/UBThumbnailView.cpp \
     src/gui/UBDocumentTreeWidget.cpp \
     src/gui/UBMousePressFilter.cpp \
     src/gui/UBBlackoutWidget.cpp \
+    src/gui/UBPreviousPageView.cpp \
     src/gui/UBMainWindow.cpp \
     src/gui/UBToolWidget.cpp \
     src/gui/UBSpinningWheel.cpp \
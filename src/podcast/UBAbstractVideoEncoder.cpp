@@ -17,11 +17,15 @@
 
 #include "core/memcheck.h"
 
+// the containers are timestamped, an unchanged frame keeps showing until the next one
+static const long sMaxDuplicateFrameInterval = 1000; // ms
+
 UBAbstractVideoEncoder::UBAbstractVideoEncoder(QObject *pParent)
     : QObject(pParent)
     , mFramesPerSecond(10)
     , mVideoSize(640, 480)
     , mVideoBitsPerSecond(1700000) // 1.7 Mbps
+    , mLastFrameTimestamp(-1)
 {
     // NOOP
 
@@ -33,6 +37,23 @@ UBAbstractVideoEncoder::~UBAbstractVideoEncoder()
 }
 
 
+void UBAbstractVideoEncoder::newFrame(const QImage& pImage, const QRegion& pDamage, long timestamp)
+{
+    // a smaller timestamp is a new recording
+    if (pDamage.isEmpty()
+            && mLastFrameTimestamp >= 0
+            && timestamp >= mLastFrameTimestamp
+            && timestamp - mLastFrameTimestamp < sMaxDuplicateFrameInterval)
+    {
+        return;
+    }
+
+    mLastFrameTimestamp = timestamp;
+
+    newPixmap(pImage, timestamp);
+}
+
+
 void UBAbstractVideoEncoder::newChapter(const QString& pLabel, long timestamp)
 {
     Q_UNUSED(pLabel);
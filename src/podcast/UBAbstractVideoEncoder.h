@@ -16,7 +16,7 @@
 #ifndef UBABSTRACTVIDEOENCODER_H_
 #define UBABSTRACTVIDEOENCODER_H_
 
-#include <QtCore>
+#include <QtGui>
 
 class UBAbstractVideoEncoder : public QObject
 {
@@ -38,6 +38,10 @@ class UBAbstractVideoEncoder : public QObject
 
         virtual void newPixmap(const QImage& pImage, long timestamp) = 0;
 
+        // pDamage is the part of pImage that changed since the previous frame, empty for a duplicate frame,
+        // duplicates are only passed on to newPixmap once in a while
+        virtual void newFrame(const QImage& pImage, const QRegion& pDamage, long timestamp);
+
         virtual void newChapter(const QString& pLabel, long timestamp);
 
         void setFramesPerSecond(int pFps)
@@ -116,6 +120,8 @@ class UBAbstractVideoEncoder : public QObject
 
         QString mAudioRecordingDevice;
 
+        long mLastFrameTimestamp;
+
 };
 
 #endif /* UBABSTRACTVIDEOENCODER_H_ */
@@ -179,7 +179,8 @@ void UBPodcastController::setSourceWidget(QWidget* pWidget)
         mSourceWidget = pWidget;
         mInitialized = false;
         mViewToVideoTransform.reset();
-        mLatestCapture.fill(sBackgroundColor);
+        mFramePool.fill(QColor(sBackgroundColor));
+        mLatestDesktopGrab = QImage();
 
         if (mSourceWidget)
         {
@@ -353,7 +354,7 @@ void UBPodcastController::start()
 
             mVideoEncoder->setVideoFileName(videoFileName);
 
-            mLatestCapture = QImage(mVideoFrameSizeAtStart, QImage::Format_RGB32); //0xffRRGGBB
+            mFramePool.reset(mVideoFrameSizeAtStart, QImage::Format_RGB32); //0xffRRGGBB
 
             mRecordStartTime = QTime::currentTime();
 
@@ -461,13 +462,15 @@ void UBPodcastController::processWidgetPaintEvent()
         return;
 
     QRect repaintRect;
+    QRegion damage;
 
     if (!mInitialized)
     {
         mWidgetRepaintRectQueue.clear();
         repaintRect = mSourceWidget->geometry();
 
-        mLatestCapture.fill(sBackgroundColor);
+        mFramePool.fill(QColor(sBackgroundColor));
+        damage = mFramePool.frameRect();
 
         mInitialized = true;
     }
@@ -483,16 +486,23 @@ void UBPodcastController::processWidgetPaintEvent()
     {
         mIsGrabbing = true;
 
-        QPainter p(&mLatestCapture);
-        p.setTransform(mViewToVideoTransform);
-        p.setRenderHints(QPainter::Antialiasing);
-        p.setRenderHints(QPainter::SmoothPixmapTransform);
+        QImage& frame = mFramePool.beginFrame();
 
-        mSourceWidget->render(&p, repaintRect.topLeft(), QRegion(repaintRect), QWidget::DrawChildren);
+        {
+            QPainter p(&frame);
+            p.setTransform(mViewToVideoTransform);
+            p.setRenderHints(QPainter::Antialiasing);
+            p.setRenderHints(QPainter::SmoothPixmapTransform);
+
+            mSourceWidget->render(&p, repaintRect.topLeft(), QRegion(repaintRect), QWidget::DrawChildren);
+        }
+
+        damage += mViewToVideoTransform.mapRect(QRectF(repaintRect)).toAlignedRect().adjusted(-1, -1, 1, 1);
+        mFramePool.endFrame(damage);
 
         mIsGrabbing = false;
 
-        sendLatestPixmapToEncoder();
+        sendLatestPixmapToEncoder(damage);
     }
 }
 
@@ -592,18 +602,16 @@ void UBPodcastController::processScenePaintEvent()
         return;
 
     QRectF repaintRect;
+    QRegion damage;
 
     if (!mInitialized)
     {
         mSceneRepaintRectQueue.clear();
         repaintRect = bv->mapToScene(QRect(0, 0, bv->width(), bv->height())).boundingRect();
 
-        if (bv->scene()->isDarkBackground())
-                mLatestCapture.fill(Qt::black);
-        else
-                mLatestCapture.fill(Qt::white);
-
-        mLatestCapture.fill(Qt::white);
+        // the repaint below fills the viewport with the scene background, margins stay white
+        mFramePool.fill(Qt::white);
+        damage = mFramePool.frameRect();
 
         mInitialized = true;
     }
@@ -619,30 +627,38 @@ void UBPodcastController::processScenePaintEvent()
     {
         UBGraphicsScene *scene = bv->scene();
 
-        QPainter p(&mLatestCapture);
+        QTransform sceneToVideoTransform = bv->viewportTransform() * mViewToVideoTransform;
 
-        p.setTransform(mViewToVideoTransform);
-        p.setTransform(bv->viewportTransform(), true);
+        repaintRect.adjust(-1, -1, 1, 1);
 
-        p.setRenderHints(QPainter::Antialiasing);
-        p.setRenderHints(QPainter::SmoothPixmapTransform);
+        QImage& frame = mFramePool.beginFrame();
 
-        repaintRect.adjust(-1, -1, 1, 1);
+        {
+            QPainter p(&frame);
 
-        p.setClipRect(repaintRect);
+            p.setTransform(sceneToVideoTransform);
 
-        if (scene->isDarkBackground())
-            p.fillRect(repaintRect, Qt::black);
-        else
-            p.fillRect(repaintRect, Qt::white);
+            p.setRenderHints(QPainter::Antialiasing);
+            p.setRenderHints(QPainter::SmoothPixmapTransform);
+
+            p.setClipRect(repaintRect);
 
-        scene->setRenderingContext(UBGraphicsScene::Podcast);
+            if (scene->isDarkBackground())
+                p.fillRect(repaintRect, Qt::black);
+            else
+                p.fillRect(repaintRect, Qt::white);
 
-        scene->render(&p, repaintRect, repaintRect);
+            scene->setRenderingContext(UBGraphicsScene::Podcast);
 
-        scene->setRenderingContext(UBGraphicsScene::Screen);
+            scene->render(&p, repaintRect, repaintRect);
 
-        sendLatestPixmapToEncoder();
+            scene->setRenderingContext(UBGraphicsScene::Screen);
+        }
+
+        damage += sceneToVideoTransform.mapRect(repaintRect).toAlignedRect();
+        mFramePool.endFrame(damage);
+
+        sendLatestPixmapToEncoder(damage);
     }
 }
 
@@ -732,15 +748,19 @@ void UBPodcastController::encodingFinished(bool ok)
 
         mVideoEncoder->deleteLater();
 
+        mFramePool.clear();
+        mLatestDesktopGrab = QImage();
+
         setRecordingState(Stopped);
     }
 }
 
 
-void UBPodcastController::sendLatestPixmapToEncoder()
+void UBPodcastController::sendLatestPixmapToEncoder(const QRegion& pDamage)
 {
+    // an empty damage re-sends the latest frame by reference
     if (mVideoEncoder)
-        mVideoEncoder->newPixmap(mLatestCapture, elapsedRecordingMs());
+        mVideoEncoder->newFrame(mFramePool.latestFrame(), pDamage, elapsedRecordingMs());
 }
 
 void UBPodcastController::timerEvent(QTimerEvent *event)
@@ -749,25 +769,44 @@ void UBPodcastController::timerEvent(QTimerEvent *event)
             && event->timerId() == mScreenGrabingTimerEventID
             && mSourceWidget == qApp->desktop())
     {
-        QPixmap desktop = QPixmap::grabWindow(qApp->desktop()->screen(UBApplication::applicationController->displayManager()->controleScreenIndex())->winId());
+        QImage desktop = QPixmap::grabWindow(qApp->desktop()->screen(UBApplication::applicationController->displayManager()->controleScreenIndex())->winId())
+                .toImage().convertToFormat(QImage::Format_RGB32);
+
+        QRegion damage;
+        QRegion changedBlocks;
 
+        if (!mInitialized)
         {
-            QPainter p(&mLatestCapture);
+            mFramePool.fill(QColor(sBackgroundColor));
+            damage = mFramePool.frameRect();
+            changedBlocks = desktop.rect();
+            mInitialized = true;
+        }
+        else
+        {
+            changedBlocks = UBPodcastFramePool::changedBlocks(desktop, mLatestDesktopGrab);
+        }
+
+        mLatestDesktopGrab = desktop;
+
+        if (!changedBlocks.isEmpty())
+        {
+            // only the changed part of the desktop is rescaled, with a margin hiding the filtering seams
+            QRect sourceRect = changedBlocks.boundingRect().adjusted(-4, -4, 4, 4).intersected(desktop.rect());
+            QRect targetRect = mViewToVideoTransform.mapRect(QRectF(sourceRect)).toAlignedRect();
+
+            QImage& frame = mFramePool.beginFrame();
 
-            if (!mInitialized)
             {
-                mLatestCapture.fill(sBackgroundColor);
-                mInitialized = true;
+                QPainter p(&frame);
+                p.drawImage(targetRect.topLeft(), desktop.copy(sourceRect).scaled(targetRect.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
             }
 
-            QRectF targetRect = mViewToVideoTransform.mapRect(QRectF(0, 0, desktop.width(), desktop.height()));
-
-            p.setRenderHints(QPainter::Antialiasing);
-            p.setRenderHints(QPainter::SmoothPixmapTransform);
-            p.drawPixmap(targetRect.left(), targetRect.top(), desktop.scaled(targetRect.width(), targetRect.height(),  Qt::KeepAspectRatio, Qt::SmoothTransformation));
+            damage += targetRect;
+            mFramePool.endFrame(damage);
         }
 
-        sendLatestPixmapToEncoder();
+        sendLatestPixmapToEncoder(damage);
     }
 
     if (mRecordingProgressTimerEventID == event->timerId() && mRecordingState == Recording)
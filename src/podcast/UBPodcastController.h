@@ -19,6 +19,7 @@
 #include <QtGui>
 
 #include "UBAbstractVideoEncoder.h"
+#include "UBPodcastFramePool.h"
 
 #include "core/UBApplicationController.h"
 
@@ -109,7 +110,7 @@ class UBPodcastController : public QObject
 
         void setRecordingState(RecordingState pRecordingState);
 
-        void sendLatestPixmapToEncoder();
+        void sendLatestPixmapToEncoder(const QRegion& pDamage = QRegion());
 
         long elapsedRecordingMs();
 
@@ -126,7 +127,9 @@ class UBPodcastController : public QObject
 
         bool mInitialized;
 
-        QImage mLatestCapture;
+        UBPodcastFramePool mFramePool;
+
+        QImage mLatestDesktopGrab;
 
         int mVideoFramesPerSecondAtStart;
         QSize mVideoFrameSizeAtStart;
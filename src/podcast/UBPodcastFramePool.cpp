@@ -0,0 +1,196 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UBPodcastFramePool.h"
+
+#include "core/memcheck.h"
+
+// above that many rectangles a stale region is collapsed to its bounding rect
+static const int sMaxStaleRects = 16;
+
+
+UBPodcastFramePool::UBPodcastFramePool(int pCapacity)
+    : mCurrent(0)
+    , mFormat(QImage::Format_RGB32)
+    , mAllocationCount(0)
+{
+    mSlots.resize(qMax(2, pCapacity));
+}
+
+
+UBPodcastFramePool::~UBPodcastFramePool()
+{
+    // NOOP
+}
+
+
+void UBPodcastFramePool::reset(const QSize& pSize, QImage::Format pFormat)
+{
+    mFrameSize = pSize;
+    mFormat = pFormat;
+    mCurrent = 0;
+    mAllocationCount = 0;
+
+    for (int i = 0; i < mSlots.size(); i++)
+    {
+        mSlots[i].image = QImage(mFrameSize, mFormat);
+        mSlots[i].staleRegion = (i == mCurrent) ? QRegion() : QRegion(frameRect());
+        mAllocationCount++;
+    }
+}
+
+
+void UBPodcastFramePool::clear()
+{
+    for (int i = 0; i < mSlots.size(); i++)
+    {
+        mSlots[i].image = QImage();
+        mSlots[i].staleRegion = QRegion();
+    }
+
+    mFrameSize = QSize();
+    mCurrent = 0;
+}
+
+
+void UBPodcastFramePool::fill(const QColor& pColor)
+{
+    if (mFrameSize.isEmpty())
+        return;
+
+    QImage& frame = beginFrame();
+    frame.fill(pColor);
+    endFrame(QRegion(frameRect()));
+}
+
+
+QImage& UBPodcastFramePool::beginFrame()
+{
+    mCurrent = acquireSlot();
+
+    return mSlots[mCurrent].image;
+}
+
+
+void UBPodcastFramePool::endFrame(const QRegion& pDamage)
+{
+    QRegion damage = pDamage.intersected(frameRect());
+
+    if (damage.isEmpty())
+        return;
+
+    for (int i = 0; i < mSlots.size(); i++)
+    {
+        if (i == mCurrent)
+            continue;
+
+        QRegion& stale = mSlots[i].staleRegion;
+        stale = stale.united(damage);
+
+        if (stale.rectCount() > sMaxStaleRects)
+            stale = QRegion(stale.boundingRect());
+    }
+}
+
+
+int UBPodcastFramePool::acquireSlot()
+{
+    // nobody else holds the latest frame, paint over it in place
+    if (mSlots.at(mCurrent).image.isDetached())
+        return mCurrent;
+
+    const QImage& latest = mSlots.at(mCurrent).image;
+    const int bytesPerPixel = latest.depth() / 8;
+
+    for (int offset = 1; offset < mSlots.size(); offset++)
+    {
+        int index = (mCurrent + offset) % mSlots.size();
+        Slot& slot = mSlots[index];
+
+        if (slot.image.isNull() || !slot.image.isDetached() || slot.image.size() != mFrameSize)
+            continue;
+
+        foreach(const QRect& rect, slot.staleRegion.rects())
+        {
+            for (int y = rect.top(); y <= rect.bottom(); y++)
+            {
+                memcpy(slot.image.scanLine(y) + rect.left() * bytesPerPixel
+                    , latest.scanLine(y) + rect.left() * bytesPerPixel
+                    , rect.width() * bytesPerPixel);
+            }
+        }
+
+        slot.staleRegion = QRegion();
+
+        return index;
+    }
+
+    // the encoder still holds every buffer, recycle the oldest one with a fresh copy
+    int index = (mCurrent + 1) % mSlots.size();
+    mSlots[index].image = latest.copy();
+    mSlots[index].staleRegion = QRegion();
+    mAllocationCount++;
+
+    return index;
+}
+
+
+QRegion UBPodcastFramePool::changedBlocks(const QImage& pCurrent, const QImage& pPrevious, int pBlockSize)
+{
+    if (pPrevious.isNull()
+            || pCurrent.size() != pPrevious.size()
+            || pCurrent.format() != pPrevious.format()
+            || pCurrent.depth() < 8)
+    {
+        return QRegion(pCurrent.rect());
+    }
+
+    QRegion changed;
+    const int bytesPerPixel = pCurrent.depth() / 8;
+
+    for (int blockTop = 0; blockTop < pCurrent.height(); blockTop += pBlockSize)
+    {
+        int blockHeight = qMin(pBlockSize, pCurrent.height() - blockTop);
+        int spanStart = -1;
+
+        for (int blockLeft = 0; blockLeft < pCurrent.width(); blockLeft += pBlockSize)
+        {
+            int blockBytes = qMin(pBlockSize, pCurrent.width() - blockLeft) * bytesPerPixel;
+            bool blockChanged = false;
+
+            for (int y = blockTop; y < blockTop + blockHeight && !blockChanged; y++)
+            {
+                blockChanged = memcmp(pCurrent.scanLine(y) + blockLeft * bytesPerPixel
+                    , pPrevious.scanLine(y) + blockLeft * bytesPerPixel, blockBytes) != 0;
+            }
+
+            // merge horizontally adjacent changed blocks into a single span
+            if (blockChanged && spanStart < 0)
+            {
+                spanStart = blockLeft;
+            }
+            else if (!blockChanged && spanStart >= 0)
+            {
+                changed += QRect(spanStart, blockTop, blockLeft - spanStart, blockHeight);
+                spanStart = -1;
+            }
+        }
+
+        if (spanStart >= 0)
+            changed += QRect(spanStart, blockTop, pCurrent.width() - spanStart, blockHeight);
+    }
+
+    return changed;
+}
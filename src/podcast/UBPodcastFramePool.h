@@ -0,0 +1,92 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UBPODCASTFRAMEPOOL_H_
+#define UBPODCASTFRAMEPOOL_H_
+
+#include <QtGui>
+
+/*
+ * Fixed set of frame buffers the podcast capture paints into.
+ *
+ * Encoders may keep a (implicitly shared) reference on the frames they receive,
+ * so painting over the last sent frame would detach and allocate a new image on
+ * every tick. The pool instead hands out a buffer the encoder no longer holds and
+ * brings it up to date by copying only the regions damaged since that buffer was
+ * last used.
+ */
+class UBPodcastFramePool
+{
+    public:
+
+        UBPodcastFramePool(int pCapacity = 3);
+        virtual ~UBPodcastFramePool();
+
+        void reset(const QSize& pSize, QImage::Format pFormat);
+
+        void clear();
+
+        void fill(const QColor& pColor);
+
+        // returns a buffer holding the latest frame, ready to be painted on
+        QImage& beginFrame();
+
+        // publishes the buffer returned by beginFrame, pDamage is in frame coordinates
+        void endFrame(const QRegion& pDamage);
+
+        const QImage& latestFrame() const
+        {
+            return mSlots.at(mCurrent).image;
+        }
+
+        QRect frameRect() const
+        {
+            return QRect(QPoint(0, 0), mFrameSize);
+        }
+
+        int capacity() const
+        {
+            return mSlots.size();
+        }
+
+        // number of buffers allocated since the last reset, stays at capacity() while the encoder keeps up
+        int allocationCount() const
+        {
+            return mAllocationCount;
+        }
+
+        static QRegion changedBlocks(const QImage& pCurrent, const QImage& pPrevious, int pBlockSize = 32);
+
+    private:
+
+        struct Slot
+        {
+            QImage image;
+            QRegion staleRegion;
+        };
+
+        int acquireSlot();
+
+        QVector<Slot> mSlots;
+
+        int mCurrent;
+
+        QSize mFrameSize;
+        QImage::Format mFormat;
+
+        int mAllocationCount;
+};
+
+#endif /* UBPODCASTFRAMEPOOL_H_ */
@@ -1,12 +1,14 @@
 
 HEADERS      += src/podcast/UBPodcastController.h \
                 src/podcast/UBAbstractVideoEncoder.h \
+                src/podcast/UBPodcastFramePool.h \
                 src/podcast/UBPodcastRecordingPalette.h \
                 src/podcast/youtube/UBYouTubePublisher.h \
                 src/podcast/intranet/UBIntranetPodcastPublisher.h
                 
 SOURCES      += src/podcast/UBPodcastController.cpp \
                 src/podcast/UBAbstractVideoEncoder.cpp \
+                src/podcast/UBPodcastFramePool.cpp \
                 src/podcast/UBPodcastRecordingPalette.cpp \
                 src/podcast/youtube/UBYouTubePublisher.cpp \
                 src/podcast/intranet/UBIntranetPodcastPublisher.cpp
@@ -125,6 +125,32 @@ void UBAbstractDrawRuler::EndLine()
 {}
 
 
+void UBAbstractDrawRuler::paintStaticPartsCached(QPainter *painter, const QString& pGeometryKey)
+{
+    QString key = pGeometryKey + QString(" %1").arg(drawColor().rgba());
+
+    if (key != mStaticPartsKey)
+    {
+        mStaticParts = QPicture();
+
+        // the picture starts from the state the tool set up before calling
+        QPainter recorder(&mStaticParts);
+        recorder.setRenderHints(painter->renderHints());
+        recorder.setPen(painter->pen());
+        recorder.setBrush(painter->brush());
+        recorder.setFont(painter->font());
+
+        paintStaticParts(&recorder);
+
+        recorder.end();
+
+        mStaticPartsKey = key;
+    }
+
+    painter->drawPicture(0, 0, mStaticParts);
+}
+
+
 void UBAbstractDrawRuler::paint()
 {
     mAntiScaleRatio = 1 / (UBApplication::boardController->systemScaleFactor() * UBApplication::boardController->currentZoom());
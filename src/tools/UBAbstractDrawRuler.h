@@ -40,6 +40,14 @@ protected:
 
     void paint();
 
+    /*
+     * The body and graduations of a tool do not change while it is moved or rotated. They are
+     * recorded once by paintStaticParts and replayed, until the key describing their geometry
+     * or the background color changes.
+     */
+    void paintStaticPartsCached(QPainter *painter, const QString& pGeometryKey);
+    virtual void paintStaticParts(QPainter *painter) = 0;
+
     virtual UBGraphicsScene* scene() const = 0;
 
     virtual void rotateAroundCenter(qreal angle) = 0;
@@ -77,6 +85,11 @@ protected:
     static const int sDrawTransparency;
     static const int sRoundingRadius;
     int sPixelsPerMillimeter;
+
+private:
+
+    QPicture mStaticParts;
+    QString mStaticPartsKey;
 };
 
 #endif
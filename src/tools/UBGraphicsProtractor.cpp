@@ -37,6 +37,7 @@ UBGraphicsProtractor::UBGraphicsProtractor()
         , mResetSvgItem(0)
         , mResizeSvgItem(0)
         , mMarkerSvgItem(0)
+        , mFont("Arial")
 {
     sFillTransparency = 127;
     sDrawTransparency = 192;
@@ -77,11 +78,22 @@ void UBGraphicsProtractor::paint(QPainter *painter, const QStyleOptionGraphicsIt
     Q_UNUSED(styleOption);
     Q_UNUSED(widget);
 
-    painter->setFont(QFont("Arial"));
+    painter->setFont(mFont);
     painter->setPen(drawColor());
-    painter->setBrush(fillBrush());
-    painter->drawPie(QRectF(rect().center().x() - radius(), rect().center().y() - radius(), 2 * radius(), 2 * radius()), mStartAngle * 16, mSpan * 16);
-    paintGraduations(painter);
+
+    // recorded unrotated, rotating the protractor only changes how the picture is replayed
+    QRectF r = rect();
+    QPointF center = r.center();
+
+    painter->save();
+    painter->translate(center);
+    painter->rotate(-mStartAngle);
+    painter->translate(-center);
+
+    paintStaticPartsCached(painter, QString("%1 %2 %3 %4").arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height()));
+
+    painter->restore();
+
     paintButtons(painter);
     paintAngleMarker(painter);
 
@@ -181,9 +193,7 @@ void UBGraphicsProtractor::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
     switch (mCurrentTool)
     {
     case Rotate :
-        prepareGeometryChange();
-        mStartAngle = mStartAngle + angle;
-        setStartAngle(mStartAngle * 16);
+        setAngle(mStartAngle + angle);
         mPreviousMousePos = currentPoint;
         break;
 
@@ -358,6 +368,14 @@ QRectF UBGraphicsProtractor::resizeButtonRect () const
 }
 
 
+void UBGraphicsProtractor::paintStaticParts(QPainter *painter)
+{
+    painter->setBrush(fillBrush());
+    painter->drawPie(QRectF(rect().center().x() - radius(), rect().center().y() - radius(), 2 * radius(), 2 * radius()), 0, mSpan * 16);
+    paintGraduations(painter);
+}
+
+
 void UBGraphicsProtractor::paintGraduations(QPainter *painter)
 {
     painter->save();
@@ -380,13 +398,13 @@ void UBGraphicsProtractor::paintGraduations(QPainter *painter)
     qreal rad = radius();
 
     QPointF center = rect().center();
-    painter->drawArc(QRectF(center.x() - rad/2, center.y() - rad/2, rad, rad), mStartAngle*16, mSpan*16);
+    painter->drawArc(QRectF(center.x() - rad/2, center.y() - rad/2, rad, rad), 0, mSpan*16);
 
     for (int angle = 1; angle < mSpan; angle++)
     {
         int graduationLength = (0 == angle % 10) ? tenDegreeGraduationLength : ((0 == angle % 5) ? fiveDegreeGraduationLength : oneDegreeGraduationLength);
-        qreal co = cos(((qreal)angle + mStartAngle) * PI/180);
-        qreal si = sin(((qreal)angle + mStartAngle) * PI/180);
+        qreal co = cos((qreal)angle * PI/180);
+        qreal si = sin((qreal)angle * PI/180);
         if (0 == angle % 90)
             painter->drawLine(QLineF(QPointF(center.x(), center.y()), QPointF(center.x() + co*tenDegreeGraduationLength, center.y() - si*tenDegreeGraduationLength)));
 
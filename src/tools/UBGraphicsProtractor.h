@@ -36,7 +36,7 @@ class UBGraphicsProtractor : public UBAbstractDrawRuler, public QGraphicsEllipse
 
         qreal angle () { return mStartAngle; }
         qreal markerAngle () { return mCurrentAngle; }
-        void  setAngle (qreal angle) { mStartAngle = angle; setStartAngle(mStartAngle * 16); }
+        void  setAngle (qreal angle) { prepareGeometryChange(); mStartAngle = angle; setStartAngle(mStartAngle * 16); }
         void  setMarkerAngle (qreal angle) { mCurrentAngle = angle; }
 
         virtual UBItem* deepCopy() const;
@@ -66,6 +66,7 @@ class UBGraphicsProtractor : public UBAbstractDrawRuler, public QGraphicsEllipse
     private:
         // Helpers
         void paintGraduations (QPainter *painter);
+        virtual void paintStaticParts (QPainter *painter);
         void paintButtons (QPainter *painter);
         void paintAngleMarker (QPainter *painter);
         Tool toolFromPos (QPointF pos);
@@ -91,6 +92,8 @@ class UBGraphicsProtractor : public UBAbstractDrawRuler, public QGraphicsEllipse
         qreal   mStartAngle;
         qreal   mScaleFactor;
 
+        QFont   mFont;
+
         QGraphicsSvgItem* mResetSvgItem;
         QGraphicsSvgItem* mResizeSvgItem;
         QGraphicsSvgItem* mMarkerSvgItem;
@@ -114,11 +114,20 @@ void UBGraphicsRuler::paint(QPainter *painter, const QStyleOptionGraphicsItem *s
 
     painter->setPen(drawColor());
     painter->setRenderHint(QPainter::Antialiasing, true);
+
+    QRectF r = rect();
+    paintStaticPartsCached(painter, QString("%1 %2 %3 %4").arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height()));
+
+    if (mRotating)
+        paintRotationCenter(painter);
+}
+
+
+void UBGraphicsRuler::paintStaticParts(QPainter *painter)
+{
     painter->drawRoundedRect(rect(), sRoundingRadius, sRoundingRadius);
     fillBackground(painter);
     paintGraduations(painter);
-    if (mRotating)
-        paintRotationCenter(painter);
 }
 
 
@@ -220,9 +229,9 @@ QPointF UBGraphicsRuler::rotationCenter() const
 
 QRectF UBGraphicsRuler::resizeButtonRect() const
 {
-    QPixmap resizePixmap(":/images/resizeRuler.svg");
+    // the svg default size, without rendering it on every call
     QSizeF resizeRectSize(
-        resizePixmap.rect().width(),
+        mResizeSvgItem->boundingRect().width(),
         rect().height());
 
     qreal ratio = mAntiScaleRatio > 1.0 ? mAntiScaleRatio : 1.0;
@@ -236,11 +245,11 @@ QRectF UBGraphicsRuler::resizeButtonRect() const
 
 QRectF UBGraphicsRuler::closeButtonRect() const
 {
-    QPixmap closePixmap(":/images/closeTool.svg");
+    QRectF closeSvgRect = mCloseSvgItem->boundingRect();
 
     QSizeF closeRectSize(
-        closePixmap.width() * mAntiScaleRatio,
-        closePixmap.height() * mAntiScaleRatio);
+        closeSvgRect.width() * mAntiScaleRatio,
+        closeSvgRect.height() * mAntiScaleRatio);
 
     QPointF closeRectCenter(
         rect().left() + sLeftEdgeMargin + sPixelsPerMillimeter * 5,
@@ -255,11 +264,11 @@ QRectF UBGraphicsRuler::closeButtonRect() const
 
 QRectF UBGraphicsRuler::rotateButtonRect() const
 {
-    QPixmap rotatePixmap(":/images/closeTool.svg");
+    QRectF rotateSvgRect = mCloseSvgItem->boundingRect();
 
     QSizeF rotateRectSize(
-        rotatePixmap.width() * mAntiScaleRatio,
-        rotatePixmap.height() * mAntiScaleRatio);
+        rotateSvgRect.width() * mAntiScaleRatio,
+        rotateSvgRect.height() * mAntiScaleRatio);
 
     int centimeters = (int)(rect().width() - sLeftEdgeMargin - resizeButtonRect().width()) / (int)(10 * sPixelsPerMillimeter);
     QPointF rotateRectCenter(
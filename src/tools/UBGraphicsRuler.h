@@ -69,6 +69,7 @@ class UBGraphicsRuler : public UBAbstractDrawRuler, public QGraphicsRectItem, pu
         // Helpers
         void    fillBackground(QPainter *painter);
         void    paintGraduations(QPainter *painter);
+        virtual void paintStaticParts(QPainter *painter);
         void    paintRotationCenter(QPainter *painter);
         virtual void    rotateAroundCenter(qreal angle);
 
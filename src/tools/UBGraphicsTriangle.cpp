@@ -213,7 +213,36 @@ void UBGraphicsTriangle::calculatePoints(const QRectF& r)
 
 void UBGraphicsTriangle::paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *)
 {
+    QRectF r = rect();
+    paintStaticPartsCached(painter, QString("%1 %2 %3 %4 %5").arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height()).arg(mOrientation));
 
+    mAntiScaleRatio = 1 / (UBApplication::boardController->systemScaleFactor() * UBApplication::boardController->currentZoom());
+    QTransform antiScaleTransform;
+    antiScaleTransform.scale(mAntiScaleRatio, mAntiScaleRatio);
+
+    mCloseSvgItem->setTransform(antiScaleTransform);
+    mHFlipSvgItem->setTransform(antiScaleTransform);
+    mVFlipSvgItem->setTransform(antiScaleTransform);
+    mRotateSvgItem->setTransform(antiScaleTransform);
+
+    mCloseSvgItem->setPos(closeButtonRect().topLeft());
+    mHFlipSvgItem->setPos(hFlipRect().topLeft());
+    mVFlipSvgItem->setPos(vFlipRect().topLeft());
+    mRotateSvgItem->setPos(rotateRect().topLeft());
+
+    if (mShowButtons || mResizing1 || mResizing2)
+    {
+        painter->setPen(drawColor());
+        painter->setBrush(QColor(0, 0, 0));
+        if (mShowButtons || mResizing1)
+            painter->drawPolygon(resize1Polygon());
+        if (mShowButtons || mResizing2)
+            painter->drawPolygon(resize2Polygon());
+    }
+}
+
+void UBGraphicsTriangle::paintStaticParts(QPainter *painter)
+{
     painter->setPen(Qt::NoPen);
 
     QPolygonF polygon;
@@ -254,29 +283,6 @@ void UBGraphicsTriangle::paint(QPainter *painter, const QStyleOptionGraphicsItem
     painter->drawPolygon(polygon);
 
     paintGraduations(painter);
-
-    mAntiScaleRatio = 1 / (UBApplication::boardController->systemScaleFactor() * UBApplication::boardController->currentZoom());
-    QTransform antiScaleTransform;
-    antiScaleTransform.scale(mAntiScaleRatio, mAntiScaleRatio);
-
-    mCloseSvgItem->setTransform(antiScaleTransform);
-    mHFlipSvgItem->setTransform(antiScaleTransform);
-    mVFlipSvgItem->setTransform(antiScaleTransform);
-    mRotateSvgItem->setTransform(antiScaleTransform);
-
-    mCloseSvgItem->setPos(closeButtonRect().topLeft());
-    mHFlipSvgItem->setPos(hFlipRect().topLeft());
-    mVFlipSvgItem->setPos(vFlipRect().topLeft());
-    mRotateSvgItem->setPos(rotateRect().topLeft());
-
-    if (mShowButtons || mResizing1 || mResizing2)
-    {
-        painter->setBrush(QColor(0, 0, 0));
-        if (mShowButtons || mResizing1)
-            painter->drawPolygon(resize1Polygon());
-        if (mShowButtons || mResizing2)
-            painter->drawPolygon(resize2Polygon());
-    }
 }
 
 QPainterPath UBGraphicsTriangle::shape() const
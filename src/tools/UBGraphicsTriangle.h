@@ -144,6 +144,7 @@ class UBGraphicsTriangle : public UBAbstractDrawRuler, public QGraphicsPolygonIt
         static const UBGraphicsTriangleOrientation sDefaultOrientation;
 
         void paintGraduations(QPainter *painter);
+        virtual void paintStaticParts(QPainter *painter);
 
 
         UBGraphicsTriangleOrientation mOrientation;
@@ -19,11 +19,232 @@
 
 void usage(QString progName)
 {
-    qDebug() << "usage:" << progName << "pdfFile pageNumber width height outputDir [imageFormat=png]";
+    qDebug() << "usage:" << progName << "pdfFile pages WIDTHxHEIGHT[,WIDTHxHEIGHT...] outputDir [imageFormat=png] [-processes N]";
+    qDebug() << "   or:" << progName << "pdfFile pageNumber width height outputDir [imageFormat=png]";
     qDebug() << "pdfFile is the path to the pdf file";
+    qDebug() << "pages is a list of page ranges starting at 1, like 1-10,15,20- or all";
+    qDebug() << "every page is rendered once per size, the size is added to the file names when there are several";
+    qDebug() << "-processes splits the pages in ranges rendered by as many worker processes, it defaults to the number of cores";
     qDebug() << "imageFormat must be one of " << QImageWriter::supportedImageFormats();
 }
 
+
+struct PageJob
+{
+    int pageNumber;
+    qint64 nanoseconds; // all sizes of the page
+    bool ok;
+};
+
+
+/*
+ * Parses "1-10,15,20-" or "all" into page numbers, returns an empty list when malformed
+ * or out of the document. A page listed several times is only rendered once, where it first
+ * appears, two workers would otherwise write the same files.
+ */
+static QList<int> parsePages(const QString& pSpec, int pPageCount)
+{
+    QList<int> pages;
+    QSet<int> listedPages;
+
+    if (pSpec == "all") {
+        for (int page = 1; page <= pPageCount; page++)
+            pages << page;
+        return pages;
+    }
+
+    foreach (QString range, pSpec.split(",", QString::SkipEmptyParts)) {
+        QStringList bounds = range.split("-");
+        bool firstOk = true;
+        bool lastOk = true;
+
+        int first = bounds.at(0).isEmpty() ? 1 : bounds.at(0).toInt(&firstOk);
+        int last = first;
+
+        if (bounds.count() == 2)
+            last = bounds.at(1).isEmpty() ? pPageCount : bounds.at(1).toInt(&lastOk);
+
+        if (bounds.count() > 2 || !firstOk || !lastOk || first < 1 || last > pPageCount || first > last)
+            return QList<int>();
+
+        for (int page = first; page <= last; page++) {
+            if (!listedPages.contains(page)) {
+                listedPages.insert(page);
+                pages << page;
+            }
+        }
+    }
+
+    return pages;
+}
+
+
+static QList<QSize> parseSizes(const QString& pSpec)
+{
+    QList<QSize> sizes;
+
+    foreach (QString size, pSpec.split(",", QString::SkipEmptyParts)) {
+        QStringList dimensions = size.split("x");
+
+        if (dimensions.count() != 2 || dimensions.at(0).toInt() <= 0 || dimensions.at(1).toInt() <= 0)
+            return QList<QSize>();
+
+        sizes << QSize(dimensions.at(0).toInt(), dimensions.at(1).toInt());
+    }
+
+    return sizes;
+}
+
+
+static bool renderPage(XPDFRenderer& pdf, int pageNumber, const QSize& size, const QString& outputPath, const QString& imageFormat)
+{
+    qreal width = size.width();
+    qreal height = size.height();
+
+    QImage image(size, QImage::Format_ARGB32);
+
+    QPainter p(&image);
+
+    p.setBackground(Qt::transparent);
+    p.eraseRect(0, 0, width, height);
+
+    qreal pdfWidth = pdf.pageSizeF(pageNumber).width();
+    qreal pdfHeight = pdf.pageSizeF(pageNumber).height();
+    qreal ratio = qMin(width / pdfWidth, height / pdfHeight);
+    p.scale(ratio, ratio);
+    if (width > pdfWidth) {
+        p.translate((pdfWidth - (width / ratio)) / -2, 0);
+    }
+    if (height > pdfHeight) {
+        p.translate(0, (pdfHeight - (height / ratio)) / -2);
+    }
+    pdf.render(&p, pageNumber);
+
+    p.end();
+
+    return image.save(outputPath, imageFormat.toAscii().constData());
+}
+
+
+// the reverse of parsePages, consecutive pages are written as a range
+static QString pagesSpec(const QList<int>& pPages)
+{
+    QStringList ranges;
+
+    for (int i = 0; i < pPages.count(); i++) {
+        int first = pPages.at(i);
+
+        while (i + 1 < pPages.count() && pPages.at(i + 1) == pPages.at(i) + 1)
+            i++;
+
+        if (pPages.at(i) == first)
+            ranges << QString::number(first);
+        else
+            ranges << QString("%1-%2").arg(first).arg(pPages.at(i));
+    }
+
+    return ranges.join(",");
+}
+
+
+static QString sizesSpec(const QList<QSize>& pSizes)
+{
+    QStringList sizes;
+
+    foreach (QSize size, pSizes)
+        sizes << QString("%1x%2").arg(size.width()).arg(size.height());
+
+    return sizes.join(",");
+}
+
+
+/*
+ * Renders the pages one after the other with the same renderer, so the document xref and
+ * fonts are parsed once rather than once per page.
+ */
+static void renderPages(XPDFRenderer& pdf, const QString& pdfFile, QVector<PageJob>& jobs, const QList<QSize>& sizes,
+        const QString& outputDir, const QString& imageFormat)
+{
+    QString fileName = QFileInfo(pdfFile).completeBaseName();
+
+    for (int job = 0; job < jobs.size(); job++) {
+        PageJob& page = jobs[job];
+
+        QElapsedTimer timer;
+        timer.start();
+
+        page.ok = true;
+
+        QString pageStr = QString("%1").arg(page.pageNumber, 5, 10, QChar('0'));
+
+        foreach (QSize size, sizes) {
+            if (!page.ok)
+                break;
+
+            // a single size keeps the names the one page invocation always produced
+            QString sizeStr = sizes.count() > 1 ? QString("_%1x%2").arg(size.width()).arg(size.height()) : QString();
+            QString outputPath = outputDir + "/" + fileName + pageStr + sizeStr + "." + imageFormat;
+
+            page.ok = renderPage(pdf, page.pageNumber, size, outputPath, imageFormat);
+        }
+
+        page.nanoseconds = timer.nsecsElapsed();
+    }
+}
+
+
+/*
+ * Splits the pages in as many consecutive ranges as there are processes and renders each
+ * range in a worker process, which needs no thread safety from xpdf. The workers report
+ * "page nanoseconds ok" lines once all their pages are rendered, a page a worker did not
+ * report stays failed.
+ */
+static void renderInProcesses(const QString& pdfFile, QVector<PageJob>& jobs, const QList<QSize>& sizes,
+        const QString& outputDir, const QString& imageFormat, int processCount)
+{
+    QList<QProcess*> processes;
+
+    for (int i = 0; i < processCount; i++) {
+        QList<int> range;
+        for (int job = jobs.count() * i / processCount; job < jobs.count() * (i + 1) / processCount; job++)
+            range << jobs.at(job).pageNumber;
+
+        QStringList arguments;
+        arguments << pdfFile << pagesSpec(range) << sizesSpec(sizes) << outputDir << imageFormat << "-worker";
+
+        QProcess* process = new QProcess();
+        process->start(QCoreApplication::applicationFilePath(), arguments);
+        processes << process;
+    }
+
+    QHash<int, int> jobByPage;
+    for (int job = 0; job < jobs.count(); job++)
+        jobByPage.insert(jobs.at(job).pageNumber, job);
+
+    // a worker done early waits on its full output pipe until it is read, it has nothing left to render then
+    foreach (QProcess* process, processes) {
+        if (!process->waitForFinished(-1))
+            qWarning() << "worker process failed:" << process->errorString();
+
+        QTextStream(stderr) << process->readAllStandardError();
+
+        QTextStream results(process->readAllStandardOutput());
+        while (!results.atEnd()) {
+            QStringList fields = results.readLine().split(" ");
+
+            if (fields.count() != 3 || !jobByPage.contains(fields.at(0).toInt()))
+                continue;
+
+            PageJob& page = jobs[jobByPage.value(fields.at(0).toInt())];
+            page.nanoseconds = fields.at(1).toLongLong();
+            page.ok = fields.at(2) == "1";
+        }
+
+        delete process;
+    }
+}
+
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
@@ -32,21 +253,49 @@ int main(int argc, char *argv[])
 
     QStringList args = app.arguments();
 
-    qreal width, height;
+    int processCount = QThread::idealThreadCount();
+
+    int processesIndex = args.indexOf("-processes");
+    if (processesIndex > 0) {
+        processCount = args.value(processesIndex + 1).toInt();
+        args.removeAt(processesIndex + 1);
+        args.removeAt(processesIndex);
+    }
+
+    // started by renderInProcesses for one page range
+    bool isWorker = args.removeAll("-worker") > 0;
+
     QString pdfFile;
+    QString pagesArgument;
+    QList<QSize> sizes;
     QString imageFormat = "png";
     QString outputDir = ".";
-    int pageNumber = 1;
     qDebug() << UBPlatformUtils::applicationResourcesDirectory();
+
+    bool widthOk = false;
+    bool heightOk = false;
     if (args.count() >= 6 && args.count() <= 7) {
+        args.at(3).toDouble(&widthOk);
+        args.at(4).toDouble(&heightOk);
+    }
+
+    if (widthOk && heightOk) {
+        // single page form: pdfFile pageNumber width height outputDir [imageFormat]
         pdfFile    = args.at(1);
-        pageNumber = args.at(2).toInt();
-        width      = args.at(3).toDouble();
-        height     = args.at(4).toDouble();
+        pagesArgument = args.at(2);
+        sizes << QSize(args.at(3).toDouble(), args.at(4).toDouble());
         outputDir  = args.at(5);
         if (args.count() == 7) {
             imageFormat = args.at(6);
         }
+    } else if (args.count() >= 5 && args.count() <= 6) {
+        pdfFile    = args.at(1);
+        pagesArgument = args.at(2);
+        sizes      = parseSizes(args.at(3));
+        outputDir  = args.at(4);
+        if (args.count() == 6) {
+            imageFormat = args.at(5);
+        }
     } else {
         usage(args.at(0));
         return 1;
@@ -54,7 +303,7 @@ int main(int argc, char *argv[])
 
     QString fileName = QFileInfo(pdfFile).completeBaseName();
 
-    if (!QImageWriter::supportedImageFormats().contains(imageFormat.toAscii())) {
+    if (!QImageWriter::supportedImageFormats().contains(imageFormat.toAscii()) || sizes.isEmpty() || processCount < 1) {
         usage(args.at(0));
         return 1;
     }
@@ -66,35 +315,64 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    if (pageNumber < 1 || pageNumber > pdf.pageCount()) {
-        qCritical() << fileName << "has" << pdf.pageCount() << "pages";
+    QList<int> pages = parsePages(pagesArgument, pdf.pageCount());
+
+    if (pages.isEmpty()) {
+        qCritical() << fileName << "has" << pdf.pageCount() << "pages, cannot render" << pagesArgument;
         return 1;
     }
 
-	//qDebug() << "Converting" << pdfFile << "(" << pageNumber << ") into" << imageFormat;
+    QVector<PageJob> jobs(pages.count());
+    for (int i = 0; i < pages.count(); i++) {
+        jobs[i].pageNumber = pages.at(i);
+        jobs[i].nanoseconds = 0;
+        jobs[i].ok = false;
+    }
 
-    QImage image(width, height, QImage::Format_ARGB32);
+    processCount = qMin(processCount, jobs.count());
 
-    QPainter p(&image);
+    QElapsedTimer timer;
+    timer.start();
 
-    p.setBackground(Qt::transparent);
-    p.eraseRect(0, 0, width, height);
+    if (isWorker || processCount == 1)
+        renderPages(pdf, pdfFile, jobs, sizes, outputDir, imageFormat);
+    else
+        renderInProcesses(pdfFile, jobs, sizes, outputDir, imageFormat, processCount);
 
-    qreal pdfWidth = pdf.pageSize(pageNumber).width();
-    qreal pdfHeight = pdf.pageSize(pageNumber).height();
-    qreal ratio = qMin(width / pdfWidth, height / pdfHeight);
-    p.scale(ratio, ratio);
-    if (width > pdfWidth) {
-        p.translate((pdfWidth - (width / ratio)) / -2, 0);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    QTextStream out(stdout);
+
+    if (isWorker) {
+        foreach (PageJob job, jobs)
+            out << job.pageNumber << " " << job.nanoseconds << " " << (job.ok ? 1 : 0) << "\n";
+
+        return 0;
     }
-    if (height > pdfHeight) {
-        p.translate(0, (pdfHeight - (height / ratio)) / -2);
+
+    // timing summary, also what the pdf rendering is benchmarked with
+    QList<qint64> pageTimes;
+    int failed = 0;
+
+    foreach (PageJob job, jobs) {
+        out << "page " << job.pageNumber << ": " << QString::number(job.nanoseconds / 1000000.0, 'f', 1) << " ms"
+            << (job.ok ? "" : " FAILED") << "\n";
+        pageTimes << job.nanoseconds;
+        if (!job.ok)
+            failed++;
     }
-    pdf.render(&p, pageNumber);
 
-    QString pageStr = QString("%1").arg(pageNumber, 5, 10, QChar('0'));
-    QString outputPath = outputDir + "/" + fileName + pageStr + "." + imageFormat;
-    bool ok = image.save(outputPath, imageFormat.toAscii().constData());
+    qSort(pageTimes);
+
+    out << "pages: " << jobs.count() << ", sizes: " << sizes.count() << ", processes: " << processCount << "\n";
+    out << "total: " << QString::number(elapsed / 1000000.0, 'f', 1) << " ms, "
+        << QString::number(jobs.count() * 1000000000.0 / qMax(Q_INT64_C(1), elapsed), 'f', 2) << " pages/s\n";
+    out << "per page: min " << QString::number(pageTimes.first() / 1000000.0, 'f', 1)
+        << " ms, median " << QString::number(pageTimes.at(pageTimes.count() / 2) / 1000000.0, 'f', 1)
+        << " ms, max " << QString::number(pageTimes.last() / 1000000.0, 'f', 1) << " ms\n";
+
+    if (failed > 0)
+        out << "failed: " << failed << "\n";
 
-    return ok ? 0 : 1;
+    return failed == 0 ? 0 : 1;
 }